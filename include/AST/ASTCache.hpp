@@ -0,0 +1,34 @@
+#pragma once
+
+#include "AST/ASTNode.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Directory of binary AST images, one per source, named after a hash of the
+// content of the source. An unchanged source is not lexed nor parsed again,
+// its AST is rebuilt from the mapped image. See ASTCache.cpp for the format.
+class ASTCache {
+private:
+    std::string m_Directory;
+
+    [[nodiscard]] std::string getPath(uint64_t key) const;
+
+public:
+    explicit ASTCache(std::string directory);
+
+    // FNV-1a, stable across runs and machines, unlike std::hash.
+    [[nodiscard]] static uint64_t hashSource(std::string_view source);
+
+    [[nodiscard]] static std::string serialize(const ASTProgramNode &program, uint64_t key);
+    // Null if `image` is not the image of the source hashed to `key`, or was
+    // written by another version of the format.
+    [[nodiscard]] static std::unique_ptr<ASTProgramNode> deserialize(std::string_view image, uint64_t key);
+
+    // Null on a cache miss.
+    [[nodiscard]] std::unique_ptr<ASTProgramNode> load(uint64_t key) const;
+    // Returns false if the image cannot be written, which is not an error:
+    // the source is parsed again next time.
+    bool store(uint64_t key, const ASTProgramNode &program) const;
+};
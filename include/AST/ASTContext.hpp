@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Fixed size array allocated in an ASTContext, used for the children of a
+// node. It is a read-only view, copying it does not copy the elements.
+template<typename T>
+class ASTList {
+private:
+    T *m_Data = nullptr;
+    uint32_t m_Size = 0;
+public:
+    using iterator = const T *;
+    using const_iterator = const T *;
+
+    ASTList() = default;
+    ASTList(T *data, uint32_t size)
+        : m_Data(data), m_Size(size)
+    {}
+
+    [[nodiscard]] const T *begin() const { return m_Data; }
+    [[nodiscard]] const T *end() const { return m_Data + m_Size; }
+    [[nodiscard]] const T *cbegin() const { return m_Data; }
+    [[nodiscard]] const T *cend() const { return m_Data + m_Size; }
+    [[nodiscard]] size_t size() const { return m_Size; }
+    [[nodiscard]] bool empty() const { return m_Size == 0; }
+    [[nodiscard]] const T &operator[](size_t index) const { return m_Data[index]; }
+};
+
+// Owns the memory of a whole AST. Nodes and their child lists are bump
+// allocated from large slabs, so a tree is mostly contiguous in the order it
+// was parsed, and it is released in one shot with the context.
+// Destructors are never run: nodes must not own anything, their children are
+// plain pointers and lists in the same context and names are interned Symbols.
+class ASTContext {
+private:
+    static constexpr size_t s_SlabSize = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> m_Slabs;
+    // Allocations too large for a slab, each in its own block.
+    std::vector<std::unique_ptr<char[]>> m_LargeBlocks;
+    char *m_Current = nullptr;
+    char *m_End = nullptr;
+    size_t m_BytesAllocated = 0;
+
+    void *allocateSlow(size_t size, size_t alignment);
+
+public:
+    ASTContext() = default;
+    ASTContext(const ASTContext &) = delete;
+    ASTContext &operator=(const ASTContext &) = delete;
+    // Objects keep their address, a moved-from context must not be used.
+    ASTContext(ASTContext &&) = default;
+
+    void *allocate(size_t size, size_t alignment) {
+        auto current = reinterpret_cast<uintptr_t>(m_Current);
+        uintptr_t aligned = (current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        if (m_Current != nullptr && aligned + size <= reinterpret_cast<uintptr_t>(m_End)) {
+            m_Current = reinterpret_cast<char *>(aligned + size);
+            m_BytesAllocated += size;
+            return reinterpret_cast<void *>(aligned);
+        }
+        return allocateSlow(size, alignment);
+    }
+
+    template<typename T, typename... Args>
+    T *create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "destructors of arena objects are never run");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    ASTList<T> createList(const std::vector<T> &values) {
+        static_assert(std::is_trivially_copyable_v<T>, "lists hold pointers or Symbols");
+        if (values.empty()) {
+            return {};
+        }
+        auto *data = static_cast<T *>(allocate(sizeof(T) * values.size(), alignof(T)));
+        std::copy(values.begin(), values.end(), data);
+        return {data, (uint32_t)values.size()};
+    }
+
+    // Releases everything allocated so far, only the first slab is kept to
+    // be reused. Nothing that was created in the context can be used after.
+    void reset();
+
+    [[nodiscard]] size_t getBytesAllocated() const { return m_BytesAllocated; }
+};
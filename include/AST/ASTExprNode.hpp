@@ -1,12 +1,13 @@
 #pragma once
 
+#include "AST/ASTContext.hpp"
 #include "AST/ASTNode.hpp"
-#include <memory>
+#include "Support/StringInterner.hpp"
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
-#include <vector>
-
-class Parser;
 
 enum class RangeOperator {
     ft,
@@ -28,117 +29,193 @@ enum class Operator {
     eqcomp,
     leq,
     meq,
-    neq
+    neq,
+    // Short-circuit: the right operand is only evaluated when the left one
+    // does not decide the result.
+    andandsym,
+    ororsym
 };
 
-class ASTExprNode : public ASTNode
-{};
+class ASTExprNode : public ASTNode {
+private:
+    TYPE m_ExprType = NONE;
+    TYPE m_ConvertedType = NONE;
+public:
+    using ASTNode::ASTNode;
+
+    static bool classof(const ASTNode *node) {
+        return node->getKind() >= Kind::Binary && node->getKind() <= Kind::ArrayAccess;
+    }
+
+    // Set by ASTTypeChecker, NONE before. The value of the expression has
+    // the first type and is implicitly converted to the second one where it
+    // is used, e.g. the int operand of an addition with a long.
+    [[nodiscard]] TYPE getExprType() const { return m_ExprType; }
+    [[nodiscard]] TYPE getConvertedType() const { return m_ConvertedType; }
+    void setType(TYPE type, TYPE convertedType) {
+        m_ExprType = type;
+        m_ConvertedType = convertedType;
+    }
+};
 
 template<typename T>
 class ASTLiteralNode: public ASTExprNode {
 private:
     T m_Value;
+
+    static constexpr Kind getLiteralKind() {
+        if constexpr (std::is_same_v<T, int>) {
+            return Kind::LiteralInt;
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            return Kind::LiteralLong;
+        } else if constexpr (std::is_same_v<T, double>) {
+            return Kind::LiteralDouble;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return Kind::LiteralBool;
+        } else {
+            static_assert(std::is_same_v<T, std::string_view>, "unsupported literal type");
+            return Kind::LiteralString;
+        }
+    }
 public:
     ASTLiteralNode(T value)
-        : m_Value(value)
+        : ASTExprNode(getLiteralKind()), m_Value(value)
     {}
+    static bool classof(const ASTNode *node) { return node->getKind() == getLiteralKind(); }
     [[nodiscard]] T getValue() const { return m_Value; }
 };
 
 class ASTBinaryNode: public ASTExprNode {
 private:
-    std::unique_ptr<ASTExprNode> m_LeftOperrand;
+    ASTExprNode *m_LeftOperrand;
     Operator m_Operator;
-    std::unique_ptr<ASTExprNode> m_RightOperrand;
-
-    friend Parser;
+    ASTExprNode *m_RightOperrand;
 public:
     ASTBinaryNode(
-            std::unique_ptr<ASTExprNode> leftOperrand,
+            ASTExprNode *leftOperrand,
             Operator t_Operator,
-            std::unique_ptr<ASTExprNode> rightOperrand
+            ASTExprNode *rightOperrand
             );
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::Binary; }
 
-    [[nodiscard]] std::unique_ptr<ASTExprNode> getLeftOperrand() { return std::move(m_LeftOperrand); }
-    [[nodiscard]] std::unique_ptr<ASTExprNode> getRightOperrand() { return std::move(m_RightOperrand); }
+    [[nodiscard]] ASTExprNode *getLeftOperrand() const { return m_LeftOperrand; }
+    [[nodiscard]] ASTExprNode *getRightOperrand() const { return m_RightOperrand; }
     [[nodiscard]] Operator getOperator() const { return m_Operator; }
 };
 
+// `cond ? then : else`, only the chosen operand is evaluated.
+class ASTConditionalNode: public ASTExprNode {
+private:
+    ASTExprNode *m_Cond;
+    ASTExprNode *m_Then;
+    ASTExprNode *m_Else;
+public:
+    ASTConditionalNode(ASTExprNode *cond, ASTExprNode *then, ASTExprNode *t_Else)
+        : ASTExprNode(Kind::Conditional), m_Cond(cond), m_Then(then), m_Else(t_Else)
+    {}
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::Conditional; }
+    [[nodiscard]] ASTExprNode *getCond() const { return m_Cond; }
+    [[nodiscard]] ASTExprNode *getThen() const { return m_Then; }
+    [[nodiscard]] ASTExprNode *getElse() const { return m_Else; }
+};
+
 class ASTRangeNode: public ASTExprNode {
 private:
-    std::unique_ptr<ASTExprNode> m_Start;
+    ASTExprNode *m_Start;
     RangeOperator m_Operator;
-    std::unique_ptr<ASTExprNode> m_Stop;
+    ASTExprNode *m_Stop;
 public:
     ASTRangeNode(
-        std::unique_ptr<ASTExprNode> start,
+        ASTExprNode *start,
         RangeOperator t_Operator,
-        std::unique_ptr<ASTExprNode> stop
+        ASTExprNode *stop
         )
-    : m_Start(std::move(start)), m_Operator(t_Operator), m_Stop(std::move(stop))
+    : ASTExprNode(Kind::Range), m_Start(start), m_Operator(t_Operator), m_Stop(stop)
     {}
-    [[nodiscard]] ASTExprNode *getStart() const { return m_Start.get(); }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::Range; }
+    [[nodiscard]] ASTExprNode *getStart() const { return m_Start; }
     [[nodiscard]] const RangeOperator &getOp() const { return m_Operator; }
-    [[nodiscard]] ASTExprNode *getStop() const { return m_Stop.get(); }
+    [[nodiscard]] ASTExprNode *getStop() const { return m_Stop; }
 };
 
 class ASTIdentifierNode: public ASTExprNode {
 private:
-    std::string m_Identifier;
+    Symbol m_Identifier;
+protected:
+    ASTIdentifierNode(Kind kind, Symbol identifier);
 public:
-    ASTIdentifierNode(std::string identifier);
-    [[nodiscard]] const std::string &getName() const { return m_Identifier; }
+    ASTIdentifierNode(Symbol identifier);
+    static bool classof(const ASTNode *node) {
+        return node->getKind() == Kind::Identifier || node->getKind() == Kind::NamespaceIdentifier;
+    }
+    [[nodiscard]] Symbol getSymbol() const { return m_Identifier; }
+    [[nodiscard]] const std::string &getName() const { return m_Identifier.str(); }
 };
 
 class ASTNamespaceIdentifierNode: public ASTIdentifierNode {
 private:
-    std::string m_Namespace;
+    Symbol m_Namespace;
 public:
-    ASTNamespaceIdentifierNode(std::string &t_Namespace, std::string &identifier);
+    ASTNamespaceIdentifierNode(Symbol t_Namespace, Symbol identifier);
+    [[nodiscard]] Symbol getNamespaceSymbol() const { return m_Namespace; }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::NamespaceIdentifier; }
 };
 
 class ASTFunctionCallNode: public ASTExprNode {
 private:
-    std::unique_ptr<ASTIdentifierNode> m_Name;
-    std::vector<std::unique_ptr<ASTExprNode>> m_Args;
+    ASTIdentifierNode *m_Name;
+    ASTList<ASTExprNode*> m_Args;
 public:
-    ASTFunctionCallNode(std::unique_ptr<ASTIdentifierNode> name, std::vector<std::unique_ptr<ASTExprNode>> args);
-    [[nodiscard]] ASTIdentifierNode *getCallee() const { return m_Name.get(); }
-    [[nodiscard]] std::vector<std::unique_ptr<ASTExprNode>> getArgs() { return std::move(m_Args); }
+    ASTFunctionCallNode(ASTIdentifierNode *name, ASTList<ASTExprNode*> args);
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::FunctionCall; }
+    [[nodiscard]] ASTIdentifierNode *getCallee() const { return m_Name; }
+    [[nodiscard]] ASTList<ASTExprNode*> getArgs() const { return m_Args; }
 };
 
 class ASTAttributeAccessNode : public ASTExprNode {
 private:
-    std::string m_Name;
-    std::string m_Attribute;
+    Symbol m_Name;
+    Symbol m_Attribute;
+protected:
+    ASTAttributeAccessNode(Kind kind, Symbol name, Symbol attribute)
+        : ASTExprNode(kind), m_Name(name), m_Attribute(attribute)
+    {}
 public:
-    ASTAttributeAccessNode(std::string name, std::string attribute)
-        : m_Name(std::move(name)), m_Attribute(std::move(attribute))
+    ASTAttributeAccessNode(Symbol name, Symbol attribute)
+        : ASTAttributeAccessNode(Kind::AttributeAccess, name, attribute)
     {}
-    [[nodiscard]] const std::string &getName() const { return m_Name; }
-    [[nodiscard]] const std::string &getAttribute() const { return m_Attribute; }
+    static bool classof(const ASTNode *node) {
+        return node->getKind() == Kind::AttributeAccess || node->getKind() == Kind::MethodCall;
+    }
+    [[nodiscard]] Symbol getSymbol() const { return m_Name; }
+    [[nodiscard]] Symbol getAttributeSymbol() const { return m_Attribute; }
+    [[nodiscard]] const std::string &getName() const { return m_Name.str(); }
+    [[nodiscard]] const std::string &getAttribute() const { return m_Attribute.str(); }
 };
 
 class ASTMethodCallNode: public ASTAttributeAccessNode {
     private:
-        std::vector<std::unique_ptr<ASTExprNode>> m_Args;
+        ASTList<ASTExprNode*> m_Args;
     public:
         ASTMethodCallNode(
-                std::string structIdentifier,
-                std::string methodName,
-                std::vector<std::unique_ptr<ASTExprNode>> args
+                Symbol structIdentifier,
+                Symbol methodName,
+                ASTList<ASTExprNode*> args
                 );
-        [[nodiscard]] std::vector<std::unique_ptr<ASTExprNode>> getArgs() { return std::move(m_Args); }
+        static bool classof(const ASTNode *node) { return node->getKind() == Kind::MethodCall; }
+        [[nodiscard]] ASTList<ASTExprNode*> getArgs() const { return m_Args; }
 };
 
 class ASTArrayAccessNode : public ASTExprNode {
 private:
-    std::string m_Name;
+    Symbol m_Name;
     size_t m_Index;
 public:
-    ASTArrayAccessNode(std::string name, size_t index)
-        : m_Name(std::move(name)), m_Index(index)
+    ASTArrayAccessNode(Symbol name, size_t index)
+        : ASTExprNode(Kind::ArrayAccess), m_Name(name), m_Index(index)
     {}
-    [[nodiscard]] const std::string &getName() const { return m_Name; }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::ArrayAccess; }
+    [[nodiscard]] Symbol getSymbol() const { return m_Name; }
+    [[nodiscard]] const std::string &getName() const { return m_Name.str(); }
     [[nodiscard]] const size_t &getIndex() const { return m_Index; }
 };
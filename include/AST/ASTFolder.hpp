@@ -0,0 +1,82 @@
+#pragma once
+
+#include "AST/ASTContext.hpp"
+#include "AST/ASTExprNode.hpp"
+#include "AST/ASTNode.hpp"
+#include "AST/ASTStatementNode.hpp"
+#include "AST/ASTVisitor.hpp"
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Constant folding before the IR generation: binary operators of literals are
+// evaluated with the types and conversions the IR generator would use, x + 0
+// for integers, x - 0, x * 1 and x / 1 are simplified, && and || with a constant left
+// operand are short-circuited, the branch of an if or of a conditional with a
+// constant condition replaces it, and statements after a return are dropped.
+// A node with a folded child is created again in `context` and the others
+// are shared with the original tree. The types set by ASTTypeChecker are
+// kept: a folded expression has the type of the one it replaces. The only
+// node modified is an operand that replaces its operation, which takes the
+// converted type of the operation, so the original tree must not be used
+// after folding.
+class ASTFolder : private ASTVisitor<ASTFolder, ASTNode*> {
+private:
+    friend ASTVisitor<ASTFolder, ASTNode*>;
+
+    ASTContext &m_Context;
+
+    template<typename Node, typename... Args>
+    Node *create(const ASTNode *original, Args&&... args) {
+        Node *node = m_Context.create<Node>(std::forward<Args>(args)...);
+        node->setOffset(original->getOffset());
+        if constexpr (std::is_base_of_v<ASTExprNode, Node>) {
+            auto expr = cast<ASTExprNode>(original);
+            node->setType(expr->getExprType(), expr->getConvertedType());
+        }
+        return node;
+    }
+
+    template<typename T>
+    T *foldChild(T *node) {
+        return node == nullptr ? nullptr : cast<T>(visit(node));
+    }
+    // Same list if no element changed.
+    template<typename T>
+    ASTList<T*> foldList(ASTList<T*> nodes);
+    // Appends the folded statements of `block` to `nodes`, with the branch of
+    // an if taken in place of the if. Returns true once a return is added.
+    bool foldStatements(ASTBlockNode *block, std::vector<ASTNode*> &nodes);
+
+    ASTNode *visitNode(ASTNode *node) { return node; }
+    ASTNode *visitBinary(ASTBinaryNode *node);
+    ASTNode *visitConditional(ASTConditionalNode *node);
+    ASTNode *visitRange(ASTRangeNode *node);
+    ASTNode *visitFunctionCall(ASTFunctionCallNode *node);
+    ASTNode *visitMethodCall(ASTMethodCallNode *node);
+
+    ASTNode *visitExport(ASTExportNode *node);
+    ASTNode *visitInitialization(ASTInitializationNode *node);
+    ASTNode *visitArrayInitialization(ASTArrayInitializationNode *node);
+    ASTNode *visitAssignment(ASTAssignmentNode *node);
+    ASTNode *visitReturn(ASTReturnNode *node);
+    ASTNode *visitBlock(ASTBlockNode *node);
+    ASTNode *visitIf(ASTIfNode *node);
+    ASTNode *visitFor(ASTForNode *node);
+    ASTNode *visitFunctionDefinition(ASTFunctionDefinitionNode *node);
+    ASTNode *visitStructDefinition(ASTStructDefinitionNode *node);
+    ASTNode *visitStructInitialization(ASTStructInitializationNode *node);
+    ASTNode *visitStructAssignment(ASTStructAssignmentNode *node);
+    ASTNode *visitAttributeAssignment(ASTAttributeAssignmentNode *node);
+    ASTNode *visitArrayAssignment(ASTArrayAssignmentNode *node);
+    ASTNode *visitArrayMemberAssignment(ASTArrayMemeberAssignmentNode *node);
+
+public:
+    explicit ASTFolder(ASTContext &context)
+        : m_Context(context)
+    {}
+
+    // Folded `node`, or `node` itself if nothing changed.
+    ASTNode *fold(ASTNode *node) { return node == nullptr ? nullptr : visit(node); }
+    void fold(ASTProgramNode &program);
+};
@@ -1,19 +1,66 @@
 #pragma once
 
+#include "AST/ASTContext.hpp"
 #include <cstddef>
-#include <memory>
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 
 class ASTNode {
 public:
+    // Concrete class of a node, see classof() in every node class and
+    // Support/Casting.hpp. Subclasses of a same class are kept contiguous so
+    // that an abstract classof() is a range check.
+    enum class Kind : uint8_t {
+        // ASTExprNode
+        Binary,
+        Conditional,
+        Range,
+        LiteralInt,
+        LiteralLong,
+        LiteralDouble,
+        LiteralBool,
+        LiteralString,
+        Identifier,
+        NamespaceIdentifier,
+        FunctionCall,
+        AttributeAccess,
+        MethodCall,
+        ArrayAccess,
+
+        // ASTStatementNode
+        Import,
+        Export,
+        Declaration,
+        Initialization,
+        ArrayDefinition,
+        ArrayInitialization,
+        Assignment,
+        Return,
+        Block,
+        If,
+        For,
+        FunctionDefinition,
+        StructDefinition,
+        StructInitialization,
+        StructAssignment,
+        AttributeAssignment,
+        ArrayAssignment,
+        ArrayMemberAssignment,
+
+        Program
+    };
+
     enum TYPE {
-        NONE, INT, DOUBLE, BOOL, STRING, STRUCT, VOID
+        NONE, INT, LONG, DOUBLE, BOOL, STRING, STRUCT, VOID
     };
 
-    static TYPE stringToType(std::string str) {
+    static TYPE stringToType(std::string_view str) {
         if (str == "int") {
             return INT;
+        } else if (str == "long") {
+            return LONG;
         } else if (str == "double" || str == "float") {
             return DOUBLE;
         } else if (str == "bool") {
@@ -27,24 +74,71 @@ public:
         return NONE;
     }
 
-    virtual ~ASTNode() = default;
+    static const char *typeToString(TYPE type) {
+        switch (type) {
+            case NONE: return "none";
+            case INT: return "int";
+            case LONG: return "long";
+            case DOUBLE: return "double";
+            case BOOL: return "bool";
+            case STRING: return "string";
+            case STRUCT: return "struct";
+            case VOID: return "void";
+        }
+        return "none";
+    }
+
+    explicit ASTNode(Kind kind)
+        : m_Kind(kind)
+    {}
+
+    static bool classof(const ASTNode *) { return true; }
+
+    [[nodiscard]] Kind getKind() const { return m_Kind; }
+
+    // Offset in the source of the first token of the node, see SourceManager.
+    [[nodiscard]] uint32_t getOffset() const { return m_Offset; }
+    void setOffset(uint32_t offset) { m_Offset = offset; }
+
+private:
+    Kind m_Kind;
+    uint32_t m_Offset = 0;
 };
 
+// Root of the tree, the only node that is not allocated in an ASTContext: it
+// owns the one every other node lives in.
 class ASTProgramNode : public ASTNode {
 private:
-    std::vector<std::unique_ptr<ASTNode>> m_Nodes;
+    ASTContext m_Context;
+    // Contexts of the programs merged into this one.
+    std::vector<ASTContext> m_MergedContexts;
+    std::vector<ASTNode*> m_Nodes;
 public:
-    ASTProgramNode(std::vector<std::unique_ptr<ASTNode>> nodes)
-        :m_Nodes(std::move(nodes))
-    {};
-    void addNode(std::unique_ptr<ASTNode> node);
+    ASTProgramNode()
+        : ASTNode(Kind::Program)
+    {}
+    void addNode(ASTNode *node);
+    // Appends the nodes of `other` and takes over its memory.
+    void merge(ASTProgramNode &&other);
+    // Replaces the nodes in [begin, end) by `nodes`, which must be allocated
+    // in the context of the program. The replaced ones stay in it.
+    void replaceNodes(size_t begin, size_t end, const std::vector<ASTNode*> &nodes);
+
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::Program; }
+
+    [[nodiscard]] ASTContext &getContext() { return m_Context; }
+    // Bytes allocated in the context and in the merged ones.
+    [[nodiscard]] size_t getBytesAllocated() const;
 
-    using vec_type = std::vector<std::unique_ptr<ASTNode>>;
+    using vec_type = std::vector<ASTNode*>;
     using iterator = vec_type::iterator;
     using const_iterator = vec_type::const_iterator;
 
     [[nodiscard]] inline iterator begin() noexcept { return m_Nodes.begin(); }
+    [[nodiscard]] inline const_iterator begin() const noexcept { return m_Nodes.begin(); }
     [[nodiscard]] inline const_iterator cbegin() const noexcept { return m_Nodes.cbegin(); }
     [[nodiscard]] inline iterator end() noexcept { return m_Nodes.end(); }
+    [[nodiscard]] inline const_iterator end() const noexcept { return m_Nodes.end(); }
     [[nodiscard]] inline const_iterator cend() const noexcept { return m_Nodes.cend(); }
+    [[nodiscard]] size_t size() const { return m_Nodes.size(); }
 };
@@ -3,270 +3,335 @@
 #include <array>
 #include <cstddef>
 #include <string>
-#include <vector>
-#include <memory>
 
+#include "AST/ASTContext.hpp"
 #include "AST/ASTNode.hpp"
 #include "AST/ASTExprNode.hpp"
+#include "Support/StringInterner.hpp"
 
-class ASTStatementNode : public ASTNode
-{};
+class ASTStatementNode : public ASTNode {
+public:
+    using ASTNode::ASTNode;
+
+    static bool classof(const ASTNode *node) {
+        return node->getKind() >= Kind::Import && node->getKind() <= Kind::ArrayMemberAssignment;
+    }
+};
 
 class ASTImportNode : public ASTStatementNode {
 private:
-    std::string m_Module;
-    std::vector<std::string> m_SubModules;
+    Symbol m_Module;
+    ASTList<Symbol> m_SubModules;
 public:
-    ASTImportNode(std::string &module, std::vector<std::string> &subModules);
-    ASTImportNode(std::string &module);
+    ASTImportNode(Symbol module, ASTList<Symbol> subModules);
+    ASTImportNode(Symbol module);
+    [[nodiscard]] Symbol getModuleSymbol() const { return m_Module; }
+    [[nodiscard]] ASTList<Symbol> getSubModules() const { return m_SubModules; }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::Import; }
 };
 
 class ASTExportNode : public ASTStatementNode {
 private:
-    std::unique_ptr<ASTStatementNode> m_Module;
+    ASTStatementNode *m_Module;
 public:
-    ASTExportNode(std::unique_ptr<ASTStatementNode> module);
+    ASTExportNode(ASTStatementNode *module);
+    [[nodiscard]] ASTStatementNode *getModule() const { return m_Module; }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::Export; }
 };
 
 class ASTDeclarationNode : public ASTStatementNode {
 private:
-    std::string m_Name;
+    Symbol m_Name;
     ASTNode::TYPE m_Type;
-    std::string m_StructName;
+    Symbol m_StructName;
+protected:
+    ASTDeclarationNode(Kind kind, Symbol name, ASTNode::TYPE type, Symbol structName = Symbol());
 public:
-    ASTDeclarationNode(std::string &name, ASTNode::TYPE type, const std::string &strcutName = "");
-    [[nodiscard]] const std::string &getName() const { return m_Name; }
+    ASTDeclarationNode(Symbol name, ASTNode::TYPE type, Symbol structName = Symbol());
+    static bool classof(const ASTNode *node) {
+        return node->getKind() >= Kind::Declaration && node->getKind() <= Kind::ArrayInitialization;
+    }
+    [[nodiscard]] Symbol getSymbol() const { return m_Name; }
+    [[nodiscard]] const std::string &getName() const { return m_Name.str(); }
     [[nodiscard]] const ASTNode::TYPE &getType() const { return m_Type; }
-    [[nodiscard]] const std::string &getStructName() const { return m_StructName; }
+    [[nodiscard]] Symbol getStructSymbol() const { return m_StructName; }
+    [[nodiscard]] const std::string &getStructName() const { return m_StructName.str(); }
 };
 
 class ASTInitializationNode : public ASTDeclarationNode {
 private:
-    std::unique_ptr<ASTExprNode> m_Value;
+    ASTExprNode *m_Value;
 public:
-    ASTInitializationNode(std::string name, ASTNode::TYPE type, std::unique_ptr<ASTExprNode> value)
-        : ASTDeclarationNode(name, type), m_Value(std::move(value))
+    ASTInitializationNode(Symbol name, ASTNode::TYPE type, ASTExprNode *value)
+        : ASTDeclarationNode(Kind::Initialization, name, type), m_Value(value)
     {}
-    [[nodiscard]] ASTExprNode *getValue() const { return m_Value.get(); }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::Initialization; }
+    [[nodiscard]] ASTExprNode *getValue() const { return m_Value; }
 };
 
 class ASTAssignmentNode: public ASTStatementNode {
 private:
-    std::string m_Name;
-    std::unique_ptr<ASTExprNode> m_Value;
+    Symbol m_Name;
+    ASTExprNode *m_Value;
 public:
-    ASTAssignmentNode(std::string name, std::unique_ptr<ASTExprNode> value)
-        : m_Name(std::move(name)), m_Value(std::move(value))
+    ASTAssignmentNode(Symbol name, ASTExprNode *value)
+        : ASTStatementNode(Kind::Assignment), m_Name(name), m_Value(value)
     {}
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::Assignment; }
 
-    [[nodiscard]] const std::string &getName() const { return m_Name; }
-    [[nodiscard]] ASTExprNode *getValue() const { return m_Value.get(); }
+    [[nodiscard]] Symbol getSymbol() const { return m_Name; }
+    [[nodiscard]] const std::string &getName() const { return m_Name.str(); }
+    [[nodiscard]] ASTExprNode *getValue() const { return m_Value; }
 };
 
 class ASTReturnNode: public ASTStatementNode {
 private:
-    std::unique_ptr<ASTExprNode> m_ReturnExpr;
+    ASTExprNode *m_ReturnExpr;
 public:
-    ASTReturnNode(std::unique_ptr<ASTExprNode> returnExpr);
-    [[nodiscard]] ASTExprNode *getExpr() const { return m_ReturnExpr.get(); }
+    ASTReturnNode(ASTExprNode *returnExpr);
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::Return; }
+    [[nodiscard]] ASTExprNode *getExpr() const { return m_ReturnExpr; }
 };
 
 
 class ASTBlockNode: public ASTStatementNode {
 private:
-    std::vector<std::unique_ptr<ASTNode>> m_Nodes;
+    ASTList<ASTNode*> m_Nodes;
 
-    using baseIterator = std::vector<std::unique_ptr<ASTNode>>::iterator;
-    using baseConstIterator = std::vector<std::unique_ptr<ASTNode>>::const_iterator;
+    using baseIterator = ASTList<ASTNode*>::iterator;
+    using baseConstIterator = ASTList<ASTNode*>::const_iterator;
 public:
-    ASTBlockNode(std::vector<std::unique_ptr<ASTNode>> nodes);
+    ASTBlockNode(ASTList<ASTNode*> nodes);
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::Block; }
 
-    [[nodiscard]] baseIterator begin() { return m_Nodes.begin(); }
-    [[nodiscard]] baseIterator end()   { return m_Nodes.end(); }
+    [[nodiscard]] baseIterator begin() const { return m_Nodes.begin(); }
+    [[nodiscard]] baseIterator end() const   { return m_Nodes.end(); }
     [[nodiscard]] baseConstIterator cbegin() const { return m_Nodes.cbegin(); }
     [[nodiscard]] baseConstIterator cend() const   { return m_Nodes.cend(); }
+    [[nodiscard]] ASTList<ASTNode*> getNodes() const { return m_Nodes; }
+
+};
 
+// Expected value of the condition of an if: `if likely (...)` or
+// `if unlikely (...)`.
+enum class BranchHint : uint8_t {
+    none,
+    likely,
+    unlikely
 };
 
 class ASTIfNode: public ASTStatementNode {
 private:
-    std::unique_ptr<ASTExprNode> m_Condition;
-    std::unique_ptr<ASTBlockNode> m_IfBlock;
-    std::unique_ptr<ASTBlockNode> m_ElseBlock;
+    ASTExprNode *m_Condition;
+    ASTBlockNode *m_IfBlock;
+    ASTBlockNode *m_ElseBlock;
+    BranchHint m_Hint;
 public:
     ASTIfNode(
-            std::unique_ptr<ASTExprNode> condition,
-            std::unique_ptr<ASTBlockNode> ifBlock,
-            std::unique_ptr<ASTBlockNode> elseBlock
+            ASTExprNode *condition,
+            ASTBlockNode *ifBlock,
+            ASTBlockNode *elseBlock,
+            BranchHint hint = BranchHint::none
             );
-    [[nodiscard]] ASTExprNode *getCond() const { return m_Condition.get(); }
-    [[nodiscard]] ASTBlockNode *getThen() const { return m_IfBlock.get(); }
-    [[nodiscard]] ASTBlockNode *getElse() const { return m_ElseBlock.get(); }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::If; }
+    [[nodiscard]] ASTExprNode *getCond() const { return m_Condition; }
+    [[nodiscard]] ASTBlockNode *getThen() const { return m_IfBlock; }
+    [[nodiscard]] ASTBlockNode *getElse() const { return m_ElseBlock; }
+    [[nodiscard]] BranchHint getHint() const { return m_Hint; }
 };
 
 class ASTForNode: public ASTStatementNode {
 private:
-    std::unique_ptr<ASTDeclarationNode> m_Iterator;
-    std::unique_ptr<ASTExprNode> m_Condition;
-    std::unique_ptr<ASTBlockNode> m_Block;
+    ASTDeclarationNode *m_Iterator;
+    ASTExprNode *m_Condition;
+    ASTBlockNode *m_Block;
 public:
     ASTForNode(
-            std::unique_ptr<ASTDeclarationNode> iterator,
-            std::unique_ptr<ASTExprNode> condition,
-            std::unique_ptr<ASTBlockNode> block
+            ASTDeclarationNode *iterator,
+            ASTExprNode *condition,
+            ASTBlockNode *block
             );
-    [[nodiscard]] ASTDeclarationNode *getDecl() const { return m_Iterator.get(); }
-    [[nodiscard]] ASTExprNode *getCond() const { return m_Condition.get(); }
-    [[nodiscard]] ASTBlockNode *getBlock() const { return m_Block.get(); }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::For; }
+    [[nodiscard]] ASTDeclarationNode *getDecl() const { return m_Iterator; }
+    [[nodiscard]] ASTExprNode *getCond() const { return m_Condition; }
+    [[nodiscard]] ASTBlockNode *getBlock() const { return m_Block; }
 };
 
 class ASTFunctionDefinitionNode: public ASTStatementNode {
 private:
-    std::string m_Name;
-    std::vector<std::unique_ptr<ASTDeclarationNode>> m_Args;
+    Symbol m_Name;
+    ASTList<ASTDeclarationNode*> m_Args;
     ASTNode::TYPE m_ReturnType;
-    std::unique_ptr<ASTBlockNode> m_Body;
-    std::string m_ReturnStruct;
+    ASTBlockNode *m_Body;
+    Symbol m_ReturnStruct;
+    bool m_IsCold;
 public:
     ASTFunctionDefinitionNode(
-            std::string &name,
-            std::vector<std::unique_ptr<ASTDeclarationNode>> args,
+            Symbol name,
+            ASTList<ASTDeclarationNode*> args,
             ASTNode::TYPE returnType,
-            std::unique_ptr<ASTBlockNode> body,
-            std::string returnStruct = ""
+            ASTBlockNode *body,
+            Symbol returnStruct = Symbol(),
+            bool isCold = false
             );
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::FunctionDefinition; }
 
-    [[nodiscard]] const std::string &getName() const { return m_Name; }
-    [[nodiscard]] std::vector<std::unique_ptr<ASTDeclarationNode>> getArgs() { return std::move(m_Args); }
+    [[nodiscard]] Symbol getSymbol() const { return m_Name; }
+    [[nodiscard]] const std::string &getName() const { return m_Name.str(); }
+    [[nodiscard]] ASTList<ASTDeclarationNode*> getArgs() const { return m_Args; }
     [[nodiscard]] const ASTNode::TYPE &getType() const { return m_ReturnType; }
-    [[nodiscard]] ASTBlockNode *getBody() const { return m_Body.get(); }
-    [[nodiscard]] const std::string &getReturnStructName() const { return m_ReturnStruct; }
+    [[nodiscard]] ASTBlockNode *getBody() const { return m_Body; }
+    [[nodiscard]] Symbol getReturnStructSymbol() const { return m_ReturnStruct; }
+    [[nodiscard]] const std::string &getReturnStructName() const { return m_ReturnStruct.str(); }
+    // `cold func`, rarely called: kept out of the way of the hot code.
+    [[nodiscard]] bool isCold() const { return m_IsCold; }
 };
 
 class ASTStructDefinitionNode: public ASTStatementNode {
 private:
-    std::string m_Name;
-    std::vector<std::unique_ptr<ASTDeclarationNode>> m_Attributes;
-    std::vector<std::unique_ptr<ASTFunctionDefinitionNode>> m_Methods;
+    Symbol m_Name;
+    ASTList<ASTDeclarationNode*> m_Attributes;
+    ASTList<ASTFunctionDefinitionNode*> m_Methods;
 public:
     ASTStructDefinitionNode(
-            std::string &name,
-            std::vector<std::unique_ptr<ASTDeclarationNode>> attributes,
-            std::vector<std::unique_ptr<ASTFunctionDefinitionNode>> methods
+            Symbol name,
+            ASTList<ASTDeclarationNode*> attributes,
+            ASTList<ASTFunctionDefinitionNode*> methods
             );
-    [[nodiscard]] const std::string &getName() const { return m_Name; }
-    [[nodiscard]] std::vector<std::unique_ptr<ASTDeclarationNode>> getAttributes() { return std::move(m_Attributes); }
-    [[nodiscard]] std::vector<std::unique_ptr<ASTFunctionDefinitionNode>> getMethods() { return std::move(m_Methods); }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::StructDefinition; }
+    [[nodiscard]] Symbol getSymbol() const { return m_Name; }
+    [[nodiscard]] const std::string &getName() const { return m_Name.str(); }
+    [[nodiscard]] ASTList<ASTDeclarationNode*> getAttributes() const { return m_Attributes; }
+    [[nodiscard]] ASTList<ASTFunctionDefinitionNode*> getMethods() const { return m_Methods; }
 };
 
 class ASTStructInitializationNode: public ASTStatementNode {
 private:
-    std::unique_ptr<ASTIdentifierNode> m_Struct;
-    std::string m_Name;
-    std::vector<std::unique_ptr<ASTExprNode>> m_AttributesValues;
+    ASTIdentifierNode *m_Struct;
+    Symbol m_Name;
+    ASTList<ASTExprNode*> m_AttributesValues;
 public:
     ASTStructInitializationNode(
-            std::unique_ptr<ASTIdentifierNode> t_Struct,
-            std::string &name,
-            std::vector<std::unique_ptr<ASTExprNode>> attributesValues
+            ASTIdentifierNode *t_Struct,
+            Symbol name,
+            ASTList<ASTExprNode*> attributesValues
             );
-    [[nodiscard]] ASTIdentifierNode *getStruct() const { return m_Struct.get(); }
-    [[nodiscard]] const std::string &getName() const { return m_Name; }
-    [[nodiscard]] std::vector<std::unique_ptr<ASTExprNode>> getAttributesValues() { return std::move(m_AttributesValues); }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::StructInitialization; }
+    [[nodiscard]] ASTIdentifierNode *getStruct() const { return m_Struct; }
+    [[nodiscard]] Symbol getSymbol() const { return m_Name; }
+    [[nodiscard]] const std::string &getName() const { return m_Name.str(); }
+    [[nodiscard]] ASTList<ASTExprNode*> getAttributesValues() const { return m_AttributesValues; }
 };
 
 class ASTStructAssignmentNode: public ASTStatementNode {
 private:
-    std::string m_Name;
-    std::vector<std::unique_ptr<ASTExprNode>> m_AttributesValues;
+    Symbol m_Name;
+    ASTList<ASTExprNode*> m_AttributesValues;
 public:
     ASTStructAssignmentNode(
-            std::string &name,
-            std::vector<std::unique_ptr<ASTExprNode>> attributesValues
+            Symbol name,
+            ASTList<ASTExprNode*> attributesValues
             );
-    [[nodiscard]] std::vector<std::unique_ptr<ASTExprNode>> getAttributesValues() { return std::move(m_AttributesValues); }
-    [[nodiscard]] const std::string &getName() const { return m_Name; }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::StructAssignment; }
+    [[nodiscard]] ASTList<ASTExprNode*> getAttributesValues() const { return m_AttributesValues; }
+    [[nodiscard]] Symbol getSymbol() const { return m_Name; }
+    [[nodiscard]] const std::string &getName() const { return m_Name.str(); }
 };
 
 class ASTAttributeAssignmentNode: public ASTStatementNode {
 private:
-    std::string m_StrcutName;
-    std::string m_AttributeName;
-    std::unique_ptr<ASTExprNode> m_Value;
+    Symbol m_StrcutName;
+    Symbol m_AttributeName;
+    ASTExprNode *m_Value;
 public:
     ASTAttributeAssignmentNode(
-            std::string &strcutName,
-            std::string &attributeName,
-            std::unique_ptr<ASTExprNode> value
+            Symbol strcutName,
+            Symbol attributeName,
+            ASTExprNode *value
             );
-    [[nodiscard]] const std::string &getStructName() const { return m_StrcutName; }
-    [[nodiscard]] const std::string &getAttributeName() const { return m_AttributeName; }
-    [[nodiscard]] ASTExprNode *getValue() const { return m_Value.get(); }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::AttributeAssignment; }
+    [[nodiscard]] Symbol getStructSymbol() const { return m_StrcutName; }
+    [[nodiscard]] Symbol getAttributeSymbol() const { return m_AttributeName; }
+    [[nodiscard]] const std::string &getStructName() const { return m_StrcutName.str(); }
+    [[nodiscard]] const std::string &getAttributeName() const { return m_AttributeName.str(); }
+    [[nodiscard]] ASTExprNode *getValue() const { return m_Value; }
 };
 
 class ASTArrayDefinitionNode: public ASTDeclarationNode {
 private:
     const size_t m_Size;
+protected:
+    ASTArrayDefinitionNode(Kind kind, Symbol name, size_t size, ASTNode::TYPE type);
 public:
-    ASTArrayDefinitionNode(std::string &name, size_t size, ASTNode::TYPE type);
+    ASTArrayDefinitionNode(Symbol name, size_t size, ASTNode::TYPE type);
+    static bool classof(const ASTNode *node) {
+        return node->getKind() == Kind::ArrayDefinition || node->getKind() == Kind::ArrayInitialization;
+    }
     [[nodiscard]] const size_t &getSize() const { return m_Size; }
 };
 
 class ASTArrayInitializationNode: public ASTArrayDefinitionNode {
 private:
-    std::vector<std::unique_ptr<ASTExprNode>> m_Values;
+    ASTList<ASTExprNode*> m_Values;
     
-    using baseIt = std::vector<std::unique_ptr<ASTExprNode>>::iterator;
-    using baseConstIt = std::vector<std::unique_ptr<ASTExprNode>>::const_iterator;
+    using baseIt = ASTList<ASTExprNode*>::iterator;
+    using baseConstIt = ASTList<ASTExprNode*>::const_iterator;
 public:
     ASTArrayInitializationNode(
-            std::string &name,
+            Symbol name,
             ASTNode::TYPE type,
             size_t size,
-            std::vector<std::unique_ptr<ASTExprNode>> values
+            ASTList<ASTExprNode*> values
             )
-        : ASTArrayDefinitionNode(name, size, type), m_Values(std::move(values))
+        : ASTArrayDefinitionNode(Kind::ArrayInitialization, name, size, type), m_Values(values)
     {}
-    [[nodiscard]] baseIt begin() { return m_Values.begin(); }
-    [[nodiscard]] baseIt end()   { return m_Values.end(); }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::ArrayInitialization; }
+    [[nodiscard]] baseIt begin() const { return m_Values.begin(); }
+    [[nodiscard]] baseIt end() const   { return m_Values.end(); }
     [[nodiscard]] const baseConstIt cbegin() const { return m_Values.cbegin(); }
     [[nodiscard]] const baseConstIt cend()   const { return m_Values.cend(); }
+    [[nodiscard]] ASTList<ASTExprNode*> getValues() const { return m_Values; }
 };
 
 class ASTArrayAssignmentNode: public ASTStatementNode {
 private:
-    std::string m_Name;
-    std::vector<std::unique_ptr<ASTExprNode>> m_Values;
-    using baseType = std::vector<std::unique_ptr<ASTExprNode>>;
+    Symbol m_Name;
+    ASTList<ASTExprNode*> m_Values;
+    using baseType = ASTList<ASTExprNode*>;
     using baseIt = baseType::iterator;
     using baseConstIt = baseType::const_iterator;
 public:
     ASTArrayAssignmentNode(
-            std::string &name,
-            std::vector<std::unique_ptr<ASTExprNode>> values
+            Symbol name,
+            ASTList<ASTExprNode*> values
             )
-        : m_Name(std::move(name)), m_Values(std::move(values))
+        : ASTStatementNode(Kind::ArrayAssignment), m_Name(name), m_Values(values)
     {}
-    [[nodiscard]] const std::string &getName() const { return m_Name; }
-    [[nodiscard]] baseIt begin() { return m_Values.begin(); }
-    [[nodiscard]] baseIt end()   { return m_Values.end(); }
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::ArrayAssignment; }
+    [[nodiscard]] Symbol getSymbol() const { return m_Name; }
+    [[nodiscard]] const std::string &getName() const { return m_Name.str(); }
+    [[nodiscard]] baseIt begin() const { return m_Values.begin(); }
+    [[nodiscard]] baseIt end() const   { return m_Values.end(); }
     [[nodiscard]] const baseConstIt cbegin() const { return m_Values.cbegin(); }
     [[nodiscard]] const baseConstIt cend()   const { return m_Values.cend(); }
+    [[nodiscard]] ASTList<ASTExprNode*> getValues() const { return m_Values; }
     [[nodiscard]] const size_t getSize() const { return m_Values.size(); }
 };
 
 class ASTArrayMemeberAssignmentNode: public ASTStatementNode {
 private:
-    std::string m_ArrayName;
+    Symbol m_ArrayName;
     size_t m_Index;
-    std::unique_ptr<ASTExprNode> m_Value;
+    ASTExprNode *m_Value;
 public:
     ASTArrayMemeberAssignmentNode(
-            std::string &arrayName,
+            Symbol arrayName,
             size_t index,
-            std::unique_ptr<ASTExprNode> value);
-    [[nodiscard]] const std::string &getName() const { return m_ArrayName; }
+            ASTExprNode *value);
+    static bool classof(const ASTNode *node) { return node->getKind() == Kind::ArrayMemberAssignment; }
+    [[nodiscard]] Symbol getSymbol() const { return m_ArrayName; }
+    [[nodiscard]] const std::string &getName() const { return m_ArrayName.str(); }
     [[nodiscard]] const size_t &getIndex() const { return m_Index; }
-    [[nodiscard]] ASTExprNode *getValue() const { return m_Value.get(); }
+    [[nodiscard]] ASTExprNode *getValue() const { return m_Value; }
 };
 
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "AST/ASTExprNode.hpp"
+#include "AST/ASTNode.hpp"
+#include "AST/ASTStatementNode.hpp"
+#include "AST/ASTVisitor.hpp"
+#include "Support/StringInterner.hpp"
+#include <parallel_hashmap/phmap.h>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Type of a value, `structName` is only set for STRUCT.
+struct ASTType {
+    ASTNode::TYPE type;
+    Symbol structName;
+
+    ASTType(ASTNode::TYPE type = ASTNode::NONE, Symbol structName = Symbol())
+        : type(type), structName(structName) {}
+
+    [[nodiscard]] std::string str() const;
+};
+
+struct TypeError {
+    uint32_t offset;
+    std::string message;
+};
+
+// Static checks of a program before the IR generation. Every name is
+// resolved, every expression is annotated with its type and the type it is
+// converted to (see ASTExprNode::getExprType()), and anything the IR
+// generator would reject or miscompile is reported as a TypeError.
+// Numeric types convert implicitly to each other, a binary operator converts
+// its operands like IRGenerator::generateBinary() always did: integers to
+// the widest of the two, and an operand mixed with a double to the type of
+// the left one. The operands of a conditional are converted to the widest of
+// the two. Booleans and structs never convert.
+// Declarations are scoped like in the IR generator: functions and for loops
+// open a scope, other blocks do not.
+class ASTTypeChecker : private ASTVisitor<ASTTypeChecker, ASTType> {
+private:
+    friend ASTVisitor<ASTTypeChecker, ASTType>;
+
+    struct Variable {
+        Symbol name;
+        ASTType type;
+        bool isArray;
+        size_t size;
+        uint32_t shadowed;
+    };
+    struct Function {
+        ASTType returnType;
+        std::vector<ASTType> args;
+    };
+    struct Struct {
+        std::vector<std::pair<Symbol, ASTType>> attributes;
+        phmap::flat_hash_map<Symbol, Function> methods;
+    };
+
+    // Same layout as Scope: m_InnermostVariables[id] is the slot of the
+    // innermost variable named `id`, plus one.
+    std::vector<Variable> m_Variables;
+    std::vector<uint32_t> m_InnermostVariables;
+    std::vector<uint32_t> m_Frames = {0};
+
+    phmap::flat_hash_map<Symbol, Function> m_Functions;
+    phmap::flat_hash_map<Symbol, Struct> m_Structs;
+
+    bool m_InFunction = false;
+    ASTType m_ReturnType;
+    // Where the innermost statement being checked starts, the errors of an
+    // expression missing from it are reported there.
+    uint32_t m_StatementOffset = 0;
+
+    std::vector<TypeError> m_Errors;
+
+    void error(const ASTNode *node, std::string message);
+
+    [[nodiscard]] bool isAtTopLevel() const { return m_Frames.size() == 1; }
+    void pushScope();
+    void popScope();
+    const Variable *lookup(Symbol name) const;
+    void declare(const ASTNode *node, Symbol name, ASTType type, bool isArray = false, size_t size = 0);
+    // Reports the uses of an undefined variable, of an array as a value and
+    // of a value as an array.
+    const Variable *lookupVariable(const ASTNode *node, Symbol name, bool isArray);
+    const Struct *lookupStruct(const ASTNode *node, const Variable *variable);
+
+    // Whether a variable, an argument or an attribute can be of `type`.
+    bool checkValueType(const ASTNode *node, ASTType type, bool builtinOnly = false);
+    bool checkInFunction(const ASTNode *node, const char *what);
+
+    // An expression statement is checked like any other expression.
+    void checkStatement(ASTNode *node);
+    // A missing expression is an error, its type is NONE.
+    ASTType checkExpr(ASTExprNode *expr);
+    // A condition is a number, true when it is not zero, or a bool.
+    bool checkCondition(ASTExprNode *expr, const char *what);
+    // Checks that `expr` converts to `type` and records the conversion.
+    // Global variables also need a value known at compile time.
+    bool expect(ASTExprNode *expr, ASTType type, const char *context, bool constant = false);
+    void checkArgs(const ASTNode *node, const std::string &name, const Function *function,
+            ASTList<ASTExprNode*> args);
+    void checkFunction(ASTFunctionDefinitionNode *node, const Struct *owner);
+
+    ASTType visitNode(ASTNode *node);
+    ASTType visitLiteralInt(ASTLiteralNode<int> *) { return {ASTNode::INT}; }
+    ASTType visitLiteralLong(ASTLiteralNode<int64_t> *) { return {ASTNode::LONG}; }
+    ASTType visitLiteralDouble(ASTLiteralNode<double> *) { return {ASTNode::DOUBLE}; }
+    ASTType visitLiteralBool(ASTLiteralNode<bool> *) { return {ASTNode::BOOL}; }
+    ASTType visitIdentifier(ASTIdentifierNode *node);
+    ASTType visitNamespaceIdentifier(ASTNamespaceIdentifierNode *node) { return visitNode(node); }
+    ASTType visitBinary(ASTBinaryNode *node);
+    ASTType visitConditional(ASTConditionalNode *node);
+    ASTType visitFunctionCall(ASTFunctionCallNode *node);
+    ASTType visitAttributeAccess(ASTAttributeAccessNode *node);
+    ASTType visitMethodCall(ASTMethodCallNode *node);
+    ASTType visitArrayAccess(ASTArrayAccessNode *node);
+
+    ASTType visitDeclaration(ASTDeclarationNode *node);
+    ASTType visitInitialization(ASTInitializationNode *node);
+    ASTType visitArrayDefinition(ASTArrayDefinitionNode *node);
+    ASTType visitArrayInitialization(ASTArrayInitializationNode *node);
+    ASTType visitAssignment(ASTAssignmentNode *node);
+    ASTType visitReturn(ASTReturnNode *node);
+    ASTType visitBlock(ASTBlockNode *node);
+    ASTType visitIf(ASTIfNode *node);
+    ASTType visitFor(ASTForNode *node);
+    ASTType visitFunctionDefinition(ASTFunctionDefinitionNode *node);
+    ASTType visitStructDefinition(ASTStructDefinitionNode *node);
+    ASTType visitStructInitialization(ASTStructInitializationNode *node);
+    ASTType visitStructAssignment(ASTStructAssignmentNode *node);
+    ASTType visitAttributeAssignment(ASTAttributeAssignmentNode *node);
+    ASTType visitArrayAssignment(ASTArrayAssignmentNode *node);
+    ASTType visitArrayMemberAssignment(ASTArrayMemeberAssignmentNode *node);
+
+public:
+    // Checks a top-level node, the declarations it makes are visible to the
+    // nodes checked after it. Returns false if it has errors.
+    bool check(ASTNode *node);
+    bool check(ASTProgramNode &program);
+
+    [[nodiscard]] const std::vector<TypeError> &getErrors() const { return m_Errors; }
+};
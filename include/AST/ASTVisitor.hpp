@@ -0,0 +1,214 @@
+#pragma once
+
+#include "AST/ASTExprNode.hpp"
+#include "AST/ASTNode.hpp"
+#include "AST/ASTStatementNode.hpp"
+#include "Support/Casting.hpp"
+
+#include <cassert>
+#include <string_view>
+
+// Dispatches a node to the visit method of its concrete class with a single
+// switch on its kind. `Derived` overrides (hides) the methods it handles, the
+// others fall back to the method of the parent class, e.g. visitMethodCall()
+// to visitAttributeAccess(), to visitExpr() and finally to visitNode().
+template<typename Derived, typename Ret = void>
+class ASTVisitor {
+private:
+    Derived &derived() { return *static_cast<Derived *>(this); }
+
+public:
+    Ret visit(ASTNode *node) {
+        assert(node != nullptr && "visiting a null node");
+        using Kind = ASTNode::Kind;
+        switch (node->getKind()) {
+            case Kind::Binary: return derived().visitBinary(cast<ASTBinaryNode>(node));
+            case Kind::Conditional: return derived().visitConditional(cast<ASTConditionalNode>(node));
+            case Kind::Range: return derived().visitRange(cast<ASTRangeNode>(node));
+            case Kind::LiteralInt: return derived().visitLiteralInt(cast<ASTLiteralNode<int>>(node));
+            case Kind::LiteralLong: return derived().visitLiteralLong(cast<ASTLiteralNode<int64_t>>(node));
+            case Kind::LiteralDouble: return derived().visitLiteralDouble(cast<ASTLiteralNode<double>>(node));
+            case Kind::LiteralBool: return derived().visitLiteralBool(cast<ASTLiteralNode<bool>>(node));
+            case Kind::LiteralString: return derived().visitLiteralString(cast<ASTLiteralNode<std::string_view>>(node));
+            case Kind::Identifier: return derived().visitIdentifier(cast<ASTIdentifierNode>(node));
+            case Kind::NamespaceIdentifier: return derived().visitNamespaceIdentifier(cast<ASTNamespaceIdentifierNode>(node));
+            case Kind::FunctionCall: return derived().visitFunctionCall(cast<ASTFunctionCallNode>(node));
+            case Kind::AttributeAccess: return derived().visitAttributeAccess(cast<ASTAttributeAccessNode>(node));
+            case Kind::MethodCall: return derived().visitMethodCall(cast<ASTMethodCallNode>(node));
+            case Kind::ArrayAccess: return derived().visitArrayAccess(cast<ASTArrayAccessNode>(node));
+
+            case Kind::Import: return derived().visitImport(cast<ASTImportNode>(node));
+            case Kind::Export: return derived().visitExport(cast<ASTExportNode>(node));
+            case Kind::Declaration: return derived().visitDeclaration(cast<ASTDeclarationNode>(node));
+            case Kind::Initialization: return derived().visitInitialization(cast<ASTInitializationNode>(node));
+            case Kind::ArrayDefinition: return derived().visitArrayDefinition(cast<ASTArrayDefinitionNode>(node));
+            case Kind::ArrayInitialization: return derived().visitArrayInitialization(cast<ASTArrayInitializationNode>(node));
+            case Kind::Assignment: return derived().visitAssignment(cast<ASTAssignmentNode>(node));
+            case Kind::Return: return derived().visitReturn(cast<ASTReturnNode>(node));
+            case Kind::Block: return derived().visitBlock(cast<ASTBlockNode>(node));
+            case Kind::If: return derived().visitIf(cast<ASTIfNode>(node));
+            case Kind::For: return derived().visitFor(cast<ASTForNode>(node));
+            case Kind::FunctionDefinition: return derived().visitFunctionDefinition(cast<ASTFunctionDefinitionNode>(node));
+            case Kind::StructDefinition: return derived().visitStructDefinition(cast<ASTStructDefinitionNode>(node));
+            case Kind::StructInitialization: return derived().visitStructInitialization(cast<ASTStructInitializationNode>(node));
+            case Kind::StructAssignment: return derived().visitStructAssignment(cast<ASTStructAssignmentNode>(node));
+            case Kind::AttributeAssignment: return derived().visitAttributeAssignment(cast<ASTAttributeAssignmentNode>(node));
+            case Kind::ArrayAssignment: return derived().visitArrayAssignment(cast<ASTArrayAssignmentNode>(node));
+            case Kind::ArrayMemberAssignment: return derived().visitArrayMemberAssignment(cast<ASTArrayMemeberAssignmentNode>(node));
+
+            case Kind::Program: return derived().visitProgram(cast<ASTProgramNode>(node));
+        }
+        return Ret();
+    }
+
+    Ret visitNode(ASTNode *) { return Ret(); }
+    Ret visitExpr(ASTExprNode *node) { return derived().visitNode(node); }
+    Ret visitStatement(ASTStatementNode *node) { return derived().visitNode(node); }
+    Ret visitProgram(ASTProgramNode *node) { return derived().visitNode(node); }
+
+    Ret visitBinary(ASTBinaryNode *node) { return derived().visitExpr(node); }
+    Ret visitConditional(ASTConditionalNode *node) { return derived().visitExpr(node); }
+    Ret visitRange(ASTRangeNode *node) { return derived().visitExpr(node); }
+    Ret visitLiteralInt(ASTLiteralNode<int> *node) { return derived().visitExpr(node); }
+    Ret visitLiteralLong(ASTLiteralNode<int64_t> *node) { return derived().visitExpr(node); }
+    Ret visitLiteralDouble(ASTLiteralNode<double> *node) { return derived().visitExpr(node); }
+    Ret visitLiteralBool(ASTLiteralNode<bool> *node) { return derived().visitExpr(node); }
+    Ret visitLiteralString(ASTLiteralNode<std::string_view> *node) { return derived().visitExpr(node); }
+    Ret visitIdentifier(ASTIdentifierNode *node) { return derived().visitExpr(node); }
+    Ret visitNamespaceIdentifier(ASTNamespaceIdentifierNode *node) { return derived().visitIdentifier(node); }
+    Ret visitFunctionCall(ASTFunctionCallNode *node) { return derived().visitExpr(node); }
+    Ret visitAttributeAccess(ASTAttributeAccessNode *node) { return derived().visitExpr(node); }
+    Ret visitMethodCall(ASTMethodCallNode *node) { return derived().visitAttributeAccess(node); }
+    Ret visitArrayAccess(ASTArrayAccessNode *node) { return derived().visitExpr(node); }
+
+    Ret visitImport(ASTImportNode *node) { return derived().visitStatement(node); }
+    Ret visitExport(ASTExportNode *node) { return derived().visitStatement(node); }
+    Ret visitDeclaration(ASTDeclarationNode *node) { return derived().visitStatement(node); }
+    Ret visitInitialization(ASTInitializationNode *node) { return derived().visitDeclaration(node); }
+    Ret visitArrayDefinition(ASTArrayDefinitionNode *node) { return derived().visitDeclaration(node); }
+    Ret visitArrayInitialization(ASTArrayInitializationNode *node) { return derived().visitArrayDefinition(node); }
+    Ret visitAssignment(ASTAssignmentNode *node) { return derived().visitStatement(node); }
+    Ret visitReturn(ASTReturnNode *node) { return derived().visitStatement(node); }
+    Ret visitBlock(ASTBlockNode *node) { return derived().visitStatement(node); }
+    Ret visitIf(ASTIfNode *node) { return derived().visitStatement(node); }
+    Ret visitFor(ASTForNode *node) { return derived().visitStatement(node); }
+    Ret visitFunctionDefinition(ASTFunctionDefinitionNode *node) { return derived().visitStatement(node); }
+    Ret visitStructDefinition(ASTStructDefinitionNode *node) { return derived().visitStatement(node); }
+    Ret visitStructInitialization(ASTStructInitializationNode *node) { return derived().visitStatement(node); }
+    Ret visitStructAssignment(ASTStructAssignmentNode *node) { return derived().visitStatement(node); }
+    Ret visitAttributeAssignment(ASTAttributeAssignmentNode *node) { return derived().visitStatement(node); }
+    Ret visitArrayAssignment(ASTArrayAssignmentNode *node) { return derived().visitStatement(node); }
+    Ret visitArrayMemberAssignment(ASTArrayMemeberAssignmentNode *node) { return derived().visitStatement(node); }
+};
+
+// Calls `fn` on every child of `node` that is not null, in source order.
+template<typename Fn>
+void forEachChild(ASTNode *node, Fn &&fn) {
+    auto call = [&fn](ASTNode *child) {
+        if (child != nullptr) {
+            fn(child);
+        }
+    };
+    auto callAll = [&call](auto list) {
+        for (ASTNode *child : list) {
+            call(child);
+        }
+    };
+
+    using Kind = ASTNode::Kind;
+    switch (node->getKind()) {
+        case Kind::Binary: {
+            auto binary = cast<ASTBinaryNode>(node);
+            call(binary->getLeftOperrand());
+            call(binary->getRightOperrand());
+            break;
+        }
+        case Kind::Conditional: {
+            auto conditional = cast<ASTConditionalNode>(node);
+            call(conditional->getCond());
+            call(conditional->getThen());
+            call(conditional->getElse());
+            break;
+        }
+        case Kind::Range: {
+            auto range = cast<ASTRangeNode>(node);
+            call(range->getStart());
+            call(range->getStop());
+            break;
+        }
+        case Kind::FunctionCall:
+            call(cast<ASTFunctionCallNode>(node)->getCallee());
+            callAll(cast<ASTFunctionCallNode>(node)->getArgs());
+            break;
+        case Kind::MethodCall:
+            callAll(cast<ASTMethodCallNode>(node)->getArgs());
+            break;
+
+        case Kind::Export:
+            call(cast<ASTExportNode>(node)->getModule());
+            break;
+        case Kind::Initialization:
+            call(cast<ASTInitializationNode>(node)->getValue());
+            break;
+        case Kind::ArrayInitialization:
+            callAll(cast<ASTArrayInitializationNode>(node)->getValues());
+            break;
+        case Kind::Assignment:
+            call(cast<ASTAssignmentNode>(node)->getValue());
+            break;
+        case Kind::Return:
+            call(cast<ASTReturnNode>(node)->getExpr());
+            break;
+        case Kind::Block:
+            callAll(cast<ASTBlockNode>(node)->getNodes());
+            break;
+        case Kind::If: {
+            auto ifNode = cast<ASTIfNode>(node);
+            call(ifNode->getCond());
+            call(ifNode->getThen());
+            call(ifNode->getElse());
+            break;
+        }
+        case Kind::For: {
+            auto forNode = cast<ASTForNode>(node);
+            call(forNode->getDecl());
+            call(forNode->getCond());
+            call(forNode->getBlock());
+            break;
+        }
+        case Kind::FunctionDefinition:
+            callAll(cast<ASTFunctionDefinitionNode>(node)->getArgs());
+            call(cast<ASTFunctionDefinitionNode>(node)->getBody());
+            break;
+        case Kind::StructDefinition:
+            callAll(cast<ASTStructDefinitionNode>(node)->getAttributes());
+            callAll(cast<ASTStructDefinitionNode>(node)->getMethods());
+            break;
+        case Kind::StructInitialization:
+            call(cast<ASTStructInitializationNode>(node)->getStruct());
+            callAll(cast<ASTStructInitializationNode>(node)->getAttributesValues());
+            break;
+        case Kind::StructAssignment:
+            callAll(cast<ASTStructAssignmentNode>(node)->getAttributesValues());
+            break;
+        case Kind::AttributeAssignment:
+            call(cast<ASTAttributeAssignmentNode>(node)->getValue());
+            break;
+        case Kind::ArrayAssignment:
+            callAll(cast<ASTArrayAssignmentNode>(node)->getValues());
+            break;
+        case Kind::ArrayMemberAssignment:
+            call(cast<ASTArrayMemeberAssignmentNode>(node)->getValue());
+            break;
+
+        case Kind::Program:
+            for (ASTNode *child : *cast<ASTProgramNode>(node)) {
+                call(child);
+            }
+            break;
+
+        default:
+            // Literals, identifiers and the other leaves.
+            break;
+    }
+}
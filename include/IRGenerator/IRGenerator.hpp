@@ -16,15 +16,22 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 #include "IRGenerator/YAPLContext.hpp"
 #include "Parser/Parser.hpp"
+#include "AST/ASTCache.hpp"
+#include "AST/ASTFolder.hpp"
+#include "AST/ASTTypeChecker.hpp"
 #include "AST/ASTNode.hpp"
 #include "AST/ASTStatementNode.hpp"
 #include "AST/ASTExprNode.hpp"
+#include "AST/ASTVisitor.hpp"
 
-class IRGenerator {
+class IRGenerator : private ASTVisitor<IRGenerator, llvm::Value*> {
 private:
+    friend ASTVisitor<IRGenerator, llvm::Value*>;
+
     llvm::LLVMContext m_LLVMContext;
     llvm::IRBuilder<> m_Builder;
     std::unique_ptr<llvm::Module> m_Module;
@@ -34,12 +41,29 @@ private:
     std::unique_ptr<YAPLContext> m_YAPLContext;
     std::unique_ptr<ASTProgramNode> m_Program;
 
+    std::unique_ptr<llvm::MemoryBuffer> m_Source;
     std::unique_ptr<Parser> m_Parser;
 
+    // Set when the AST of the source is cached, m_Program is already loaded
+    // on a hit and m_Parser is null.
+    std::unique_ptr<ASTCache> m_Cache;
+    uint64_t m_CacheKey = 0;
+    // Source of a cached AST, only read again to locate its type errors.
+    std::unique_ptr<SourceBuffer> m_CachedSource;
+
+    // Every expression is checked, and annotated with its types, before it
+    // is generated.
+    ASTTypeChecker m_TypeChecker;
+    // Prints the errors of the type checker from the `first` one on.
+    void printTypeErrors(size_t first);
+
     llvm::Value *generate(ASTNode*);
     llvm::Value *generateExpr(ASTExprNode*);
     llvm::Value *generateBinary(ASTBinaryNode*);
+    llvm::Value *generateLogical(ASTBinaryNode*);
+    llvm::Value *generateConditional(ASTConditionalNode*);
     llvm::Value *generateLiteralInt(ASTLiteralNode<int>*);
+    llvm::Value *generateLiteralLong(ASTLiteralNode<int64_t>*);
     llvm::Value *generateLiteralDouble(ASTLiteralNode<double>*);
     llvm::Value *generateLiteralBool(ASTLiteralNode<bool>*);
     llvm::Value *generateIdentifier(ASTIdentifierNode*);
@@ -64,18 +88,59 @@ private:
     llvm::Value *generateIf(ASTIfNode*);
     llvm::Value *generateFor(ASTForNode*);
 
-    llvm::Value *generateMethod(llvm::StructType*, llvm::SmallVector<std::string, 10>, ASTFunctionDefinitionNode*);
+    // ASTVisitor hooks, generate() dispatches to these. Any other kind of node
+    // ends up in visitNode().
+    llvm::Value *visitNode(ASTNode*);
+    llvm::Value *visitBinary(ASTBinaryNode *node) { return generateBinary(node); }
+    llvm::Value *visitConditional(ASTConditionalNode *node) { return generateConditional(node); }
+    llvm::Value *visitLiteralInt(ASTLiteralNode<int> *node) { return generateLiteralInt(node); }
+    llvm::Value *visitLiteralLong(ASTLiteralNode<int64_t> *node) { return generateLiteralLong(node); }
+    llvm::Value *visitLiteralDouble(ASTLiteralNode<double> *node) { return generateLiteralDouble(node); }
+    llvm::Value *visitLiteralBool(ASTLiteralNode<bool> *node) { return generateLiteralBool(node); }
+    llvm::Value *visitIdentifier(ASTIdentifierNode *node) { return generateIdentifier(node); }
+    llvm::Value *visitAttributeAccess(ASTAttributeAccessNode *node) { return generateAttributeAccess(node); }
+    llvm::Value *visitMethodCall(ASTMethodCallNode *node) { return generateMethodCall(node); }
+    llvm::Value *visitArrayAccess(ASTArrayAccessNode *node) { return generateArrayAccess(node); }
+    llvm::Value *visitFunctionCall(ASTFunctionCallNode *node) { return generateFunctionCall(node); }
+    llvm::Value *visitDeclaration(ASTDeclarationNode *node) { return generateDeclaration(node); }
+    llvm::Value *visitAssignment(ASTAssignmentNode *node) { return generateAssignment(node); }
+    llvm::Value *visitReturn(ASTReturnNode *node) { return generateReturn(node); }
+    llvm::Value *visitFunctionDefinition(ASTFunctionDefinitionNode *node) { return generateFunctionDefinition(node); }
+    llvm::Value *visitStructDefinition(ASTStructDefinitionNode *node) { return generateStructDefinition(node); }
+    llvm::Value *visitStructInitialization(ASTStructInitializationNode *node) { return generateStructInitialization(node); }
+    llvm::Value *visitStructAssignment(ASTStructAssignmentNode *node) { return generateStructAssignment(node); }
+    llvm::Value *visitAttributeAssignment(ASTAttributeAssignmentNode *node) { return generateAttributeAssignment(node); }
+    llvm::Value *visitArrayAssignment(ASTArrayAssignmentNode *node) { return generateArrayAssignment(node); }
+    llvm::Value *visitArrayMemberAssignment(ASTArrayMemeberAssignmentNode *node) { return generateArrayMemberAssignment(node); }
+    llvm::Value *visitIf(ASTIfNode *node) { return generateIf(node); }
+    llvm::Value *visitFor(ASTForNode *node) { return generateFor(node); }
+
+    llvm::Value *generateMethod(llvm::StructType*, llvm::SmallVector<Symbol, 10>, ASTFunctionDefinitionNode*);
 
     llvm::Error m_DeferredErrors = llvm::Error::success();
 
     bool generateBlock(ASTBlockNode *);
 
+    // Lowers a condition to an i1: booleans are used as is, numbers are
+    // true when they are not zero, like ASTFolder folds them.
+    llvm::Value *generateCondition(ASTExprNode *cond);
+
+    // Weight of the expected side of a branch hinted likely or unlikely,
+    // against 1 for the other side.
+    static constexpr uint32_t s_LikelyWeight = 2000;
+
+    // Converts a numeric value of type `from` to `to`, as ASTTypeChecker
+    // allows it. The value is returned as is when the types are the same.
+    llvm::Value *convert(llvm::Value *value, ASTNode::TYPE from, ASTNode::TYPE to);
+
     static unsigned m_AnonCount;
 
     llvm::Type *ASTTypeToLLVM(ASTNode::TYPE type, const std::string &structName = "") {
         switch (type) {
             case ASTNode::TYPE::INT:
                 return llvm::Type::getInt32Ty(m_LLVMContext);
+            case ASTNode::TYPE::LONG:
+                return llvm::Type::getInt64Ty(m_LLVMContext);
             case ASTNode::TYPE::DOUBLE:
                 return llvm::Type::getDoubleTy(m_LLVMContext);
             case ASTNode::TYPE::BOOL:
@@ -90,10 +155,7 @@ private:
         }
     }
 
-public:
-    IRGenerator(llvm::StringRef filepath)
-    : m_Builder(m_LLVMContext), m_Logger(CppLogger::Level::Trace, "IR Generator")
-    {
+    void setupLogger() {
         CppLogger::Format format({
                 CppLogger::FormatAttribute::Name,
                 CppLogger::FormatAttribute::Level,
@@ -101,13 +163,55 @@ public:
                });
 
         m_Logger.setFormat(format);
+    }
+
+public:
+    // An empty `filepath` reads stdin, see Parser for `pipelined`.
+    // The AST of a file is looked up in, and saved to, `cacheDirectory` when
+    // it is not empty, see ASTCache.
+    IRGenerator(llvm::StringRef filepath, bool pipelined = false, llvm::StringRef cacheDirectory = "")
+    : m_Builder(m_LLVMContext), m_Logger(CppLogger::Level::Trace, "IR Generator")
+    {
+        setupLogger();
+
+        std::unique_ptr<SourceBuffer> source;
+        if (!cacheDirectory.empty() && !filepath.empty() && !pipelined) {
+            source = SourceBuffer::fromFile(filepath.str());
+        }
+        if (source != nullptr) {
+            m_Cache = std::make_unique<ASTCache>(cacheDirectory.str());
+            m_CacheKey = ASTCache::hashSource(source->getBuffer());
+            m_Program = m_Cache->load(m_CacheKey);
+            if (m_Program == nullptr) {
+                m_Parser = std::make_unique<Parser>(std::move(source), CppLogger::Level::Trace);
+            } else {
+                m_CachedSource = std::move(source);
+            }
+        } else {
+            m_Parser = std::make_unique<Parser>(filepath.str(), CppLogger::Level::Trace, pipelined);
+        }
+
+        m_YAPLContext = std::make_unique<YAPLContext>();
+    }
+
+    // Compiles an in-memory source, e.g. llvm::MemoryBuffer::getMemBuffer(code).
+    IRGenerator(std::unique_ptr<llvm::MemoryBuffer> source)
+    : m_Builder(m_LLVMContext), m_Logger(CppLogger::Level::Trace, "IR Generator"),
+      m_Source(std::move(source))
+    {
+        setupLogger();
 
-        m_Parser = std::make_unique<Parser>(filepath.str(), CppLogger::Level::Trace);
+        auto buffer = m_Source->getBuffer();
+        m_Parser = std::make_unique<Parser>(
+                SourceBuffer::fromMemory({buffer.data(), buffer.size()}),
+                CppLogger::Level::Trace);
 
         m_YAPLContext = std::make_unique<YAPLContext>();
     }
 
-    void generate();
+    // A streaming generation lowers every top-level node as soon as it is
+    // parsed and frees its AST before parsing the next one.
+    void generate(bool streaming = false);
 
     llvm::Module *getModule() const { return m_Module.get(); }
 };
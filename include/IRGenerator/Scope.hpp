@@ -1,9 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <system_error>
 #include <vector>
-#include <parallel_hashmap/phmap.h>
 
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Error.h"
@@ -11,8 +11,7 @@
 #include "llvm/IR/Value.h"
 #include "llvm/IR/Function.h"
 
-#include "IRGenerator/YAPLValue.hpp"
-#include "IRGenerator/YAPLFunction.hpp"
+#include "Support/StringInterner.hpp"
 
 class UndefindSymbolError : public llvm::ErrorInfo<UndefindSymbolError> {
 public:
@@ -46,36 +45,59 @@ public:
     }
 };
 
+// Every scope of the IR generation, as a single stack. A binding is a slot of
+// m_Values (or m_Functions) and m_InnermostValues[id] is the slot of the
+// innermost binding of the symbol `id`, plus one, or 0 when it has none:
+// symbols are dense interned ids, so a lookup is an index instead of a walk
+// of the enclosing scopes. A slot remembers the binding it shadows, which
+// popScope() puts back. Once the vectors have grown, pushing and popping a
+// scope allocates nothing.
 class Scope {
 private:
-    std::shared_ptr<Scope> m_ParentScope;
-    
-    std::vector<std::shared_ptr<Scope>> m_ImportedScopes;
+    struct Binding {
+        Symbol name;
+        llvm::Value *value;
+        uint32_t shadowed;
+    };
+    struct Frame {
+        uint32_t valueBase;
+        uint32_t functionBase;
+        llvm::Function *currentFunction;
+    };
+
+    std::vector<Binding> m_Values;
+    std::vector<Binding> m_Functions;
+    std::vector<uint32_t> m_InnermostValues;
+    std::vector<uint32_t> m_InnermostFunctions;
+    std::vector<Frame> m_Frames;
+
+    // Slot of the innermost binding of `name`, if it is not before `base`.
+    static bool find(const std::vector<uint32_t> &innermost, Symbol name, uint32_t base, uint32_t &slot);
+    static void bind(std::vector<Binding> &bindings, std::vector<uint32_t> &innermost, Symbol name,
+            llvm::Value *value);
+    static void unbind(std::vector<Binding> &bindings, std::vector<uint32_t> &innermost, uint32_t base);
 
-    llvm::Function *m_CurrentFunction;
-
-    phmap::parallel_node_hash_map<std::string, llvm::Value *> m_Values;
-    phmap::parallel_node_hash_map<std::string, llvm::Value *> m_ImportedValues;
-    phmap::parallel_node_hash_map<std::string, llvm::Function *> m_Functions;
 public:
-    Scope(std::shared_ptr<Scope> parentScope = nullptr)
-        : m_ParentScope(parentScope)
-    {}
-    static std::shared_ptr<Scope> Create(std::shared_ptr<Scope> parentScope) {
-        return std::make_shared<Scope>(parentScope);
-    }
+    // Starts with the top-level scope.
+    Scope();
 
-    std::shared_ptr<Scope> getParentScope() { return m_ParentScope; }
+    // A new scope is in the function of the enclosing one until
+    // setCurrentFunction() is called.
+    void pushScope();
+    void popScope();
+    [[nodiscard]] bool isAtTopLevel() const { return m_Frames.size() == 1; }
 
     void setCurrentFunction(llvm::Function *);
     llvm::Function *getCurrentFunction();
 
-    llvm::Expected<llvm::Value*> lookupScope(llvm::StringRef);
-    llvm::Expected<llvm::Function*> lookupFunctionScope(llvm::StringRef);
+    // Only in the innermost scope.
+    llvm::Expected<llvm::Value*> lookupScope(Symbol);
+    llvm::Expected<llvm::Function*> lookupFunctionScope(Symbol);
+
+    llvm::Expected<llvm::Value*> lookup(Symbol);
+    llvm::Expected<llvm::Function*> lookupFunction(Symbol);
 
-    llvm::Expected<llvm::Value*> lookup(llvm::StringRef);
-    llvm::Expected<llvm::Function*> lookupFunction(llvm::StringRef);
-    
-    llvm::Error pushValue(llvm::StringRef, llvm::Value *);
-    llvm::Error pushFunction(llvm::StringRef, llvm::Function *);
+    // Binds in the innermost scope.
+    llvm::Error pushValue(Symbol, llvm::Value *);
+    llvm::Error pushFunction(Symbol, llvm::Function *);
 };
@@ -13,17 +13,16 @@ struct ReturnHelper {
 
 class YAPLContext {
 private:
-    std::shared_ptr<Scope> m_CurrentScope;
+    Scope m_Scope;
     typedef phmap::flat_hash_map<std::string, YAPLStruct> structMap;
     structMap m_Structs;
     llvm::StringMap<uint32_t> m_AttributeOffset;
     ReturnHelper m_ReturnHelper;
 
 public:
-    YAPLContext() {
-        m_CurrentScope = Scope::Create(nullptr);
-    }
-    const std::shared_ptr<Scope> &getCurrentScope() const;
+    YAPLContext() = default;
+    // The scope stack, lookups start from its innermost scope.
+    Scope *getCurrentScope();
 
     void addStruct(YAPLStruct);
     YAPLStruct getStruct(llvm::StringRef);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Lexer/TokenUtils.hpp"
+#include <string_view>
+
+struct Keyword {
+    int token;
+    // Spelling stored in the token, types are normalized ("float" -> "double").
+    std::string_view spelling;
+};
+
+// Classifies an identifier with a switch on its length and first character,
+// so that at most two string comparisons are done per identifier.
+// Returns token::identifier when `str` is not a keyword.
+constexpr Keyword lookupKeyword(std::string_view str) {
+    constexpr Keyword notKeyword = {token::identifier, ""};
+
+    switch (str.size()) {
+        case 2:
+            if (str == "if") return {token::iflabel, ""};
+            if (str == "in") return {token::inlabel, ""};
+            break;
+        case 3:
+            switch (str[0]) {
+                case 'i': if (str == "int") return {token::type, "int"}; break;
+                case 'f': if (str == "for") return {token::forlabel, ""}; break;
+            }
+            break;
+        case 4:
+            switch (str[0]) {
+                case 'v': if (str == "void") return {token::type, "void"}; break;
+                case 'b': if (str == "bool") return {token::type, "bool"}; break;
+                case 'c': if (str == "cold") return {token::coldlabel, ""}; break;
+                case 'l': if (str == "long") return {token::type, "long"}; break;
+                case 'f': if (str == "func") return {token::func, ""}; break;
+                case 'e': if (str == "else") return {token::elselabel, ""}; break;
+                case 't': if (str == "true") return {token::truelabel, ""}; break;
+            }
+            break;
+        case 5:
+            switch (str[0]) {
+                case 'f':
+                    if (str == "float") return {token::type, "double"};
+                    if (str == "false") return {token::falselabel, ""};
+                    break;
+                case 'w': if (str == "while") return {token::whilelabel, ""}; break;
+            }
+            break;
+        case 6:
+            switch (str[0]) {
+                case 'd': if (str == "double") return {token::type, "double"}; break;
+                case 's':
+                    if (str == "string") return {token::type, "string"};
+                    if (str == "struct") return {token::structlabel, ""};
+                    break;
+                case 'i': if (str == "import") return {token::importlabel, ""}; break;
+                case 'e': if (str == "export") return {token::exportlalbel, ""}; break;
+                case 'r': if (str == "return") return {token::returnlabel, ""}; break;
+                case 'l': if (str == "likely") return {token::likelylabel, ""}; break;
+            }
+            break;
+        case 8:
+            if (str == "unlikely") return {token::unlikelylabel, ""};
+            break;
+    }
+
+    return notKeyword;
+}
+
+static_assert(lookupKeyword("struct").token == token::structlabel);
+static_assert(lookupKeyword("float").spelling == "double");
+static_assert(lookupKeyword("structs").token == token::identifier);
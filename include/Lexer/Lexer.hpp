@@ -1,24 +1,33 @@
 #pragma once
 
+#include "Lexer/SourceBuffer.hpp"
+#include "Lexer/SourceManager.hpp"
 #include "Lexer/TokenUtils.hpp"
+#include "Support/StringInterner.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <memory>
 #include <ostream>
 #include <string>
-#include <cstdio>
+#include <string_view>
+#include <vector>
 
 #include <CppLogger2/CppLogger2.h>
 
-struct Position {
-    uint32_t line;
-    uint32_t column;
-    uint32_t character;
-
-    friend std::ostream& operator<<(std::ostream& os, const Position& token);
-};
-
 struct Token{
     int token;
-    std::string identifier;
-    Position pos;
+    // Slice of the lexer's source buffer (or a static keyword spelling), only
+    // valid while the Lexer that produced it is alive.
+    std::string_view identifier;
+    // Offset of the first character of the token, see SourceManager.
+    uint32_t offset;
+    // Interned spelling of identifiers.
+    Symbol symbol;
+    // Value of int_value and float_value tokens, parsed once by the lexer.
+    union {
+        int64_t intValue = 0;
+        double floatValue;
+    };
 
     friend std::ostream& operator<<(std::ostream& os, const Token& token);
     bool operator!=(int tok){
@@ -39,20 +48,73 @@ class Lexer
 private:
     Token m_CurrentToken = {token::unknown, ""};
     int m_CurrentChar = '\0';
-    std::string m_CurrentIdentifier = "";
     CppLogger::CppLogger m_Logger;
-    Position m_Pos;
 
-    FILE* pFile;
+    std::unique_ptr<SourceBuffer> m_OwnedBuffer;
+    const SourceBuffer *m_Buffer = nullptr;
+    std::unique_ptr<SourceManager> m_SourceManager;
+    // Part of the buffer being lexed, the whole buffer unless the lexer
+    // handles one chunk of it.
+    const char *m_RangeBegin = nullptr;
+    const char *m_RangeEnd = nullptr;
+    const char *m_CurPtr = nullptr;
+    const char *m_TokenStart = nullptr;
+
+    void setupLogger();
+    void setOwnedBuffer(std::unique_ptr<SourceBuffer> buffer);
+    // Moves the current character to `ptr`, at most the end of the buffer.
+    void skipTo(const char *ptr);
+    [[nodiscard]] uint32_t getTokenOffset() const { return m_TokenStart - m_Buffer->begin(); }
+    [[nodiscard]] std::string_view sliceFrom(const char *start) const {
+        return {start, (size_t)(m_CurPtr - start)};
+    }
+    // Unknown tokens also report the offending (not consumed) character.
+    [[nodiscard]] std::string_view sliceUnknown(const char *start) const {
+        return {start, (size_t)(m_CurPtr - start) + (m_CurrentChar != EOF)};
+    }
+    // Lexes a decimal, hexadecimal (0x) or binary (0b) literal, the current
+    // character is its first digit and `start` may point to a leading '-'.
+    Token lexNumber(const char *start);
 
 public:
     Lexer(const std::string& filepath="");
     Lexer(FILE* file);
-    ~Lexer();
+    Lexer(std::unique_ptr<SourceBuffer> buffer);
+    // Lexes the [begin, end) range of a buffer owned by the caller, token
+    // offsets stay relative to the start of `buffer`.
+    Lexer(const SourceBuffer &buffer, uint32_t begin, uint32_t end);
+    ~Lexer() = default;
+
+    // Lexes `source` in place, it must outlive the returned Lexer.
+    [[nodiscard]] static Lexer fromSource(std::string_view source) {
+        return Lexer(SourceBuffer::fromMemory(source));
+    }
+
+    // Splits `source` in at most `chunkCount` ranges of similar size that
+    // can be lexed independently: every boundary is just after a newline that
+    // is not inside a block comment, so no token or comment spans two chunks.
+    // Returns the offsets of the boundaries, starting with 0 and ending with
+    // the size of the source.
+    [[nodiscard]] static std::vector<uint32_t> findChunkBoundaries(const SourceBuffer &source, size_t chunkCount);
+    // Last offset in [begin, end] that is such a boundary, or `begin` if there
+    // is none yet. `begin` must not be inside of a comment.
+    [[nodiscard]] static uint32_t findLastBoundary(const SourceBuffer &source, uint32_t begin, uint32_t end);
+    // Whether [begin, end) does not end inside of a comment, i.e. a lexer of
+    // the range stops where one of the whole source would. `begin` must not
+    // be inside of a comment.
+    [[nodiscard]] static bool endsOutsideComments(const SourceBuffer &source, uint32_t begin, uint32_t end);
 
     Token peekToken();
     [[nodiscard]] Token getNextToken();
     int getNextChar();
-    [[nodiscard]] const Position getCurrentPos() const { return m_Pos; }
+    [[nodiscard]] const SourceBuffer &getSource() const { return *m_Buffer; }
+    // Null unless the lexer owns its buffer, e.g. to keep reading a stream.
+    [[nodiscard]] SourceBuffer *getOwnedSource() { return m_OwnedBuffer.get(); }
+    [[nodiscard]] std::string_view getRange() const {
+        return {m_RangeBegin, (size_t)(m_RangeEnd - m_RangeBegin)};
+    }
+    [[nodiscard]] SourceManager &getSourceManager();
+    // Starts over on `buffer`, e.g. the source after an edit.
+    void setSource(std::unique_ptr<SourceBuffer> buffer);
 };
 
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+// Vectorized scanning kernels used by the Lexer.
+// Every function looks at [ptr, end) only, never reads past `end` and
+// returns `end` when nothing stops the scan. The implementation (AVX2, SSE2
+// or scalar) is picked once at runtime from the CPU features.
+namespace scan {
+    // First character that is not a C locale space (' ', '\t' ... '\r').
+    const char *skipWhitespace(const char *ptr, const char *end);
+    // First character that is not [A-Za-z0-9_].
+    const char *skipIdentifier(const char *ptr, const char *end);
+    // First character that is not [0-9].
+    const char *skipDigits(const char *ptr, const char *end);
+    // First '\n'.
+    const char *findLineEnd(const char *ptr, const char *end);
+    // The '*' of the first "*/".
+    const char *findBlockCommentEnd(const char *ptr, const char *end);
+    // Number of '\n' in [ptr, end).
+    size_t countNewlines(const char *ptr, const char *end);
+
+    // Name of the selected implementation, for diagnostics and benchmarks.
+    const char *getImplementationName();
+}
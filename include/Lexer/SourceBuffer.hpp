@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Contiguous, read-only view over a whole source file.
+// Files are memory mapped when possible, streams (stdin) are read block by
+// block into an owned string, and in-memory sources are either copied or
+// borrowed as is. Owned and mapped buffers are followed by a '\0' sentinel.
+// Incremental stream buffers grow as readBlock() is called, in place, so that
+// the beginning of a stream can be lexed while the rest is still produced.
+// Offsets into a source are 32 bits, every factory returns null for a larger
+// source rather than let them wrap.
+class SourceBuffer {
+private:
+    const char *m_BufferStart = nullptr;
+    const char *m_BufferEnd = nullptr;
+
+    std::string m_OwnedBuffer;
+    void *m_Mapping = nullptr;
+    size_t m_MappingSize = 0;
+    // Stream still being read into the mapping by readBlock().
+    FILE *m_Stream = nullptr;
+
+    SourceBuffer() = default;
+    void setOwnedBuffer(std::string buffer);
+
+public:
+    static constexpr size_t s_MaxSize = UINT32_MAX;
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+    ~SourceBuffer();
+
+    // Sets errno to EFBIG when the file is too large.
+    [[nodiscard]] static std::unique_ptr<SourceBuffer> fromFile(const std::string &filepath);
+    [[nodiscard]] static std::unique_ptr<SourceBuffer> fromStream(FILE *file);
+    [[nodiscard]] static std::unique_ptr<SourceBuffer> fromString(std::string source);
+    // Borrows `source` without copying it, the caller keeps it alive.
+    [[nodiscard]] static std::unique_ptr<SourceBuffer> fromMemory(std::string_view source);
+    // Starts empty, the content of `file` is appended by readBlock(). The
+    // buffer reserves (without committing) 4 GiB of address space, the most
+    // that 32-bit offsets can address, so it never moves. readBlock() exits
+    // the process on a stream longer than s_MaxSize bytes.
+    [[nodiscard]] static std::unique_ptr<SourceBuffer> forStream(FILE *file);
+
+    // Appends whatever the stream has available (at most one block), waiting
+    // for it if needed. Returns false once the stream is exhausted.
+    // Only the thread calling readBlock() may look past the bytes it already
+    // handed over to other threads.
+    bool readBlock();
+    [[nodiscard]] bool isIncremental() const { return m_Stream != nullptr; }
+
+    [[nodiscard]] const char *begin() const { return m_BufferStart; }
+    [[nodiscard]] const char *end() const { return m_BufferEnd; }
+    [[nodiscard]] size_t size() const { return m_BufferEnd - m_BufferStart; }
+    [[nodiscard]] std::string_view getBuffer() const { return {m_BufferStart, size()}; }
+    [[nodiscard]] bool isMapped() const { return m_Mapping != nullptr; }
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Lexer/SourceBuffer.hpp"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// 1-based line and column of a source offset.
+struct SourceLocation {
+    uint32_t line;
+    uint32_t column;
+
+    friend std::ostream& operator<<(std::ostream& os, const SourceLocation& location);
+};
+
+// Maps the 32-bit offsets stored in tokens and AST nodes back to lines and
+// columns. The line table is built lazily, only up to the offsets that are
+// queried, which normally means a diagnostic is about to be printed. It never
+// reads past them either, so it works on a buffer that is still growing.
+class SourceManager {
+private:
+    const SourceBuffer &m_Buffer;
+    // Offset of the first character of every line before m_ScannedUpTo.
+    std::vector<uint32_t> m_LineStarts = {0};
+    uint32_t m_ScannedUpTo = 0;
+
+    void extendLineTable(uint32_t offset);
+
+public:
+    explicit SourceManager(const SourceBuffer &buffer)
+        : m_Buffer(buffer)
+    {}
+
+    [[nodiscard]] SourceLocation getLocation(uint32_t offset);
+};
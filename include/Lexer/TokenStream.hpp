@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Lexer/Lexer.hpp"
+#include "Support/StringInterner.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Whole source lexed up front into a packed structure of arrays.
+// Each token is an 8-bit kind, the 32-bit offset of its first character and
+// a 32-bit payload:
+//  - identifier, type: id of the interned spelling (Symbol)
+//  - int_value, float_value: index in the literal table
+//  - unknown: length of the spelling in the source
+//  - anything else: unused
+// The stream always ends with a token::eof, reading past the end keeps
+// returning it so that any lookahead is safe.
+// A pipelined stream is filled by a lexer thread while it is being read,
+// require() must be called before reading a token that may not be there yet.
+class TokenStream {
+private:
+    class Pipeline;
+
+    // Value parsed by the lexer, the spelling is kept for diagnostics.
+    struct Literal {
+        union {
+            int64_t intValue;
+            double floatValue;
+        };
+        uint32_t length;
+    };
+
+    const char *m_Source;
+
+    std::vector<int8_t> m_Kinds;
+    std::vector<uint32_t> m_Offsets;
+    std::vector<uint32_t> m_Payloads;
+    std::vector<Literal> m_Literals;
+
+    // Only set while a lexer thread is still producing tokens.
+    std::unique_ptr<Pipeline> m_Pipeline;
+
+    explicit TokenStream(const char *source);
+
+    void push(const Token &tok);
+    // Appends the tokens of `other`, but its eof unless `withEof`.
+    void append(const TokenStream &other, bool withEof);
+    // Waits for batches of tokens until `index` is available or the end of
+    // the stream is reached.
+    void receive(size_t index);
+
+    [[nodiscard]] const Literal &getLiteral(size_t index) const;
+
+    [[nodiscard]] size_t clamp(size_t index) const {
+        return index < m_Kinds.size() ? index : m_Kinds.size() - 1;
+    }
+
+public:
+    // Sources smaller than this are not worth starting threads for.
+    static constexpr size_t ParallelThreshold = 1 << 20;
+
+    // Lexes until EOF, `lexer` must outlive the stream.
+    explicit TokenStream(Lexer &lexer);
+    // Splits `source` in chunks lexed on `threadCount` threads and stitches
+    // the results, which are the same as with a single Lexer. `source` must
+    // outlive the stream.
+    TokenStream(const SourceBuffer &source, unsigned threadCount);
+
+    // Picks one of the above depending on the size of the source and on the
+    // number of cores.
+    [[nodiscard]] static TokenStream tokenize(Lexer &lexer);
+    // Lexes on a separate thread that sends tokens in batches while they are
+    // parsed. When the lexer owns an incremental stream buffer (e.g. stdin)
+    // the stream is also read on that thread, as it is produced.
+    [[nodiscard]] static TokenStream pipeline(Lexer &lexer);
+
+    TokenStream(TokenStream &&) noexcept;
+    TokenStream &operator=(TokenStream &&) noexcept;
+    ~TokenStream();
+
+    void require(size_t index) {
+        if (m_Pipeline && index >= m_Kinds.size()) {
+            receive(index);
+        }
+    }
+
+    [[nodiscard]] size_t size() const { return m_Kinds.size(); }
+    // Whether every token is available, which is only false while a
+    // pipelined stream is still being lexed.
+    [[nodiscard]] bool isComplete() const { return !m_Pipeline; }
+
+    [[nodiscard]] int getKind(size_t index) const { return m_Kinds[clamp(index)]; }
+    [[nodiscard]] uint32_t getOffset(size_t index) const { return m_Offsets[clamp(index)]; }
+    [[nodiscard]] Symbol getSymbol(size_t index) const;
+    [[nodiscard]] std::string_view getSpelling(size_t index) const;
+    // Values of int_value and float_value tokens, 0 for any other token.
+    [[nodiscard]] int64_t getIntValue(size_t index) const;
+    [[nodiscard]] double getFloatValue(size_t index) const;
+    // Replaces the tokens in [begin, end) by the ones of `tokens`, but its
+    // eof, after an edit of the source that moved the following tokens by
+    // `delta` bytes. `source` is the edited source. The literals of the
+    // replaced tokens are left unused in the table.
+    void splice(size_t begin, size_t end, const TokenStream &tokens, int64_t delta, const char *source);
+
+    // Unpacks a token, for diagnostics.
+    [[nodiscard]] Token getToken(size_t index) const;
+};
@@ -106,6 +106,18 @@ inline std::string tokenToString(int token){
             return "arrow_op";
         case -51:
             return "returnlabel";
+        case -52:
+            return "likelylabel";
+        case -53:
+            return "unlikelylabel";
+        case -54:
+            return "coldlabel";
+        case -55:
+            return "andandsym";
+        case -56:
+            return "ororsym";
+        case -57:
+            return "question";
         default:
             return std::string(1, (char)token);
     }
@@ -175,6 +187,14 @@ enum token{
 
   returnlabel = -51,
 
+  likelylabel   = -52,
+  unlikelylabel = -53,
+  coldlabel     = -54,
+
+  andandsym    = -55,
+  ororsym      = -56,
+  question     = -57,
+
   unknown      =-100
 };
 
@@ -2,31 +2,99 @@
 #include "AST/ASTNode.hpp"
 #include "AST/ASTStatementNode.hpp"
 #include "Lexer/Lexer.hpp"
+#include "Lexer/TokenStream.hpp"
 #include <CppLogger2/CppLogger2.h>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <type_traits>
-#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <parallel_hashmap/phmap.h>
 
 class Parser {
 private:
     CppLogger::CppLogger m_Logger;
     Lexer m_Lexer;
+    TokenStream m_OwnedTokens;
+    // m_OwnedTokens, or the tokens of the parent of a parallel parse.
+    TokenStream &m_Tokens;
+    size_t m_Cursor = 0;
 
     std::unique_ptr<ASTProgramNode> m_Program;
+    // First token of every node of m_Program, see applyEdit().
+    std::vector<size_t> m_NodeTokens;
+    // Arena bytes of every node of m_Program, and those of the nodes that
+    // applyEdit() replaced or of statements that had a syntax error, which
+    // stay in the arena until the next full parse.
+    std::vector<size_t> m_NodeBytes;
+    size_t m_DeadBytes = 0;
 
-    Token m_CurrentToken;
+    phmap::flat_hash_set<Symbol> m_StructNames;
 
-    std::unordered_set<std::string> m_StructNames;
+    // Set on the parsers of a parallel parse, which print nothing: when they
+    // have something to report the whole range is parsed again sequentially,
+    // so that diagnostics are printed once and in order.
+    bool m_Deferred = false;
+    bool m_HasDiagnostics = false;
+    size_t m_ErrorCount = 0;
+    // Token at which each diagnostic was found, in order, so that
+    // applyEdit() can drop those of the region it parses again.
+    struct Diagnostic {
+        size_t token;
+        bool isError;
+    };
+    std::vector<Diagnostic> m_Diagnostics;
+    // Set by the first syntax error of a statement, nothing else is reported
+    // until synchronize() skipped the rest of it.
+    bool m_Panicking = false;
+
+    // Parses the tokens of `parent` from `begin`, see parseParallel().
+    Parser(Parser &parent, size_t begin);
+
+    // Records a diagnostic at the cursor, returns whether it can be printed
+    // now, see m_Deferred.
+    bool canReport(bool isError=false) {
+        m_Diagnostics.push_back({m_Cursor, isError});
+        m_HasDiagnostics = true;
+        m_ErrorCount += isError;
+        return !m_Deferred;
+    }
 
     template<typename Ptr, typename... T>
-    std::unique_ptr<Ptr> parseError(std::string msg, T... var) {
-        m_Logger.printError(msg, var...);
+    Ptr *parseError(std::string msg, T... var) {
+        if (m_Panicking) {
+            return nullptr;
+        }
+        m_Panicking = true;
+        if (canReport(true)) {
+            m_Logger.printError("{}: " + msg, m_Lexer.getSourceManager().getLocation(currentOffset()), var...);
+        }
         return nullptr;
     }
 
+    // Every node but the program lives in the program's arena.
+    template<typename Node, typename... Args>
+    Node *create(Args&&... args) {
+        return m_Program->getContext().create<Node>(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    ASTList<T> createList(const std::vector<T> &values) {
+        return m_Program->getContext().createList(values);
+    }
+
+    template<typename Node>
+    Node *setLocation(Node *node, uint32_t offset) {
+        if (node) {
+            node->setOffset(offset);
+        }
+        return node;
+    }
+
+    void setupLogger();
     void parseInfo(std::string);
     template<typename... T>
     void logParser(std::string msg, T... var) {
@@ -35,74 +103,186 @@ private:
 #endif
     }
 
+    // Lower binds tighter.
     int getOpPrecedence(Operator t_Operator);
+    static bool toBinaryOperator(int kind, Operator &t_Operator);
+
+    // Operands and operators waiting for their right hand side in parseExpr(),
+    // an operator is either a binary operator or an open parenthesis.
+    struct PendingOperand {
+        ASTExprNode *node;
+        uint32_t offset;
+    };
+    struct PendingOperator {
+        Operator op;
+        bool isParen;
+        uint32_t offset;
+    };
+    std::vector<PendingOperand> m_Operands;
+    std::vector<PendingOperator> m_Operators;
+
+    // Pops an operator and its two operands and pushes the binary node.
+    void reduceOperator();
+    // Parses the `? then : else` that follows the operand on top of the
+    // stack, whose condition is everything since the innermost open
+    // parenthesis. The else operand extends as far as possible, so a
+    // conditional binds looser than any binary operator and nests to the
+    // right. Returns false on a syntax error.
+    bool parseConditional(size_t operatorBase);
+
+    // Sources with fewer tokens are not worth starting threads for.
+    static constexpr size_t s_ParallelThreshold = 1 << 16;
+
+    // Top-level declarations found by matching braces, without parsing.
+    struct DeclarationScan {
+        // First token of the functions, structs and exports that follow a
+        // closing brace, a parallel parse can start a range on them.
+        std::vector<size_t> starts;
+        // Structs defined at the top level, with the index of their keyword.
+        std::vector<std::pair<size_t, Symbol>> structs;
+    };
+    [[nodiscard]] DeclarationScan scanDeclarations() const;
+
+    // Parses the top-level node at the cursor into m_Program, unless it had
+    // a syntax error.
+    void parseTopLevel();
+    // Panic mode recovery, skips what is left of a statement that had a
+    // syntax error. See parseStatement().
+    void synchronize(bool topLevel);
+
+    // Tokenizes and parses the whole source again, after an edit that
+    // cannot be reparsed incrementally.
+    void reparseAll();
+    // Edits are not worth a full parse to free the arena before this much
+    // of it is dead.
+    static constexpr size_t s_MinDeadBytes = 1 << 20;
+
+    // Token kinds are negative, a statement parser is looked up at -kind.
+    static constexpr size_t s_TokenKinds = 128;
+    using StatementParser = ASTNode *(Parser::*)();
+    static const std::array<StatementParser, s_TokenKinds> s_StatementParsers;
+
+    template<auto Method>
+    ASTNode *parseAs() { return (this->*Method)(); }
+
+    // Token stream cursor, peek(k) looks k tokens ahead of the current one,
+    // with k at most s_MaxLookahead.
+    static constexpr size_t s_MaxLookahead = 2;
+    void nextToken() {
+        m_Cursor++;
+        m_Tokens.require(m_Cursor + s_MaxLookahead);
+    }
+    [[nodiscard]] int peek(size_t k = 0) const { return m_Tokens.getKind(m_Cursor + k); }
+    [[nodiscard]] uint32_t currentOffset() const { return m_Tokens.getOffset(m_Cursor); }
+    [[nodiscard]] std::string_view currentSpelling() const { return m_Tokens.getSpelling(m_Cursor); }
+    [[nodiscard]] Symbol currentSymbol() const { return m_Tokens.getSymbol(m_Cursor); }
+    [[nodiscard]] Token currentToken() const { return m_Tokens.getToken(m_Cursor); }
 public:
-    Parser(std::string file="", CppLogger::Level level=CppLogger::Level::Warn);
-    std::unique_ptr<ASTNode> parseNext();
+    // A pipelined parser lexes on a separate thread while it parses, stdin
+    // (empty `file`) is then also read as it is being parsed.
+    Parser(std::string file="", CppLogger::Level level=CppLogger::Level::Warn, bool pipelined=false);
+    Parser(std::unique_ptr<SourceBuffer> source, CppLogger::Level level=CppLogger::Level::Warn, bool pipelined=false);
+    ASTNode *parseNext();
+    // Parses everything left, in parallel when there are enough tokens.
     void parse();
+    // Parses the top-level declarations left on up to `threadCount` threads.
+    // The result is the same as with a sequential parse, which is what
+    // happens when it returns false: if the tokens cannot be split or a
+    // diagnostic must be printed. Nothing is consumed in that case.
+    bool parseParallel(unsigned threadCount);
+    // Whether an error or a warning was printed, the AST is incomplete.
+    [[nodiscard]] bool hasDiagnostics() const { return m_HasDiagnostics; }
+    // Syntax errors printed so far. The parser recovers from each of them at
+    // the next statement or declaration, which is left out of the AST.
+    [[nodiscard]] size_t getErrorCount() const { return m_ErrorCount; }
     std::unique_ptr<ASTProgramNode> getProgram();
+    // The program parsed so far, still owned by the parser.
+    [[nodiscard]] ASTProgramNode &getParsedProgram() { return *m_Program; }
+    // Location of a node offset, for the diagnostics of later passes.
+    [[nodiscard]] SourceLocation getLocation(uint32_t offset) { return m_Lexer.getSourceManager().getLocation(offset); }
+
+    // Replaces `removed` bytes at `offset` in the source of a parsed program
+    // by `inserted`, for editors and watch modes. Only the top-level nodes
+    // around the edit are lexed and parsed again, the others are kept and
+    // the offsets after the edit are moved. When the edit cannot be
+    // contained, e.g. it opens a comment or changes the structs declared
+    // before kept nodes, the whole new source is parsed and false returned.
+    // So is it once the replaced nodes take more memory than the others, to
+    // free them.
+    // False is also returned, with nothing changed, if the new source would
+    // be larger than SourceBuffer::s_MaxSize.
+    bool applyEdit(uint32_t offset, uint32_t removed, std::string_view inserted);
+
+    // Streaming, parseNext() one top-level node at a time until atEnd() and
+    // releaseNodes() once a node has been used, so that only one of them is
+    // in memory at a time.
+    [[nodiscard]] bool atEnd() const { return peek() == token::eof; }
+    // Frees every node parsed so far, none of them can be used after.
+    void releaseNodes() { m_Program->getContext().reset(); }
 
 private:
-    std::unique_ptr<ASTNode> parseNextBlock();
-    std::unique_ptr<ASTStatementNode> parseStatement();
-    std::unique_ptr<ASTExprNode> parseExpr();
-    std::unique_ptr<ASTNode> parseLabel(std::string indentifier);
-    std::unique_ptr<ASTExprNode> parseLabelExpr();
-    std::unique_ptr<ASTExprNode> parseParenExpr();
-    std::unique_ptr<ASTNode> parseArrayAccessNode(std::string);
-    std::unique_ptr<ASTNode> parseAttributeAccessNode(std::string);
+    ASTNode *parseNextBlock();
+    ASTNode *parseStatement(bool topLevel);
+    ASTNode *parseLabelStatement();
+    ASTExprNode *parseExpr();
+    ASTExprNode *parsePrimary();
+    ASTNode *parseLabel(Symbol indentifier);
+    ASTExprNode *parseLabelExpr();
+    ASTNode *parseArrayAccessNode(Symbol);
+    ASTNode *parseAttributeAccessNode(Symbol);
 
     // Statement parsing
-    std::unique_ptr<ASTImportNode> parseImport();
-    std::unique_ptr<ASTExportNode> parseExport();
-    std::unique_ptr<ASTDeclarationNode> parseDeclaration();
-    std::unique_ptr<ASTInitializationNode> parseInitialization(std::string name, ASTNode::TYPE type);
-    std::unique_ptr<ASTAssignmentNode> parseAssignment(std::string);
-    std::unique_ptr<ASTReturnNode> parseReturn();
-    std::unique_ptr<ASTBlockNode> parseBlock();
-    std::unique_ptr<ASTIfNode> parseIf();
-    std::unique_ptr<ASTForNode> parseFor();
-    std::unique_ptr<ASTFunctionDefinitionNode> parseFunctionDefinition();
-    std::unique_ptr<ASTStructDefinitionNode> parseStructDefintion();
-    std::unique_ptr<ASTStructInitializationNode> parseStructInitialization(std::unique_ptr<ASTIdentifierNode>);
-    std::unique_ptr<ASTStructAssignmentNode> parseStructAssignement(std::string);
-    std::unique_ptr<ASTAttributeAssignmentNode> parseAttributeAssignment(std::string, std::string);
-    std::unique_ptr<ASTArrayDefinitionNode> parseArrayDefinition(ASTNode::TYPE, std::string);
-    std::unique_ptr<ASTArrayInitializationNode> parseArrayInitialization(ASTNode::TYPE, std::string, size_t);
-    std::unique_ptr<ASTArrayAssignmentNode> parseArrayAssignment(std::string);
-    std::unique_ptr<ASTArrayMemeberAssignmentNode> parseArrayMemberAssignment(std::string, size_t);
+    ASTImportNode *parseImport();
+    ASTExportNode *parseExport();
+    ASTDeclarationNode *parseDeclaration();
+    ASTInitializationNode *parseInitialization(Symbol name, ASTNode::TYPE type);
+    ASTAssignmentNode *parseAssignment(Symbol);
+    ASTReturnNode *parseReturn();
+    ASTBlockNode *parseBlock();
+    ASTIfNode *parseIf();
+    ASTForNode *parseFor();
+    ASTFunctionDefinitionNode *parseFunctionDefinition();
+    ASTStructDefinitionNode *parseStructDefintion();
+    ASTStructInitializationNode *parseStructInitialization(ASTIdentifierNode*);
+    ASTStructAssignmentNode *parseStructAssignement(Symbol);
+    ASTAttributeAssignmentNode *parseAttributeAssignment(Symbol, Symbol);
+    ASTArrayDefinitionNode *parseArrayDefinition(ASTNode::TYPE, Symbol);
+    ASTArrayInitializationNode *parseArrayInitialization(ASTNode::TYPE, Symbol, size_t);
+    ASTArrayAssignmentNode *parseArrayAssignment(Symbol);
+    ASTArrayMemeberAssignmentNode *parseArrayMemberAssignment(Symbol, size_t);
 
     // Expression parsing
-    std::unique_ptr<ASTBinaryNode> parseBinary(std::unique_ptr<ASTExprNode>);
-    std::unique_ptr<ASTIdentifierNode> parseIdentifier(std::string);
-    std::unique_ptr<ASTNamespaceIdentifierNode> parseNamespaceIdentifier(std::string);
-    std::unique_ptr<ASTFunctionCallNode> parseFunctionCall(std::unique_ptr<ASTIdentifierNode>);
-    std::unique_ptr<ASTMethodCallNode> parseMethodCall(std::string, std::string);
-    std::unique_ptr<ASTAttributeAccessNode> parseAttributeAccess(std::string);
-    std::unique_ptr<ASTRangeNode> parseRange(std::unique_ptr<ASTExprNode>);
-    std::unique_ptr<ASTExprNode> parseArrayAccess(std::string);
+    ASTIdentifierNode *parseIdentifier(Symbol);
+    ASTNamespaceIdentifierNode *parseNamespaceIdentifier(Symbol);
+    ASTFunctionCallNode *parseFunctionCall(ASTIdentifierNode*);
+    ASTMethodCallNode *parseMethodCall(Symbol, Symbol);
+    ASTAttributeAccessNode *parseAttributeAccess(Symbol);
+    ASTRangeNode *parseRange(ASTExprNode*);
+    ASTExprNode *parseArrayAccess(Symbol);
+    ASTExprNode *parseIntLiteral();
 
     // Templated parsing
     template<typename T>
-    std::unique_ptr<ASTLiteralNode<T>> parseLiteral();
-    template<> std::unique_ptr<ASTLiteralNode<int>> parseLiteral<int>() {
-        int literal = std::stoi(m_CurrentToken.identifier);
-
-        return std::make_unique<ASTLiteralNode<int>>(literal);
+    ASTLiteralNode<T> *parseLiteral();
+    template<> ASTLiteralNode<int> *parseLiteral<int>() {
+        return create<ASTLiteralNode<int>>((int)m_Tokens.getIntValue(m_Cursor));
     }
-    template<> std::unique_ptr<ASTLiteralNode<double>> parseLiteral<double>() {
-        double literal = std::stod(m_CurrentToken.identifier);
-
-        return std::make_unique<ASTLiteralNode<double>>(literal);
+    template<> ASTLiteralNode<int64_t> *parseLiteral<int64_t>() {
+        return create<ASTLiteralNode<int64_t>>(m_Tokens.getIntValue(m_Cursor));
+    }
+    template<> ASTLiteralNode<double> *parseLiteral<double>() {
+        return create<ASTLiteralNode<double>>(m_Tokens.getFloatValue(m_Cursor));
     }
-    template<> std::unique_ptr<ASTLiteralNode<bool>> parseLiteral<bool>() {
-        if (m_CurrentToken == token::truelabel) {
-            return std::make_unique<ASTLiteralNode<bool>>(true);
+    template<> ASTLiteralNode<bool> *parseLiteral<bool>() {
+        if (peek() == token::truelabel) {
+            return create<ASTLiteralNode<bool>>(true);
         }
-        return std::make_unique<ASTLiteralNode<bool>>(false);
+        return create<ASTLiteralNode<bool>>(false);
     }
-    template<> std::unique_ptr<ASTLiteralNode<std::string>> parseLiteral<std::string>() {
-        m_Logger.printWarn("String are not implemented yet, please do use them");
+    template<> ASTLiteralNode<std::string_view> *parseLiteral<std::string_view>() {
+        if (canReport()) {
+            m_Logger.printWarn("String are not implemented yet, please do use them");
+        }
         return nullptr;
     }
 };
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cassert>
+#include <type_traits>
+
+// LLVM style RTTI for class hierarchies that tag their objects with a kind:
+// `To::classof(const Base *)` tells whether an object is a `To`, which is a
+// comparison of the kind instead of a walk of the class hierarchy.
+
+template<typename To, typename From>
+[[nodiscard]] inline bool isa(const From *value) {
+    assert(value != nullptr && "isa<> on a null pointer");
+    if constexpr (std::is_base_of_v<To, From>) {
+        return true;
+    } else {
+        return To::classof(value);
+    }
+}
+
+template<typename To, typename From>
+[[nodiscard]] inline auto cast(From *value) {
+    assert(isa<To>(value) && "cast<> to the wrong type");
+    using Result = std::conditional_t<std::is_const_v<From>, const To, To>;
+    return static_cast<Result *>(value);
+}
+
+// Like dynamic_cast, null when `value` is not a `To`, or is null itself.
+template<typename To, typename From>
+[[nodiscard]] inline auto dyn_cast(From *value) {
+    using Result = std::conditional_t<std::is_const_v<From>, const To, To>;
+    return value != nullptr && isa<To>(value) ? static_cast<Result *>(value) : nullptr;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Bounded lock-free queue between exactly one producer thread and one
+// consumer thread. tryPush() and tryPop() never block, push() and pop() wait
+// (without spinning) while the queue is full or empty.
+// Either side can close() the queue: pushes then fail and pops fail once the
+// remaining elements are drained.
+template<typename T, size_t Capacity>
+class SpscQueue {
+private:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    std::array<T, Capacity> m_Slots;
+    // Only written by the consumer and the producer respectively, kept on
+    // separate cache lines.
+    alignas(64) std::atomic<size_t> m_Head = 0;
+    alignas(64) std::atomic<size_t> m_Tail = 0;
+    // Bumped on every push, pop and close, this is what blocked threads wait on.
+    alignas(64) std::atomic<uint32_t> m_Events = 0;
+    std::atomic<bool> m_Closed = false;
+
+    void signal() {
+        m_Events.fetch_add(1, std::memory_order_release);
+        m_Events.notify_all();
+    }
+
+public:
+    // Producer side, `value` is moved from on success.
+    bool tryPush(T &value) {
+        const size_t tail = m_Tail.load(std::memory_order_relaxed);
+        if (tail - m_Head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        m_Slots[tail & (Capacity - 1)] = std::move(value);
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side.
+    bool tryPop(T &value) {
+        const size_t head = m_Head.load(std::memory_order_relaxed);
+        if (head == m_Tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(m_Slots[head & (Capacity - 1)]);
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Waits while the queue is full, returns false if it is closed.
+    bool push(T value) {
+        while (true) {
+            const uint32_t events = m_Events.load(std::memory_order_acquire);
+            if (m_Closed.load(std::memory_order_acquire)) {
+                return false;
+            }
+            if (tryPush(value)) {
+                signal();
+                return true;
+            }
+            m_Events.wait(events, std::memory_order_acquire);
+        }
+    }
+
+    // Waits while the queue is empty, returns false once it is closed and
+    // every element pushed before has been popped.
+    bool pop(T &value) {
+        while (true) {
+            const uint32_t events = m_Events.load(std::memory_order_acquire);
+            // Read before trying, so that all the pushes done before the
+            // close are visible to tryPop().
+            const bool closed = m_Closed.load(std::memory_order_acquire);
+            if (tryPop(value)) {
+                signal();
+                return true;
+            }
+            if (closed) {
+                return false;
+            }
+            m_Events.wait(events, std::memory_order_acquire);
+        }
+    }
+
+    void close() {
+        m_Closed.store(true, std::memory_order_release);
+        signal();
+    }
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include <parallel_hashmap/phmap.h>
+
+// Compact handle on a string owned by the global StringInterner.
+// Two symbols are equal if and only if their strings are equal, so they can
+// be compared and hashed without touching the characters.
+class Symbol {
+private:
+    uint32_t m_Id = 0;
+
+public:
+    constexpr Symbol() = default;
+    explicit constexpr Symbol(uint32_t id) : m_Id(id) {}
+
+    [[nodiscard]] constexpr uint32_t getId() const { return m_Id; }
+    [[nodiscard]] constexpr bool empty() const { return m_Id == 0; }
+
+    [[nodiscard]] const std::string &str() const;
+
+    constexpr bool operator==(Symbol other) const { return m_Id == other.m_Id; }
+    constexpr bool operator!=(Symbol other) const { return m_Id != other.m_Id; }
+
+    friend size_t hash_value(Symbol symbol) { return symbol.m_Id; }
+    friend std::ostream& operator<<(std::ostream& os, Symbol symbol);
+};
+
+class StringInterner {
+private:
+    // Strings live in fixed size blocks that are never moved, so the keys of
+    // the maps can point into them and getString() needs no lock.
+    static constexpr size_t BlockBits = 14;
+    static constexpr size_t BlockSize = size_t(1) << BlockBits;
+    static constexpr size_t MaxBlocks = 4096;
+
+    // intern() is called from every lexer thread, the table is split in
+    // shards with one lock each to keep contention low.
+    static constexpr size_t ShardCount = 16;
+    struct Shard {
+        std::mutex mutex;
+        phmap::flat_hash_map<std::string_view, uint32_t> symbols;
+    };
+
+    std::array<std::unique_ptr<std::string[]>, MaxBlocks> m_Blocks;
+    std::mutex m_StorageMutex;
+    std::atomic<uint32_t> m_Size = 0;
+    std::array<Shard, ShardCount> m_Shards;
+
+    StringInterner();
+
+    // Copies `str` in the next free slot and returns its id.
+    uint32_t store(std::string_view str);
+
+public:
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    // Compiler wide instance shared by the lexer, the AST and the scopes.
+    static StringInterner &get();
+
+    // Thread safe. Exits the process past MaxBlocks * BlockSize symbols.
+    Symbol intern(std::string_view str);
+    [[nodiscard]] const std::string &getString(Symbol symbol) const {
+        return m_Blocks[symbol.getId() >> BlockBits][symbol.getId() & (BlockSize - 1)];
+    }
+    [[nodiscard]] size_t size() const { return m_Size.load(std::memory_order_acquire); }
+};
+
+inline const std::string &Symbol::str() const {
+    return StringInterner::get().getString(*this);
+}
@@ -0,0 +1,875 @@
+#include "AST/ASTCache.hpp"
+#include "AST/ASTExprNode.hpp"
+#include "AST/ASTNode.hpp"
+#include "AST/ASTStatementNode.hpp"
+#include "AST/ASTVisitor.hpp"
+#include "Lexer/SourceBuffer.hpp"
+#include "Support/Casting.hpp"
+#include "Support/StringInterner.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <parallel_hashmap/phmap.h>
+#include <unistd.h>
+
+// An image is a sequence of 32-bit words in the byte order of the machine:
+//
+//   header   magic, version, key (2 words), symbol count, node count, root count
+//   symbols  for each symbol its length in bytes, then its characters padded
+//            to a word
+//   nodes    for each node its kind, its offset and its fields, children
+//            before their parent
+//   roots    the top-level nodes of the program
+//
+// Symbols are referenced by their index in the table plus one, nodes by their
+// index in the image plus one, 0 is the empty symbol or a null node. Interned
+// ids are not stable from one run to the other, so symbols are stored as
+// strings and interned again. Lists are a count followed by their elements,
+// 64-bit values are two words, low word first.
+static constexpr uint32_t s_Magic = 0x54534159; // "YAST"
+// To be bumped on every change of the fields of a node.
+static constexpr uint32_t s_Version = 3;
+static constexpr size_t s_HeaderWords = 7;
+
+namespace {
+
+class ASTWriter : public ASTVisitor<ASTWriter, uint32_t> {
+private:
+    std::vector<uint32_t> m_Words;
+    uint32_t m_NodeCount = 0;
+    std::vector<Symbol> m_Symbols;
+    phmap::flat_hash_map<Symbol, uint32_t> m_SymbolIndices;
+
+    uint32_t write(ASTNode *node) {
+        return node == nullptr ? 0 : visit(node);
+    }
+
+    template<typename T>
+    std::vector<uint32_t> writeList(ASTList<T*> nodes) {
+        std::vector<uint32_t> indices;
+        indices.reserve(nodes.size());
+        for (T *node : nodes) {
+            indices.push_back(write(node));
+        }
+        return indices;
+    }
+
+    // Starts the record of `node`, once its children are written.
+    uint32_t begin(ASTNode *node) {
+        m_Words.push_back((uint32_t)node->getKind());
+        m_Words.push_back(node->getOffset());
+        return ++m_NodeCount;
+    }
+
+    void push(uint32_t word) { m_Words.push_back(word); }
+
+    void push64(uint64_t value) {
+        m_Words.push_back((uint32_t)value);
+        m_Words.push_back((uint32_t)(value >> 32));
+    }
+
+    void pushSymbol(Symbol symbol) {
+        if (symbol.empty()) {
+            m_Words.push_back(0);
+            return;
+        }
+        auto [it, inserted] = m_SymbolIndices.try_emplace(symbol, (uint32_t)m_Symbols.size() + 1);
+        if (inserted) {
+            m_Symbols.push_back(symbol);
+        }
+        m_Words.push_back(it->second);
+    }
+
+    void pushList(const std::vector<uint32_t> &indices) {
+        m_Words.push_back((uint32_t)indices.size());
+        m_Words.insert(m_Words.end(), indices.begin(), indices.end());
+    }
+
+    void pushSymbols(ASTList<Symbol> symbols) {
+        m_Words.push_back((uint32_t)symbols.size());
+        for (Symbol symbol : symbols) {
+            pushSymbol(symbol);
+        }
+    }
+
+    friend ASTVisitor<ASTWriter, uint32_t>;
+
+    uint32_t visitBinary(ASTBinaryNode *node) {
+        const uint32_t left = write(node->getLeftOperrand());
+        const uint32_t right = write(node->getRightOperrand());
+        const uint32_t index = begin(node);
+        push(left);
+        push((uint32_t)node->getOperator());
+        push(right);
+        return index;
+    }
+    uint32_t visitConditional(ASTConditionalNode *node) {
+        const uint32_t cond = write(node->getCond());
+        const uint32_t then = write(node->getThen());
+        const uint32_t t_Else = write(node->getElse());
+        const uint32_t index = begin(node);
+        push(cond);
+        push(then);
+        push(t_Else);
+        return index;
+    }
+    uint32_t visitRange(ASTRangeNode *node) {
+        const uint32_t start = write(node->getStart());
+        const uint32_t stop = write(node->getStop());
+        const uint32_t index = begin(node);
+        push(start);
+        push((uint32_t)node->getOp());
+        push(stop);
+        return index;
+    }
+    uint32_t visitLiteralInt(ASTLiteralNode<int> *node) {
+        const uint32_t index = begin(node);
+        push((uint32_t)node->getValue());
+        return index;
+    }
+    uint32_t visitLiteralLong(ASTLiteralNode<int64_t> *node) {
+        const uint32_t index = begin(node);
+        push64((uint64_t)node->getValue());
+        return index;
+    }
+    uint32_t visitLiteralDouble(ASTLiteralNode<double> *node) {
+        const uint32_t index = begin(node);
+        const double value = node->getValue();
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        push64(bits);
+        return index;
+    }
+    uint32_t visitLiteralBool(ASTLiteralNode<bool> *node) {
+        const uint32_t index = begin(node);
+        push(node->getValue());
+        return index;
+    }
+    uint32_t visitLiteralString(ASTLiteralNode<std::string_view> *node) {
+        const uint32_t index = begin(node);
+        pushSymbol(StringInterner::get().intern(node->getValue()));
+        return index;
+    }
+    uint32_t visitIdentifier(ASTIdentifierNode *node) {
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        return index;
+    }
+    uint32_t visitNamespaceIdentifier(ASTNamespaceIdentifierNode *node) {
+        const uint32_t index = begin(node);
+        pushSymbol(node->getNamespaceSymbol());
+        pushSymbol(node->getSymbol());
+        return index;
+    }
+    uint32_t visitFunctionCall(ASTFunctionCallNode *node) {
+        const uint32_t callee = write(node->getCallee());
+        const auto args = writeList(node->getArgs());
+        const uint32_t index = begin(node);
+        push(callee);
+        pushList(args);
+        return index;
+    }
+    uint32_t visitAttributeAccess(ASTAttributeAccessNode *node) {
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        pushSymbol(node->getAttributeSymbol());
+        return index;
+    }
+    uint32_t visitMethodCall(ASTMethodCallNode *node) {
+        const auto args = writeList(node->getArgs());
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        pushSymbol(node->getAttributeSymbol());
+        pushList(args);
+        return index;
+    }
+    uint32_t visitArrayAccess(ASTArrayAccessNode *node) {
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        push64(node->getIndex());
+        return index;
+    }
+
+    uint32_t visitImport(ASTImportNode *node) {
+        const uint32_t index = begin(node);
+        pushSymbol(node->getModuleSymbol());
+        pushSymbols(node->getSubModules());
+        return index;
+    }
+    uint32_t visitExport(ASTExportNode *node) {
+        const uint32_t module = write(node->getModule());
+        const uint32_t index = begin(node);
+        push(module);
+        return index;
+    }
+    uint32_t visitDeclaration(ASTDeclarationNode *node) {
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        push(node->getType());
+        pushSymbol(node->getStructSymbol());
+        return index;
+    }
+    uint32_t visitInitialization(ASTInitializationNode *node) {
+        const uint32_t value = write(node->getValue());
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        push(node->getType());
+        push(value);
+        return index;
+    }
+    uint32_t visitArrayDefinition(ASTArrayDefinitionNode *node) {
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        push64(node->getSize());
+        push(node->getType());
+        return index;
+    }
+    uint32_t visitArrayInitialization(ASTArrayInitializationNode *node) {
+        const auto values = writeList(node->getValues());
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        push(node->getType());
+        push64(node->getSize());
+        pushList(values);
+        return index;
+    }
+    uint32_t visitAssignment(ASTAssignmentNode *node) {
+        const uint32_t value = write(node->getValue());
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        push(value);
+        return index;
+    }
+    uint32_t visitReturn(ASTReturnNode *node) {
+        const uint32_t expr = write(node->getExpr());
+        const uint32_t index = begin(node);
+        push(expr);
+        return index;
+    }
+    uint32_t visitBlock(ASTBlockNode *node) {
+        const auto nodes = writeList(node->getNodes());
+        const uint32_t index = begin(node);
+        pushList(nodes);
+        return index;
+    }
+    uint32_t visitIf(ASTIfNode *node) {
+        const uint32_t condition = write(node->getCond());
+        const uint32_t thenBlock = write(node->getThen());
+        const uint32_t elseBlock = write(node->getElse());
+        const uint32_t index = begin(node);
+        push(condition);
+        push(thenBlock);
+        push(elseBlock);
+        push((uint32_t)node->getHint());
+        return index;
+    }
+    uint32_t visitFor(ASTForNode *node) {
+        const uint32_t decl = write(node->getDecl());
+        const uint32_t condition = write(node->getCond());
+        const uint32_t block = write(node->getBlock());
+        const uint32_t index = begin(node);
+        push(decl);
+        push(condition);
+        push(block);
+        return index;
+    }
+    uint32_t visitFunctionDefinition(ASTFunctionDefinitionNode *node) {
+        const auto args = writeList(node->getArgs());
+        const uint32_t body = write(node->getBody());
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        pushList(args);
+        push(node->getType());
+        push(body);
+        pushSymbol(node->getReturnStructSymbol());
+        push((uint32_t)node->isCold());
+        return index;
+    }
+    uint32_t visitStructDefinition(ASTStructDefinitionNode *node) {
+        const auto attributes = writeList(node->getAttributes());
+        const auto methods = writeList(node->getMethods());
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        pushList(attributes);
+        pushList(methods);
+        return index;
+    }
+    uint32_t visitStructInitialization(ASTStructInitializationNode *node) {
+        const uint32_t structName = write(node->getStruct());
+        const auto values = writeList(node->getAttributesValues());
+        const uint32_t index = begin(node);
+        push(structName);
+        pushSymbol(node->getSymbol());
+        pushList(values);
+        return index;
+    }
+    uint32_t visitStructAssignment(ASTStructAssignmentNode *node) {
+        const auto values = writeList(node->getAttributesValues());
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        pushList(values);
+        return index;
+    }
+    uint32_t visitAttributeAssignment(ASTAttributeAssignmentNode *node) {
+        const uint32_t value = write(node->getValue());
+        const uint32_t index = begin(node);
+        pushSymbol(node->getStructSymbol());
+        pushSymbol(node->getAttributeSymbol());
+        push(value);
+        return index;
+    }
+    uint32_t visitArrayAssignment(ASTArrayAssignmentNode *node) {
+        const auto values = writeList(node->getValues());
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        pushList(values);
+        return index;
+    }
+    uint32_t visitArrayMemberAssignment(ASTArrayMemeberAssignmentNode *node) {
+        const uint32_t value = write(node->getValue());
+        const uint32_t index = begin(node);
+        pushSymbol(node->getSymbol());
+        push64(node->getIndex());
+        push(value);
+        return index;
+    }
+
+public:
+    std::string writeProgram(const ASTProgramNode &program, uint64_t key) {
+        std::vector<uint32_t> roots;
+        roots.reserve(program.size());
+        for (ASTNode *node : program) {
+            roots.push_back(write(node));
+        }
+
+        std::vector<uint32_t> image = {
+            s_Magic, s_Version, (uint32_t)key, (uint32_t)(key >> 32),
+            (uint32_t)m_Symbols.size(), m_NodeCount, (uint32_t)roots.size()
+        };
+        for (Symbol symbol : m_Symbols) {
+            const std::string &str = symbol.str();
+            image.push_back((uint32_t)str.size());
+            const size_t first = image.size();
+            image.resize(first + (str.size() + 3) / 4, 0);
+            std::memcpy(image.data() + first, str.data(), str.size());
+        }
+        image.insert(image.end(), m_Words.begin(), m_Words.end());
+        image.insert(image.end(), roots.begin(), roots.end());
+
+        return std::string(reinterpret_cast<const char *>(image.data()), image.size() * sizeof(uint32_t));
+    }
+};
+
+// Rebuilds the nodes of an image in the context of a new program. Every
+// read is bounds checked: a truncated or corrupted image is a cache miss.
+class ASTReader {
+private:
+    const char *m_Data;
+    size_t m_WordCount;
+    size_t m_Pos = 0;
+
+    ASTContext &m_Context;
+    std::vector<Symbol> m_Symbols;
+    std::vector<ASTNode*> m_Nodes;
+
+    bool read(uint32_t &word) {
+        if (m_Pos >= m_WordCount) {
+            return false;
+        }
+        std::memcpy(&word, m_Data + m_Pos++ * sizeof(uint32_t), sizeof(uint32_t));
+        return true;
+    }
+
+    bool read64(uint64_t &value) {
+        uint32_t low, high;
+        if (!read(low) || !read(high)) {
+            return false;
+        }
+        value = (uint64_t)high << 32 | low;
+        return true;
+    }
+
+    bool readSymbol(Symbol &symbol) {
+        uint32_t index;
+        if (!read(index) || index > m_Symbols.size()) {
+            return false;
+        }
+        symbol = index == 0 ? Symbol() : m_Symbols[index - 1];
+        return true;
+    }
+
+    // Children are written before their parent, `index` must be a node
+    // already read, of the expected class.
+    template<typename T>
+    bool readNode(T *&node) {
+        uint32_t index;
+        if (!read(index) || index > m_Nodes.size()) {
+            return false;
+        }
+        node = index == 0 ? nullptr : dyn_cast<T>(m_Nodes[index - 1]);
+        return index == 0 || node != nullptr;
+    }
+
+    template<typename T>
+    bool readList(ASTList<T*> &list) {
+        uint32_t size;
+        if (!read(size) || size > m_WordCount - m_Pos) {
+            return false;
+        }
+        std::vector<T*> nodes(size);
+        for (T *&node : nodes) {
+            if (!readNode(node)) {
+                return false;
+            }
+        }
+        list = m_Context.createList(nodes);
+        return true;
+    }
+
+    bool readSymbols(ASTList<Symbol> &list) {
+        uint32_t size;
+        if (!read(size) || size > m_WordCount - m_Pos) {
+            return false;
+        }
+        std::vector<Symbol> symbols(size);
+        for (Symbol &symbol : symbols) {
+            if (!readSymbol(symbol)) {
+                return false;
+            }
+        }
+        list = m_Context.createList(symbols);
+        return true;
+    }
+
+    bool readType(ASTNode::TYPE &type) {
+        uint32_t word;
+        if (!read(word) || word > ASTNode::VOID) {
+            return false;
+        }
+        type = (ASTNode::TYPE)word;
+        return true;
+    }
+
+    bool readSymbolTable(uint32_t count) {
+        // Every symbol takes at least its length word.
+        if (count > m_WordCount - m_Pos) {
+            return false;
+        }
+        m_Symbols.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t size;
+            // In 64 bits, a size close to UINT32_MAX would wrap around.
+            if (!read(size) || ((uint64_t)size + 3) / 4 > m_WordCount - m_Pos) {
+                return false;
+            }
+            const char *str = m_Data + m_Pos * sizeof(uint32_t);
+            m_Symbols.push_back(StringInterner::get().intern({str, size}));
+            m_Pos += ((uint64_t)size + 3) / 4;
+        }
+        return true;
+    }
+
+    ASTNode *readRecord();
+
+public:
+    ASTReader(std::string_view image, ASTContext &context)
+        : m_Data(image.data()), m_WordCount(image.size() / sizeof(uint32_t)), m_Context(context)
+    {}
+
+    bool readProgram(uint64_t key, ASTProgramNode &program) {
+        uint32_t header[s_HeaderWords];
+        for (uint32_t &word : header) {
+            if (!read(word)) {
+                return false;
+            }
+        }
+        if (header[0] != s_Magic || header[1] != s_Version ||
+                header[2] != (uint32_t)key || header[3] != (uint32_t)(key >> 32)) {
+            return false;
+        }
+
+        if (!readSymbolTable(header[4])) {
+            return false;
+        }
+
+        m_Nodes.reserve(std::min<size_t>(header[5], m_WordCount));
+        for (uint32_t i = 0; i < header[5]; i++) {
+            ASTNode *node = readRecord();
+            if (node == nullptr) {
+                return false;
+            }
+            m_Nodes.push_back(node);
+        }
+
+        for (uint32_t i = 0; i < header[6]; i++) {
+            ASTNode *node;
+            if (!readNode(node)) {
+                return false;
+            }
+            program.addNode(node);
+        }
+        return m_Pos == m_WordCount;
+    }
+};
+
+ASTNode *ASTReader::readRecord() {
+    using Kind = ASTNode::Kind;
+
+    uint32_t kind, offset;
+    if (!read(kind) || !read(offset)) {
+        return nullptr;
+    }
+
+    ASTNode *node = nullptr;
+    switch ((Kind)kind) {
+        case Kind::Binary: {
+            ASTExprNode *left, *right;
+            uint32_t op;
+            if (readNode(left) && read(op) && op <= (uint32_t)Operator::ororsym && readNode(right)) {
+                node = m_Context.create<ASTBinaryNode>(left, (Operator)op, right);
+            }
+            break;
+        }
+        case Kind::Conditional: {
+            ASTExprNode *cond, *then, *t_Else;
+            if (readNode(cond) && readNode(then) && readNode(t_Else)) {
+                node = m_Context.create<ASTConditionalNode>(cond, then, t_Else);
+            }
+            break;
+        }
+        case Kind::Range: {
+            ASTExprNode *start, *stop;
+            uint32_t op;
+            if (readNode(start) && read(op) && op <= (uint32_t)RangeOperator::fmt && readNode(stop)) {
+                node = m_Context.create<ASTRangeNode>(start, (RangeOperator)op, stop);
+            }
+            break;
+        }
+        case Kind::LiteralInt: {
+            uint32_t value;
+            if (read(value)) {
+                node = m_Context.create<ASTLiteralNode<int>>((int)value);
+            }
+            break;
+        }
+        case Kind::LiteralLong: {
+            uint64_t value;
+            if (read64(value)) {
+                node = m_Context.create<ASTLiteralNode<int64_t>>((int64_t)value);
+            }
+            break;
+        }
+        case Kind::LiteralDouble: {
+            uint64_t bits;
+            if (read64(bits)) {
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                node = m_Context.create<ASTLiteralNode<double>>(value);
+            }
+            break;
+        }
+        case Kind::LiteralBool: {
+            uint32_t value;
+            if (read(value)) {
+                node = m_Context.create<ASTLiteralNode<bool>>(value != 0);
+            }
+            break;
+        }
+        case Kind::LiteralString: {
+            Symbol value;
+            if (readSymbol(value)) {
+                node = m_Context.create<ASTLiteralNode<std::string_view>>(value.str());
+            }
+            break;
+        }
+        case Kind::Identifier: {
+            Symbol name;
+            if (readSymbol(name)) {
+                node = m_Context.create<ASTIdentifierNode>(name);
+            }
+            break;
+        }
+        case Kind::NamespaceIdentifier: {
+            Symbol nameSpace, name;
+            if (readSymbol(nameSpace) && readSymbol(name)) {
+                node = m_Context.create<ASTNamespaceIdentifierNode>(nameSpace, name);
+            }
+            break;
+        }
+        case Kind::FunctionCall: {
+            ASTIdentifierNode *callee;
+            ASTList<ASTExprNode*> args;
+            if (readNode(callee) && readList(args)) {
+                node = m_Context.create<ASTFunctionCallNode>(callee, args);
+            }
+            break;
+        }
+        case Kind::AttributeAccess: {
+            Symbol name, attribute;
+            if (readSymbol(name) && readSymbol(attribute)) {
+                node = m_Context.create<ASTAttributeAccessNode>(name, attribute);
+            }
+            break;
+        }
+        case Kind::MethodCall: {
+            Symbol name, method;
+            ASTList<ASTExprNode*> args;
+            if (readSymbol(name) && readSymbol(method) && readList(args)) {
+                node = m_Context.create<ASTMethodCallNode>(name, method, args);
+            }
+            break;
+        }
+        case Kind::ArrayAccess: {
+            Symbol name;
+            uint64_t index;
+            if (readSymbol(name) && read64(index)) {
+                node = m_Context.create<ASTArrayAccessNode>(name, index);
+            }
+            break;
+        }
+
+        case Kind::Import: {
+            Symbol module;
+            ASTList<Symbol> subModules;
+            if (readSymbol(module) && readSymbols(subModules)) {
+                node = m_Context.create<ASTImportNode>(module, subModules);
+            }
+            break;
+        }
+        case Kind::Export: {
+            ASTStatementNode *module;
+            if (readNode(module)) {
+                node = m_Context.create<ASTExportNode>(module);
+            }
+            break;
+        }
+        case Kind::Declaration: {
+            Symbol name, structName;
+            ASTNode::TYPE type;
+            if (readSymbol(name) && readType(type) && readSymbol(structName)) {
+                node = m_Context.create<ASTDeclarationNode>(name, type, structName);
+            }
+            break;
+        }
+        case Kind::Initialization: {
+            Symbol name;
+            ASTNode::TYPE type;
+            ASTExprNode *value;
+            if (readSymbol(name) && readType(type) && readNode(value)) {
+                node = m_Context.create<ASTInitializationNode>(name, type, value);
+            }
+            break;
+        }
+        case Kind::ArrayDefinition: {
+            Symbol name;
+            uint64_t size;
+            ASTNode::TYPE type;
+            if (readSymbol(name) && read64(size) && readType(type)) {
+                node = m_Context.create<ASTArrayDefinitionNode>(name, size, type);
+            }
+            break;
+        }
+        case Kind::ArrayInitialization: {
+            Symbol name;
+            ASTNode::TYPE type;
+            uint64_t size;
+            ASTList<ASTExprNode*> values;
+            if (readSymbol(name) && readType(type) && read64(size) && readList(values)) {
+                node = m_Context.create<ASTArrayInitializationNode>(name, type, size, values);
+            }
+            break;
+        }
+        case Kind::Assignment: {
+            Symbol name;
+            ASTExprNode *value;
+            if (readSymbol(name) && readNode(value)) {
+                node = m_Context.create<ASTAssignmentNode>(name, value);
+            }
+            break;
+        }
+        case Kind::Return: {
+            ASTExprNode *expr;
+            if (readNode(expr)) {
+                node = m_Context.create<ASTReturnNode>(expr);
+            }
+            break;
+        }
+        case Kind::Block: {
+            ASTList<ASTNode*> nodes;
+            if (readList(nodes)) {
+                node = m_Context.create<ASTBlockNode>(nodes);
+            }
+            break;
+        }
+        case Kind::If: {
+            ASTExprNode *condition;
+            ASTBlockNode *thenBlock, *elseBlock;
+            uint32_t hint;
+            if (readNode(condition) && readNode(thenBlock) && readNode(elseBlock) && read(hint) &&
+                    hint <= (uint32_t)BranchHint::unlikely) {
+                node = m_Context.create<ASTIfNode>(condition, thenBlock, elseBlock, (BranchHint)hint);
+            }
+            break;
+        }
+        case Kind::For: {
+            ASTDeclarationNode *decl;
+            ASTExprNode *condition;
+            ASTBlockNode *block;
+            if (readNode(decl) && readNode(condition) && readNode(block)) {
+                node = m_Context.create<ASTForNode>(decl, condition, block);
+            }
+            break;
+        }
+        case Kind::FunctionDefinition: {
+            Symbol name, returnStruct;
+            ASTList<ASTDeclarationNode*> args;
+            ASTNode::TYPE type;
+            ASTBlockNode *body;
+            uint32_t isCold;
+            if (readSymbol(name) && readList(args) && readType(type) && readNode(body) && readSymbol(returnStruct) &&
+                    read(isCold)) {
+                node = m_Context.create<ASTFunctionDefinitionNode>(name, args, type, body, returnStruct,
+                        isCold != 0);
+            }
+            break;
+        }
+        case Kind::StructDefinition: {
+            Symbol name;
+            ASTList<ASTDeclarationNode*> attributes;
+            ASTList<ASTFunctionDefinitionNode*> methods;
+            if (readSymbol(name) && readList(attributes) && readList(methods)) {
+                node = m_Context.create<ASTStructDefinitionNode>(name, attributes, methods);
+            }
+            break;
+        }
+        case Kind::StructInitialization: {
+            ASTIdentifierNode *structName;
+            Symbol name;
+            ASTList<ASTExprNode*> values;
+            if (readNode(structName) && readSymbol(name) && readList(values)) {
+                node = m_Context.create<ASTStructInitializationNode>(structName, name, values);
+            }
+            break;
+        }
+        case Kind::StructAssignment: {
+            Symbol name;
+            ASTList<ASTExprNode*> values;
+            if (readSymbol(name) && readList(values)) {
+                node = m_Context.create<ASTStructAssignmentNode>(name, values);
+            }
+            break;
+        }
+        case Kind::AttributeAssignment: {
+            Symbol structName, attribute;
+            ASTExprNode *value;
+            if (readSymbol(structName) && readSymbol(attribute) && readNode(value)) {
+                node = m_Context.create<ASTAttributeAssignmentNode>(structName, attribute, value);
+            }
+            break;
+        }
+        case Kind::ArrayAssignment: {
+            Symbol name;
+            ASTList<ASTExprNode*> values;
+            if (readSymbol(name) && readList(values)) {
+                node = m_Context.create<ASTArrayAssignmentNode>(name, values);
+            }
+            break;
+        }
+        case Kind::ArrayMemberAssignment: {
+            Symbol name;
+            uint64_t index;
+            ASTExprNode *value;
+            if (readSymbol(name) && read64(index) && readNode(value)) {
+                node = m_Context.create<ASTArrayMemeberAssignmentNode>(name, index, value);
+            }
+            break;
+        }
+
+        case Kind::Program:
+            break;
+    }
+
+    if (node != nullptr) {
+        node->setOffset(offset);
+    }
+    return node;
+}
+
+} // namespace
+
+ASTCache::ASTCache(std::string directory)
+    : m_Directory(std::move(directory))
+{}
+
+uint64_t ASTCache::hashSource(std::string_view source) {
+    uint64_t hash = 0xcbf29ce484222325;
+    for (char c : source) {
+        hash = (hash ^ (uint8_t)c) * 0x100000001b3;
+    }
+    return hash;
+}
+
+std::string ASTCache::serialize(const ASTProgramNode &program, uint64_t key) {
+    return ASTWriter().writeProgram(program, key);
+}
+
+std::unique_ptr<ASTProgramNode> ASTCache::deserialize(std::string_view image, uint64_t key) {
+    auto program = std::make_unique<ASTProgramNode>();
+    if (image.size() % sizeof(uint32_t) != 0 ||
+            !ASTReader(image, program->getContext()).readProgram(key, *program)) {
+        return nullptr;
+    }
+    return program;
+}
+
+std::string ASTCache::getPath(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.ast", (unsigned long long)key);
+    return (std::filesystem::path(m_Directory) / name).string();
+}
+
+std::unique_ptr<ASTProgramNode> ASTCache::load(uint64_t key) const {
+    // The image is mapped, nodes are rebuilt straight from the mapping.
+    auto image = SourceBuffer::fromFile(getPath(key));
+    if (image == nullptr) {
+        return nullptr;
+    }
+    return deserialize(image->getBuffer(), key);
+}
+
+bool ASTCache::store(uint64_t key, const ASTProgramNode &program) const {
+    std::error_code error;
+    std::filesystem::create_directories(m_Directory, error);
+    if (error) {
+        return false;
+    }
+
+    // Written aside and renamed, so that a concurrent compilation never maps
+    // a partial image.
+    const std::string image = serialize(program, key);
+    const std::string path = getPath(key);
+    const std::string tmpPath = path + "." + std::to_string(getpid());
+    FILE *file = std::fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    const bool written = std::fwrite(image.data(), 1, image.size(), file) == image.size();
+    if (std::fclose(file) != 0 || !written) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    std::filesystem::rename(tmpPath, path, error);
+    if (error) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
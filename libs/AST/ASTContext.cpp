@@ -0,0 +1,33 @@
+#include "AST/ASTContext.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+void *ASTContext::allocateSlow(size_t size, size_t alignment) {
+    const size_t padded = size + alignment - 1;
+
+    // Huge lists get a block of their own, the current slab keeps being used.
+    if (padded > s_SlabSize / 4) {
+        m_LargeBlocks.push_back(std::unique_ptr<char[]>(new char[padded]));
+        auto slab = reinterpret_cast<uintptr_t>(m_LargeBlocks.back().get());
+        m_BytesAllocated += size;
+        return reinterpret_cast<void *>((slab + alignment - 1) & ~(uintptr_t)(alignment - 1));
+    }
+
+    m_Slabs.push_back(std::unique_ptr<char[]>(new char[s_SlabSize]));
+    m_Current = m_Slabs.back().get();
+    m_End = m_Current + s_SlabSize;
+    return allocate(size, alignment);
+}
+
+void ASTContext::reset() {
+    m_LargeBlocks.clear();
+    m_BytesAllocated = 0;
+    if (m_Slabs.empty()) {
+        return;
+    }
+
+    m_Slabs.resize(1);
+    m_Current = m_Slabs.front().get();
+    m_End = m_Current + s_SlabSize;
+}
@@ -1,40 +1,43 @@
 #include "AST/ASTExprNode.hpp"
-#include <memory>
 #include <string>
-#include <vector>
 
 ASTBinaryNode::ASTBinaryNode(
-        std::unique_ptr<ASTExprNode> leftOperrand,
+        ASTExprNode *leftOperrand,
         Operator t_Operator,
-        std::unique_ptr<ASTExprNode> rightOperrand
+        ASTExprNode *rightOperrand
         )
-    : m_LeftOperrand(std::move(leftOperrand)),
+    : ASTExprNode(Kind::Binary),
+      m_LeftOperrand(leftOperrand),
       m_Operator(t_Operator),
-      m_RightOperrand(std::move(rightOperrand))
+      m_RightOperrand(rightOperrand)
 {}
 
-ASTIdentifierNode::ASTIdentifierNode(std::string identifier)
-    : m_Identifier(std::move(identifier))
+ASTIdentifierNode::ASTIdentifierNode(Kind kind, Symbol identifier)
+    : ASTExprNode(kind), m_Identifier(identifier)
+{}
+
+ASTIdentifierNode::ASTIdentifierNode(Symbol identifier)
+    : ASTIdentifierNode(Kind::Identifier, identifier)
 {}
 
 ASTNamespaceIdentifierNode::ASTNamespaceIdentifierNode(
-        std::string &t_Namespace,
-        std::string &identifier
+        Symbol t_Namespace,
+        Symbol identifier
         )
-    : m_Namespace(std::move(t_Namespace)), ASTIdentifierNode(std::move(identifier))
+    : ASTIdentifierNode(Kind::NamespaceIdentifier, identifier), m_Namespace(t_Namespace)
 {}
 
 ASTFunctionCallNode::ASTFunctionCallNode(
-        std::unique_ptr<ASTIdentifierNode> name,
-        std::vector<std::unique_ptr<ASTExprNode>> args
+        ASTIdentifierNode *name,
+        ASTList<ASTExprNode*> args
         )
-    : m_Name(std::move(name)), m_Args(std::move(args))
+    : ASTExprNode(Kind::FunctionCall), m_Name(name), m_Args(args)
 {}
 
 ASTMethodCallNode::ASTMethodCallNode(
-        std::string structIdentifier,
-        std::string methodName,
-        std::vector<std::unique_ptr<ASTExprNode>> args)
-    : ASTAttributeAccessNode(std::move(structIdentifier), std::move(methodName)), m_Args(std::move(args))
+        Symbol structIdentifier,
+        Symbol methodName,
+        ASTList<ASTExprNode*> args)
+    : ASTAttributeAccessNode(Kind::MethodCall, structIdentifier, methodName), m_Args(args)
 {}
 
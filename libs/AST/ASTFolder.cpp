@@ -0,0 +1,466 @@
+#include "AST/ASTFolder.hpp"
+#include "AST/ASTExprNode.hpp"
+#include "AST/ASTNode.hpp"
+#include "AST/ASTStatementNode.hpp"
+#include "Support/Casting.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// Value of a literal, typed like the IR generator types it: int is i32, long
+// is i64, double and bool is i1.
+struct Constant {
+    enum Type { Int, Long, Double, Bool };
+
+    Type type;
+    int64_t intValue = 0;
+    double floatValue = 0;
+};
+
+bool getConstant(const ASTExprNode *node, Constant &constant) {
+    if (node == nullptr) {
+        return false;
+    }
+    switch (node->getKind()) {
+        case ASTNode::Kind::LiteralInt:
+            constant = {Constant::Int, cast<ASTLiteralNode<int>>(node)->getValue()};
+            return true;
+        case ASTNode::Kind::LiteralLong:
+            constant = {Constant::Long, cast<ASTLiteralNode<int64_t>>(node)->getValue()};
+            return true;
+        case ASTNode::Kind::LiteralDouble:
+            constant = {Constant::Double, 0, cast<ASTLiteralNode<double>>(node)->getValue()};
+            return true;
+        case ASTNode::Kind::LiteralBool:
+            constant = {Constant::Bool, cast<ASTLiteralNode<bool>>(node)->getValue()};
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Integers wrap around like the IR does. Divisions whose result is undefined
+// are left to run time.
+bool evaluateInt(Operator op, Constant::Type type, int64_t lhs, int64_t rhs, Constant &result) {
+    const bool isLong = type == Constant::Long;
+    const int64_t min = isLong ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int32_t>::min();
+    auto wrap = [isLong](uint64_t value) -> int64_t {
+        return isLong ? (int64_t)value : (int64_t)(int32_t)(uint32_t)value;
+    };
+    auto compare = [&result](bool value) {
+        result = {Constant::Bool, value};
+        return true;
+    };
+
+    switch (op) {
+        case Operator::plus:
+            result = {type, wrap((uint64_t)lhs + (uint64_t)rhs)};
+            return true;
+        case Operator::minus:
+            result = {type, wrap((uint64_t)lhs - (uint64_t)rhs)};
+            return true;
+        case Operator::times:
+            result = {type, wrap((uint64_t)lhs * (uint64_t)rhs)};
+            return true;
+        case Operator::divide:
+        case Operator::mod:
+            if (rhs == 0 || (lhs == min && rhs == -1)) {
+                return false;
+            }
+            result = {type, op == Operator::divide ? lhs / rhs : lhs % rhs};
+            return true;
+        case Operator::andsym:
+            result = {type, lhs & rhs};
+            return true;
+        case Operator::orsym:
+            result = {type, lhs | rhs};
+            return true;
+        case Operator::lth: return compare(lhs < rhs);
+        case Operator::mth: return compare(lhs > rhs);
+        case Operator::leq: return compare(lhs <= rhs);
+        case Operator::meq: return compare(lhs >= rhs);
+        case Operator::eqcomp: return compare(lhs == rhs);
+        case Operator::neq: return compare(lhs != rhs);
+        case Operator::andandsym:
+        case Operator::ororsym:
+            return false;
+    }
+    return false;
+}
+
+// Comparisons are ordered, false when an operand is NaN.
+bool evaluateFloat(Operator op, double lhs, double rhs, Constant &result) {
+    auto compare = [&result](bool value) {
+        result = {Constant::Bool, value};
+        return true;
+    };
+
+    switch (op) {
+        case Operator::plus:
+            result = {Constant::Double, 0, lhs + rhs};
+            return true;
+        case Operator::minus:
+            result = {Constant::Double, 0, lhs - rhs};
+            return true;
+        case Operator::times:
+            result = {Constant::Double, 0, lhs * rhs};
+            return true;
+        case Operator::divide:
+            result = {Constant::Double, 0, lhs / rhs};
+            return true;
+        case Operator::mod:
+            result = {Constant::Double, 0, std::fmod(lhs, rhs)};
+            return true;
+        case Operator::lth: return compare(lhs < rhs);
+        case Operator::mth: return compare(lhs > rhs);
+        case Operator::leq: return compare(lhs <= rhs);
+        case Operator::meq: return compare(lhs >= rhs);
+        case Operator::eqcomp: return compare(lhs == rhs);
+        case Operator::neq: return compare(lhs < rhs || lhs > rhs);
+        case Operator::andsym:
+        case Operator::orsym:
+        case Operator::andandsym:
+        case Operator::ororsym:
+            return false;
+    }
+    return false;
+}
+
+// Same conversions as IRGenerator::generateBinary(): integers are widened to
+// the widest of the two, and an operand mixed with a double is converted to
+// the type of the left one. Booleans only mix with booleans.
+bool evaluate(Operator op, Constant lhs, Constant rhs, Constant &result) {
+    if (lhs.type == Constant::Bool || rhs.type == Constant::Bool) {
+        if (lhs.type != rhs.type) {
+            return false;
+        }
+        const bool left = lhs.intValue != 0;
+        const bool right = rhs.intValue != 0;
+        switch (op) {
+            case Operator::andsym: result = {Constant::Bool, left && right}; return true;
+            case Operator::orsym: result = {Constant::Bool, left || right}; return true;
+            case Operator::eqcomp: result = {Constant::Bool, left == right}; return true;
+            case Operator::neq: result = {Constant::Bool, left != right}; return true;
+            default: return false;
+        }
+    }
+
+    if (lhs.type == Constant::Double) {
+        const double right = rhs.type == Constant::Double ? rhs.floatValue : (double)rhs.intValue;
+        return evaluateFloat(op, lhs.floatValue, right, result);
+    }
+
+    if (rhs.type == Constant::Double) {
+        // Truncated to the integer type of the left operand, which is
+        // undefined out of its range.
+        const double limit = lhs.type == Constant::Long ? 0x1p63 : 0x1p31;
+        if (!(rhs.floatValue > -limit - 1 && rhs.floatValue < limit)) {
+            return false;
+        }
+        rhs = {lhs.type, (int64_t)rhs.floatValue};
+    }
+
+    const Constant::Type type = lhs.type == Constant::Long || rhs.type == Constant::Long ?
+        Constant::Long : Constant::Int;
+    return evaluateInt(op, type, lhs.intValue, rhs.intValue, result);
+}
+
+// Whether `x op constant` is x. Only a right operand can be dropped: the
+// left one decides the type of the result, and an int or a double on the
+// right always takes it. A long could widen an int. `type` is the type of
+// the left operand, x + 0 is not x for doubles since -0.0 + 0 is 0.0.
+bool isIdentity(Operator op, ASTNode::TYPE type, const Constant &rhs) {
+    if (rhs.type != Constant::Int && rhs.type != Constant::Double) {
+        return false;
+    }
+    const double value = rhs.type == Constant::Int ? (double)rhs.intValue : rhs.floatValue;
+    switch (op) {
+        case Operator::plus:
+            return value == 0 && type != ASTNode::DOUBLE;
+        case Operator::minus:
+            return value == 0;
+        case Operator::times:
+        case Operator::divide:
+            return value == 1;
+        default:
+            return false;
+    }
+}
+
+// Whether an if on `constant` runs its then block, a condition is true when
+// it is not zero.
+bool isTrue(const Constant &constant) {
+    return constant.type == Constant::Double ? constant.floatValue != 0 : constant.intValue != 0;
+}
+
+bool isLogical(Operator op) {
+    return op == Operator::andandsym || op == Operator::ororsym;
+}
+
+} // namespace
+
+template<typename T>
+ASTList<T*> ASTFolder::foldList(ASTList<T*> nodes) {
+    std::vector<T*> folded(nodes.begin(), nodes.end());
+    bool changed = false;
+    for (T *&node : folded) {
+        T *original = node;
+        node = foldChild(node);
+        changed |= node != original;
+    }
+    return changed ? m_Context.createList(folded) : nodes;
+}
+
+void ASTFolder::fold(ASTProgramNode &program) {
+    std::vector<ASTNode*> nodes(program.begin(), program.end());
+    for (auto &node : nodes) {
+        node = fold(node);
+    }
+    program.replaceNodes(0, program.size(), nodes);
+}
+
+ASTNode *ASTFolder::visitBinary(ASTBinaryNode *node) {
+    ASTExprNode *lhs = foldChild(node->getLeftOperrand());
+    ASTExprNode *rhs = foldChild(node->getRightOperrand());
+    const Operator op = node->getOperator();
+
+    Constant left, right, result;
+    const bool isLeftConstant = getConstant(lhs, left);
+    const bool isRightConstant = getConstant(rhs, right);
+
+    if (isLogical(op) && isLeftConstant) {
+        // A false left operand of && or a true one of || is the result, the
+        // right one is never evaluated. Otherwise the right one is.
+        const bool isAnd = op == Operator::andandsym;
+        if (isTrue(left) != isAnd) {
+            return create<ASTLiteralNode<bool>>(node, !isAnd);
+        }
+        if (isRightConstant) {
+            return create<ASTLiteralNode<bool>>(node, isTrue(right));
+        }
+        if (rhs != nullptr && rhs->getExprType() == ASTNode::BOOL) {
+            rhs->setType(ASTNode::BOOL, node->getConvertedType());
+            return rhs;
+        }
+    }
+
+    if (!isLogical(op) && isLeftConstant && isRightConstant && evaluate(op, left, right, result)) {
+        switch (result.type) {
+            case Constant::Int: return create<ASTLiteralNode<int>>(node, (int)result.intValue);
+            case Constant::Long: return create<ASTLiteralNode<int64_t>>(node, result.intValue);
+            case Constant::Double: return create<ASTLiteralNode<double>>(node, result.floatValue);
+            case Constant::Bool: return create<ASTLiteralNode<bool>>(node, result.intValue != 0);
+        }
+    }
+
+    if (lhs != nullptr && isRightConstant && isIdentity(op, lhs->getExprType(), right)) {
+        // The left operand has the type of the operation, it is now used
+        // where the operation was.
+        lhs->setType(lhs->getExprType(), node->getConvertedType());
+        return lhs;
+    }
+
+    if (lhs == node->getLeftOperrand() && rhs == node->getRightOperrand()) {
+        return node;
+    }
+    return create<ASTBinaryNode>(node, lhs, op, rhs);
+}
+
+ASTNode *ASTFolder::visitConditional(ASTConditionalNode *node) {
+    ASTExprNode *cond = foldChild(node->getCond());
+    ASTExprNode *then = foldChild(node->getThen());
+    ASTExprNode *t_Else = foldChild(node->getElse());
+
+    Constant condition;
+    if (getConstant(cond, condition)) {
+        ASTExprNode *branch = isTrue(condition) ? then : t_Else;
+        if (branch != nullptr) {
+            // Converted straight to the type the conditional is used as.
+            branch->setType(branch->getExprType(), node->getConvertedType());
+            return branch;
+        }
+    }
+
+    if (cond == node->getCond() && then == node->getThen() && t_Else == node->getElse()) {
+        return node;
+    }
+    return create<ASTConditionalNode>(node, cond, then, t_Else);
+}
+
+ASTNode *ASTFolder::visitRange(ASTRangeNode *node) {
+    ASTExprNode *start = foldChild(node->getStart());
+    ASTExprNode *stop = foldChild(node->getStop());
+    if (start == node->getStart() && stop == node->getStop()) {
+        return node;
+    }
+    return create<ASTRangeNode>(node, start, node->getOp(), stop);
+}
+
+ASTNode *ASTFolder::visitFunctionCall(ASTFunctionCallNode *node) {
+    const ASTList<ASTExprNode*> args = foldList(node->getArgs());
+    if (args.begin() == node->getArgs().begin()) {
+        return node;
+    }
+    return create<ASTFunctionCallNode>(node, node->getCallee(), args);
+}
+
+ASTNode *ASTFolder::visitMethodCall(ASTMethodCallNode *node) {
+    const ASTList<ASTExprNode*> args = foldList(node->getArgs());
+    if (args.begin() == node->getArgs().begin()) {
+        return node;
+    }
+    return create<ASTMethodCallNode>(node, node->getSymbol(), node->getAttributeSymbol(), args);
+}
+
+ASTNode *ASTFolder::visitExport(ASTExportNode *node) {
+    ASTStatementNode *module = foldChild(node->getModule());
+    if (module == node->getModule()) {
+        return node;
+    }
+    return create<ASTExportNode>(node, module);
+}
+
+ASTNode *ASTFolder::visitInitialization(ASTInitializationNode *node) {
+    ASTExprNode *value = foldChild(node->getValue());
+    if (value == node->getValue()) {
+        return node;
+    }
+    return create<ASTInitializationNode>(node, node->getSymbol(), node->getType(), value);
+}
+
+ASTNode *ASTFolder::visitArrayInitialization(ASTArrayInitializationNode *node) {
+    const ASTList<ASTExprNode*> values = foldList(node->getValues());
+    if (values.begin() == node->getValues().begin()) {
+        return node;
+    }
+    return create<ASTArrayInitializationNode>(node, node->getSymbol(), node->getType(), node->getSize(), values);
+}
+
+ASTNode *ASTFolder::visitAssignment(ASTAssignmentNode *node) {
+    ASTExprNode *value = foldChild(node->getValue());
+    if (value == node->getValue()) {
+        return node;
+    }
+    return create<ASTAssignmentNode>(node, node->getSymbol(), value);
+}
+
+ASTNode *ASTFolder::visitReturn(ASTReturnNode *node) {
+    ASTExprNode *expr = foldChild(node->getExpr());
+    if (expr == node->getExpr()) {
+        return node;
+    }
+    return create<ASTReturnNode>(node, expr);
+}
+
+bool ASTFolder::foldStatements(ASTBlockNode *block, std::vector<ASTNode*> &nodes) {
+    for (ASTNode *statement : *block) {
+        ASTNode *folded = fold(statement);
+
+        // The branch that is taken is inlined, an if does not open a scope.
+        if (auto ifNode = dyn_cast<ASTIfNode>(folded)) {
+            Constant condition;
+            if (getConstant(ifNode->getCond(), condition)) {
+                ASTBlockNode *branch = isTrue(condition) ? ifNode->getThen() : ifNode->getElse();
+                if (branch != nullptr && foldStatements(branch, nodes)) {
+                    return true;
+                }
+                continue;
+            }
+        }
+
+        nodes.push_back(folded);
+        if (folded != nullptr && isa<ASTReturnNode>(folded)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ASTNode *ASTFolder::visitBlock(ASTBlockNode *node) {
+    std::vector<ASTNode*> nodes;
+    foldStatements(node, nodes);
+    if (nodes.size() == node->getNodes().size() && std::equal(nodes.begin(), nodes.end(), node->begin())) {
+        return node;
+    }
+    return create<ASTBlockNode>(node, m_Context.createList(nodes));
+}
+
+ASTNode *ASTFolder::visitIf(ASTIfNode *node) {
+    ASTExprNode *condition = foldChild(node->getCond());
+    ASTBlockNode *thenBlock = foldChild(node->getThen());
+    ASTBlockNode *elseBlock = foldChild(node->getElse());
+    if (condition == node->getCond() && thenBlock == node->getThen() && elseBlock == node->getElse()) {
+        return node;
+    }
+    return create<ASTIfNode>(node, condition, thenBlock, elseBlock, node->getHint());
+}
+
+ASTNode *ASTFolder::visitFor(ASTForNode *node) {
+    ASTExprNode *condition = foldChild(node->getCond());
+    ASTBlockNode *block = foldChild(node->getBlock());
+    if (condition == node->getCond() && block == node->getBlock()) {
+        return node;
+    }
+    return create<ASTForNode>(node, node->getDecl(), condition, block);
+}
+
+ASTNode *ASTFolder::visitFunctionDefinition(ASTFunctionDefinitionNode *node) {
+    ASTBlockNode *body = foldChild(node->getBody());
+    if (body == node->getBody()) {
+        return node;
+    }
+    return create<ASTFunctionDefinitionNode>(node, node->getSymbol(), node->getArgs(), node->getType(), body,
+            node->getReturnStructSymbol(), node->isCold());
+}
+
+ASTNode *ASTFolder::visitStructDefinition(ASTStructDefinitionNode *node) {
+    const ASTList<ASTFunctionDefinitionNode*> methods = foldList(node->getMethods());
+    if (methods.begin() == node->getMethods().begin()) {
+        return node;
+    }
+    return create<ASTStructDefinitionNode>(node, node->getSymbol(), node->getAttributes(), methods);
+}
+
+ASTNode *ASTFolder::visitStructInitialization(ASTStructInitializationNode *node) {
+    const ASTList<ASTExprNode*> values = foldList(node->getAttributesValues());
+    if (values.begin() == node->getAttributesValues().begin()) {
+        return node;
+    }
+    return create<ASTStructInitializationNode>(node, node->getStruct(), node->getSymbol(), values);
+}
+
+ASTNode *ASTFolder::visitStructAssignment(ASTStructAssignmentNode *node) {
+    const ASTList<ASTExprNode*> values = foldList(node->getAttributesValues());
+    if (values.begin() == node->getAttributesValues().begin()) {
+        return node;
+    }
+    return create<ASTStructAssignmentNode>(node, node->getSymbol(), values);
+}
+
+ASTNode *ASTFolder::visitAttributeAssignment(ASTAttributeAssignmentNode *node) {
+    ASTExprNode *value = foldChild(node->getValue());
+    if (value == node->getValue()) {
+        return node;
+    }
+    return create<ASTAttributeAssignmentNode>(node, node->getStructSymbol(), node->getAttributeSymbol(), value);
+}
+
+ASTNode *ASTFolder::visitArrayAssignment(ASTArrayAssignmentNode *node) {
+    const ASTList<ASTExprNode*> values = foldList(node->getValues());
+    if (values.begin() == node->getValues().begin()) {
+        return node;
+    }
+    return create<ASTArrayAssignmentNode>(node, node->getSymbol(), values);
+}
+
+ASTNode *ASTFolder::visitArrayMemberAssignment(ASTArrayMemeberAssignmentNode *node) {
+    ASTExprNode *value = foldChild(node->getValue());
+    if (value == node->getValue()) {
+        return node;
+    }
+    return create<ASTArrayMemeberAssignmentNode>(node, node->getSymbol(), node->getIndex(), value);
+}
@@ -1,5 +1,29 @@
 #include "AST/ASTNode.hpp"
 
-void ASTProgramNode::addNode(std::unique_ptr<ASTNode> node) {
-    m_Nodes.push_back(std::move(node));
+void ASTProgramNode::addNode(ASTNode *node) {
+    m_Nodes.push_back(node);
+}
+
+void ASTProgramNode::replaceNodes(size_t begin, size_t end, const std::vector<ASTNode*> &nodes) {
+    m_Nodes.erase(m_Nodes.begin() + begin, m_Nodes.begin() + end);
+    m_Nodes.insert(m_Nodes.begin() + begin, nodes.begin(), nodes.end());
+}
+
+size_t ASTProgramNode::getBytesAllocated() const {
+    size_t bytes = m_Context.getBytesAllocated();
+    for (const auto &context : m_MergedContexts) {
+        bytes += context.getBytesAllocated();
+    }
+    return bytes;
+}
+
+void ASTProgramNode::merge(ASTProgramNode &&other) {
+    m_Nodes.insert(m_Nodes.end(), other.m_Nodes.begin(), other.m_Nodes.end());
+    other.m_Nodes.clear();
+
+    m_MergedContexts.push_back(std::move(other.m_Context));
+    for (auto &context : other.m_MergedContexts) {
+        m_MergedContexts.push_back(std::move(context));
+    }
+    other.m_MergedContexts.clear();
 }
@@ -3,101 +3,111 @@
 #include "AST/ASTNode.hpp"
 #include <algorithm>
 #include <cstddef>
-#include <memory>
 #include <string>
-#include <vector>
 
-ASTImportNode::ASTImportNode(std::string &module, std::vector<std::string> &subModules)
-    : m_Module(std::move(module)), m_SubModules(std::move(subModules))
+ASTImportNode::ASTImportNode(Symbol module, ASTList<Symbol> subModules)
+    : ASTStatementNode(Kind::Import), m_Module(module), m_SubModules(subModules)
 {}
 
-ASTImportNode::ASTImportNode(std::string &module)
-    : m_Module(std::move(module))
+ASTImportNode::ASTImportNode(Symbol module)
+    : ASTStatementNode(Kind::Import), m_Module(module)
 {}
 
-ASTExportNode::ASTExportNode(std::unique_ptr<ASTStatementNode> module)
-    : m_Module(std::move(module))
+ASTExportNode::ASTExportNode(ASTStatementNode *module)
+    : ASTStatementNode(Kind::Export), m_Module(module)
 {}
 
-ASTDeclarationNode::ASTDeclarationNode(std::string &name, ASTNode::TYPE type,
-        const std::string &structName)
-    : m_Name(std::move(name)), m_Type(type), m_StructName(std::move(structName))
+ASTDeclarationNode::ASTDeclarationNode(Kind kind, Symbol name, ASTNode::TYPE type, Symbol structName)
+    : ASTStatementNode(kind), m_Name(name), m_Type(type), m_StructName(structName)
 {}
 
-ASTReturnNode::ASTReturnNode(std::unique_ptr<ASTExprNode> returnExpr)
-    : m_ReturnExpr(std::move(returnExpr))
+ASTDeclarationNode::ASTDeclarationNode(Symbol name, ASTNode::TYPE type, Symbol structName)
+    : ASTDeclarationNode(Kind::Declaration, name, type, structName)
 {}
 
-ASTBlockNode::ASTBlockNode(std::vector<std::unique_ptr<ASTNode>> nodes)
-    : m_Nodes(std::move(nodes))
+ASTReturnNode::ASTReturnNode(ASTExprNode *returnExpr)
+    : ASTStatementNode(Kind::Return), m_ReturnExpr(returnExpr)
+{}
+
+ASTBlockNode::ASTBlockNode(ASTList<ASTNode*> nodes)
+    : ASTStatementNode(Kind::Block), m_Nodes(nodes)
 {}
 
 ASTIfNode::ASTIfNode(
-        std::unique_ptr<ASTExprNode> condition,
-        std::unique_ptr<ASTBlockNode> ifBlock,
-        std::unique_ptr<ASTBlockNode> elseBlock
+        ASTExprNode *condition,
+        ASTBlockNode *ifBlock,
+        ASTBlockNode *elseBlock,
+        BranchHint hint
         )
-    : m_Condition(std::move(condition)),
-      m_IfBlock(std::move(ifBlock)),
-      m_ElseBlock(std::move(elseBlock))
+    : ASTStatementNode(Kind::If),
+      m_Condition(condition),
+      m_IfBlock(ifBlock),
+      m_ElseBlock(elseBlock),
+      m_Hint(hint)
 {}
 
 ASTForNode::ASTForNode(
-        std::unique_ptr<ASTDeclarationNode> iterator,
-        std::unique_ptr<ASTExprNode> condition,
-        std::unique_ptr<ASTBlockNode> block
+        ASTDeclarationNode *iterator,
+        ASTExprNode *condition,
+        ASTBlockNode *block
         )
-    : m_Iterator(std::move(iterator)), m_Condition(std::move(condition)), m_Block(std::move(block))
+    : ASTStatementNode(Kind::For), m_Iterator(iterator), m_Condition(condition), m_Block(block)
 {}
 
 ASTFunctionDefinitionNode::ASTFunctionDefinitionNode(
-        std::string &name,
-        std::vector<std::unique_ptr<ASTDeclarationNode>> args,
+        Symbol name,
+        ASTList<ASTDeclarationNode*> args,
         ASTNode::TYPE returnType,
-        std::unique_ptr<ASTBlockNode> body,
-        std::string structReturn)
-    : m_Name(std::move(name)), m_Args(std::move(args)), m_ReturnType(returnType),
-        m_Body(std::move(body)), m_ReturnStruct(structReturn)
+        ASTBlockNode *body,
+        Symbol structReturn,
+        bool isCold)
+    : ASTStatementNode(Kind::FunctionDefinition), m_Name(name), m_Args(args), m_ReturnType(returnType),
+        m_Body(body), m_ReturnStruct(structReturn), m_IsCold(isCold)
 {}
 
 ASTStructDefinitionNode::ASTStructDefinitionNode(
-        std::string &name,
-        std::vector<std::unique_ptr<ASTDeclarationNode>> attributes,
-        std::vector<std::unique_ptr<ASTFunctionDefinitionNode>> methods)
-    : m_Name(std::move(name)), m_Attributes(std::move(attributes)), m_Methods(std::move(methods))
+        Symbol name,
+        ASTList<ASTDeclarationNode*> attributes,
+        ASTList<ASTFunctionDefinitionNode*> methods)
+    : ASTStatementNode(Kind::StructDefinition), m_Name(name), m_Attributes(attributes), m_Methods(methods)
 {}
 
 ASTStructInitializationNode::ASTStructInitializationNode(
-        std::unique_ptr<ASTIdentifierNode> t_Struct,
-        std::string &name,
-        std::vector<std::unique_ptr<ASTExprNode>> attributesValues)
-    : m_Struct(std::move(t_Struct)), m_Name(std::move(name)), m_AttributesValues(std::move(attributesValues))
+        ASTIdentifierNode *t_Struct,
+        Symbol name,
+        ASTList<ASTExprNode*> attributesValues)
+    : ASTStatementNode(Kind::StructInitialization), m_Struct(t_Struct), m_Name(name), m_AttributesValues(attributesValues)
 {}
 
 ASTStructAssignmentNode::ASTStructAssignmentNode(
-        std::string &name,
-        std::vector<std::unique_ptr<ASTExprNode>> attributesValues)
-    : m_Name(std::move(name)), m_AttributesValues(std::move(attributesValues))
+        Symbol name,
+        ASTList<ASTExprNode*> attributesValues)
+    : ASTStatementNode(Kind::StructAssignment), m_Name(name), m_AttributesValues(attributesValues)
 {}
 
 ASTAttributeAssignmentNode::ASTAttributeAssignmentNode(
-        std::string &structName,
-        std::string &attributeName,
-        std::unique_ptr<ASTExprNode> value)
-    : m_StrcutName(std::move(structName)),
-      m_AttributeName(std::move(attributeName)),
-      m_Value(std::move(value))
+        Symbol structName,
+        Symbol attributeName,
+        ASTExprNode *value)
+    : ASTStatementNode(Kind::AttributeAssignment),
+      m_StrcutName(structName),
+      m_AttributeName(attributeName),
+      m_Value(value)
+{}
+
+ASTArrayDefinitionNode::ASTArrayDefinitionNode(Kind kind, Symbol name, size_t size, ASTNode::TYPE type)
+    : ASTDeclarationNode(kind, name, type), m_Size(size)
 {}
 
-ASTArrayDefinitionNode::ASTArrayDefinitionNode(std::string &name, size_t size, ASTNode::TYPE type)
-    : ASTDeclarationNode(name, type), m_Size(size)
+ASTArrayDefinitionNode::ASTArrayDefinitionNode(Symbol name, size_t size, ASTNode::TYPE type)
+    : ASTArrayDefinitionNode(Kind::ArrayDefinition, name, size, type)
 {}
 
 ASTArrayMemeberAssignmentNode::ASTArrayMemeberAssignmentNode(
-        std::string &name,
+        Symbol name,
         size_t index,
-        std::unique_ptr<ASTExprNode> value
+        ASTExprNode *value
         )
-    : m_ArrayName(std::move(name)), m_Index(index), m_Value(std::move(value))
+    : ASTStatementNode(Kind::ArrayMemberAssignment), m_ArrayName(name), m_Index(index), m_Value(value)
 {}
 
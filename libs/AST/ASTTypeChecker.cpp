@@ -0,0 +1,695 @@
+#include "AST/ASTTypeChecker.hpp"
+#include "AST/ASTExprNode.hpp"
+#include "AST/ASTNode.hpp"
+#include "AST/ASTStatementNode.hpp"
+#include "Support/Casting.hpp"
+#include <string>
+#include <utility>
+
+namespace {
+
+bool isNumeric(ASTNode::TYPE type) {
+    return type == ASTNode::INT || type == ASTNode::LONG || type == ASTNode::DOUBLE;
+}
+
+bool isConvertible(const ASTType &from, const ASTType &to) {
+    if (from.type == to.type) {
+        return from.type != ASTNode::STRUCT || from.structName == to.structName;
+    }
+    return isNumeric(from.type) && isNumeric(to.type);
+}
+
+bool isComparison(Operator op) {
+    switch (op) {
+        case Operator::lth:
+        case Operator::mth:
+        case Operator::leq:
+        case Operator::meq:
+        case Operator::eqcomp:
+        case Operator::neq:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Literals and operators on literals, the IR builder folds them into
+// constants.
+bool isConstant(const ASTExprNode *expr) {
+    if (auto binary = dyn_cast<ASTBinaryNode>(expr)) {
+        return isConstant(binary->getLeftOperrand()) && isConstant(binary->getRightOperrand());
+    }
+    if (auto conditional = dyn_cast<ASTConditionalNode>(expr)) {
+        return isConstant(conditional->getCond()) && isConstant(conditional->getThen()) &&
+            isConstant(conditional->getElse());
+    }
+    return isa<ASTLiteralNode<int>>(expr) || isa<ASTLiteralNode<int64_t>>(expr) ||
+        isa<ASTLiteralNode<double>>(expr) || isa<ASTLiteralNode<bool>>(expr);
+}
+
+// Whether every path through `block` ends with a return.
+bool alwaysReturns(const ASTBlockNode *block) {
+    for (const ASTNode *statement : *block) {
+        if (isa<ASTReturnNode>(statement)) {
+            return true;
+        }
+        if (auto ifNode = dyn_cast<ASTIfNode>(statement)) {
+            if (ifNode->getElse() != nullptr && alwaysReturns(ifNode->getThen()) &&
+                    alwaysReturns(ifNode->getElse())) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::string ASTType::str() const {
+    if (type == ASTNode::STRUCT) {
+        return "struct " + structName.str();
+    }
+    return ASTNode::typeToString(type);
+}
+
+void ASTTypeChecker::error(const ASTNode *node, std::string message) {
+    m_Errors.push_back({node->getOffset(), std::move(message)});
+}
+
+void ASTTypeChecker::pushScope() {
+    m_Frames.push_back((uint32_t)m_Variables.size());
+}
+
+void ASTTypeChecker::popScope() {
+    while (m_Variables.size() > m_Frames.back()) {
+        m_InnermostVariables[m_Variables.back().name.getId()] = m_Variables.back().shadowed;
+        m_Variables.pop_back();
+    }
+    m_Frames.pop_back();
+}
+
+const ASTTypeChecker::Variable *ASTTypeChecker::lookup(Symbol name) const {
+    if (name.getId() >= m_InnermostVariables.size() || m_InnermostVariables[name.getId()] == 0) {
+        return nullptr;
+    }
+    return &m_Variables[m_InnermostVariables[name.getId()] - 1];
+}
+
+void ASTTypeChecker::declare(const ASTNode *node, Symbol name, ASTType type, bool isArray, size_t size) {
+    if (name.getId() >= m_InnermostVariables.size()) {
+        m_InnermostVariables.resize(name.getId() + 1, 0);
+    }
+    const uint32_t shadowed = m_InnermostVariables[name.getId()];
+    if (shadowed > m_Frames.back()) {
+        error(node, "Type Error: redefinition of '" + name.str() + "'");
+        return;
+    }
+    m_Variables.push_back({name, type, isArray, size, shadowed});
+    m_InnermostVariables[name.getId()] = (uint32_t)m_Variables.size();
+}
+
+const ASTTypeChecker::Variable *ASTTypeChecker::lookupVariable(const ASTNode *node, Symbol name, bool isArray) {
+    const Variable *variable = lookup(name);
+    if (variable == nullptr) {
+        error(node, "Type Error: undefined symbol '" + name.str() + "'");
+        return nullptr;
+    }
+    if (variable->isArray != isArray) {
+        error(node, "Type Error: '" + name.str() + (isArray ? "' is not an array" : "' is an array"));
+        return nullptr;
+    }
+    return variable;
+}
+
+const ASTTypeChecker::Struct *ASTTypeChecker::lookupStruct(const ASTNode *node, const Variable *variable) {
+    if (variable == nullptr) {
+        return nullptr;
+    }
+    if (variable->type.type != ASTNode::STRUCT) {
+        error(node, "Type Error: '" + variable->name.str() + "' is a " + variable->type.str() + ", not a struct");
+        return nullptr;
+    }
+    auto structure = m_Structs.find(variable->type.structName);
+    return structure != m_Structs.end() ? &structure->second : nullptr;
+}
+
+bool ASTTypeChecker::checkValueType(const ASTNode *node, ASTType type, bool builtinOnly) {
+    switch (type.type) {
+        case ASTNode::INT:
+        case ASTNode::LONG:
+        case ASTNode::DOUBLE:
+        case ASTNode::BOOL:
+            return true;
+        case ASTNode::STRUCT:
+            if (builtinOnly) {
+                error(node, "Type Error: struct attributes and methods only use builtin types");
+                return false;
+            }
+            if (m_Structs.find(type.structName) == m_Structs.end()) {
+                error(node, "Type Error: unknown struct '" + type.structName.str() + "'");
+                return false;
+            }
+            return true;
+        case ASTNode::STRING:
+            error(node, "Type Error: strings are not implemented yet");
+            return false;
+        case ASTNode::VOID:
+            error(node, "Type Error: a value cannot be void");
+            return false;
+        case ASTNode::NONE:
+            error(node, "Type Error: unknown type");
+            return false;
+    }
+    return false;
+}
+
+bool ASTTypeChecker::checkInFunction(const ASTNode *node, const char *what) {
+    if (isAtTopLevel()) {
+        error(node, std::string("Type Error: ") + what + " outside of a function");
+        return false;
+    }
+    return true;
+}
+
+void ASTTypeChecker::checkStatement(ASTNode *node) {
+    m_StatementOffset = node->getOffset();
+    if (auto expr = dyn_cast<ASTExprNode>(node)) {
+        checkExpr(expr);
+    } else {
+        visit(node);
+    }
+}
+
+ASTType ASTTypeChecker::checkExpr(ASTExprNode *expr) {
+    if (expr == nullptr) {
+        m_Errors.push_back({m_StatementOffset, "Type Error: missing expression"});
+        return {};
+    }
+    const ASTType type = visit(expr);
+    expr->setType(type.type, type.type);
+    return type;
+}
+
+bool ASTTypeChecker::expect(ASTExprNode *expr, ASTType type, const char *context, bool constant) {
+    const ASTType actual = checkExpr(expr);
+    if (actual.type == ASTNode::NONE) {
+        return false;
+    }
+    if (!isConvertible(actual, type)) {
+        error(expr, "Type Error: cannot convert " + actual.str() + " to " + type.str() + " in " + context);
+        return false;
+    }
+    if (constant && !isConstant(expr)) {
+        error(expr, std::string("Type Error: ") + context + " of a global must be a constant");
+        return false;
+    }
+    expr->setType(actual.type, type.type);
+    return true;
+}
+
+void ASTTypeChecker::checkArgs(const ASTNode *node, const std::string &name, const Function *function,
+        ASTList<ASTExprNode*> args) {
+    if (function == nullptr) {
+        for (ASTExprNode *arg : args) {
+            checkExpr(arg);
+        }
+        return;
+    }
+    if (args.size() != function->args.size()) {
+        error(node, "Type Error: '" + name + "' expects " + std::to_string(function->args.size()) +
+                " argument(s) instead of " + std::to_string(args.size()));
+        return;
+    }
+    for (size_t i = 0; i < args.size(); i++) {
+        expect(args[i], function->args[i], "argument");
+    }
+}
+
+void ASTTypeChecker::checkFunction(ASTFunctionDefinitionNode *node, const Struct *owner) {
+    const ASTType returnType = {node->getType(), node->getReturnStructSymbol()};
+    if (returnType.type != ASTNode::VOID) {
+        checkValueType(node, returnType, owner != nullptr);
+    }
+
+    pushScope();
+    m_InFunction = true;
+    m_ReturnType = returnType;
+
+    for (ASTDeclarationNode *arg : node->getArgs()) {
+        const ASTType type = {arg->getType(), arg->getStructSymbol()};
+        if (checkValueType(arg, type, owner != nullptr)) {
+            declare(arg, arg->getSymbol(), type);
+        }
+    }
+    // The attributes are variables of the method, declared after its
+    // arguments, that are read and written in place through `this`.
+    if (owner != nullptr) {
+        for (const auto &[name, type] : owner->attributes) {
+            declare(node, name, type);
+        }
+    }
+
+    visitBlock(node->getBody());
+
+    m_InFunction = false;
+    popScope();
+
+    if (returnType.type != ASTNode::VOID && !alwaysReturns(node->getBody())) {
+        error(node, "Type Error: '" + node->getName() + "' does not return a value on every path");
+    }
+}
+
+ASTType ASTTypeChecker::visitNode(ASTNode *node) {
+    error(node, "Type Error: this code cannot be compiled yet");
+    return {};
+}
+
+ASTType ASTTypeChecker::visitIdentifier(ASTIdentifierNode *node) {
+    const Variable *variable = lookupVariable(node, node->getSymbol(), false);
+    return variable != nullptr ? variable->type : ASTType();
+}
+
+bool ASTTypeChecker::checkCondition(ASTExprNode *expr, const char *what) {
+    const ASTType condition = checkExpr(expr);
+    if (condition.type == ASTNode::NONE) {
+        return false;
+    }
+    if (!isNumeric(condition.type) && condition.type != ASTNode::BOOL) {
+        error(expr, "Type Error: a " + condition.str() + " cannot be " + what);
+        return false;
+    }
+    return true;
+}
+
+ASTType ASTTypeChecker::visitBinary(ASTBinaryNode *node) {
+    ASTExprNode *lhs = node->getLeftOperrand();
+    ASTExprNode *rhs = node->getRightOperrand();
+    const Operator op = node->getOperator();
+
+    if (op == Operator::andandsym || op == Operator::ororsym) {
+        const bool isLeftValid = checkCondition(lhs, "an operand of a logical operator");
+        const bool isRightValid = checkCondition(rhs, "an operand of a logical operator");
+        return isLeftValid && isRightValid ? ASTType{ASTNode::BOOL} : ASTType();
+    }
+
+    const ASTType left = checkExpr(lhs);
+    const ASTType right = checkExpr(rhs);
+
+    if (left.type == ASTNode::NONE || right.type == ASTNode::NONE) {
+        return {};
+    }
+
+    ASTNode::TYPE operandType = ASTNode::NONE;
+    if (isNumeric(left.type) && isNumeric(right.type)) {
+        if (left.type == ASTNode::DOUBLE || right.type == ASTNode::DOUBLE) {
+            operandType = left.type;
+        } else {
+            operandType = left.type == ASTNode::LONG || right.type == ASTNode::LONG ? ASTNode::LONG : ASTNode::INT;
+        }
+        if (operandType == ASTNode::DOUBLE && (op == Operator::andsym || op == Operator::orsym)) {
+            operandType = ASTNode::NONE;
+        }
+    } else if (left.type == ASTNode::BOOL && right.type == ASTNode::BOOL) {
+        if (op == Operator::andsym || op == Operator::orsym || op == Operator::eqcomp || op == Operator::neq) {
+            operandType = ASTNode::BOOL;
+        }
+    }
+
+    if (operandType == ASTNode::NONE) {
+        error(node, "Type Error: binary operator impossible between " + left.str() + " and " + right.str());
+        return {};
+    }
+
+    lhs->setType(left.type, operandType);
+    rhs->setType(right.type, operandType);
+
+    return {isComparison(op) ? ASTNode::BOOL : operandType};
+}
+
+ASTType ASTTypeChecker::visitConditional(ASTConditionalNode *node) {
+    const bool isCondValid = checkCondition(node->getCond(), "a condition");
+    const ASTType then = checkExpr(node->getThen());
+    const ASTType t_Else = checkExpr(node->getElse());
+    if (!isCondValid || then.type == ASTNode::NONE || t_Else.type == ASTNode::NONE) {
+        return {};
+    }
+
+    ASTNode::TYPE type = ASTNode::NONE;
+    if (isNumeric(then.type) && isNumeric(t_Else.type)) {
+        if (then.type == ASTNode::DOUBLE || t_Else.type == ASTNode::DOUBLE) {
+            type = ASTNode::DOUBLE;
+        } else {
+            type = then.type == ASTNode::LONG || t_Else.type == ASTNode::LONG ? ASTNode::LONG : ASTNode::INT;
+        }
+    } else if (then.type == ASTNode::BOOL && t_Else.type == ASTNode::BOOL) {
+        type = ASTNode::BOOL;
+    }
+
+    if (type == ASTNode::NONE) {
+        error(node, "Type Error: conditional impossible between " + then.str() + " and " + t_Else.str());
+        return {};
+    }
+
+    node->getThen()->setType(then.type, type);
+    node->getElse()->setType(t_Else.type, type);
+    return {type};
+}
+
+ASTType ASTTypeChecker::visitFunctionCall(ASTFunctionCallNode *node) {
+    const Symbol name = node->getCallee()->getSymbol();
+    auto function = m_Functions.find(name);
+    if (function == m_Functions.end()) {
+        error(node, "Type Error: undefined function '" + name.str() + "'");
+        checkArgs(node, name.str(), nullptr, node->getArgs());
+        return {};
+    }
+    checkArgs(node, name.str(), &function->second, node->getArgs());
+    return function->second.returnType;
+}
+
+ASTType ASTTypeChecker::visitAttributeAccess(ASTAttributeAccessNode *node) {
+    const Struct *structure = lookupStruct(node, lookupVariable(node, node->getSymbol(), false));
+    if (structure == nullptr) {
+        return {};
+    }
+    for (const auto &[name, type] : structure->attributes) {
+        if (name == node->getAttributeSymbol()) {
+            return type;
+        }
+    }
+    error(node, "Type Error: '" + node->getName() + "' has no attribute '" + node->getAttribute() + "'");
+    return {};
+}
+
+ASTType ASTTypeChecker::visitMethodCall(ASTMethodCallNode *node) {
+    const Struct *structure = lookupStruct(node, lookupVariable(node, node->getSymbol(), false));
+    const Function *method = nullptr;
+    if (structure != nullptr) {
+        auto found = structure->methods.find(node->getAttributeSymbol());
+        if (found != structure->methods.end()) {
+            method = &found->second;
+        } else {
+            error(node, "Type Error: '" + node->getName() + "' has no method '" + node->getAttribute() + "'");
+        }
+    }
+    checkArgs(node, node->getAttribute(), method, node->getArgs());
+    return method != nullptr ? method->returnType : ASTType();
+}
+
+ASTType ASTTypeChecker::visitArrayAccess(ASTArrayAccessNode *node) {
+    const Variable *array = lookupVariable(node, node->getSymbol(), true);
+    if (array == nullptr) {
+        return {};
+    }
+    if (node->getIndex() >= array->size) {
+        error(node, "Type Error: index " + std::to_string(node->getIndex()) + " out of bound, '" +
+                node->getName() + "' has a size of " + std::to_string(array->size));
+        return {};
+    }
+    return array->type;
+}
+
+ASTType ASTTypeChecker::visitDeclaration(ASTDeclarationNode *node) {
+    const ASTType type = {node->getType(), node->getStructSymbol()};
+    if (checkValueType(node, type)) {
+        declare(node, node->getSymbol(), type);
+    }
+    return {};
+}
+
+ASTType ASTTypeChecker::visitInitialization(ASTInitializationNode *node) {
+    const ASTType type = {node->getType()};
+    if (checkValueType(node, type)) {
+        expect(node->getValue(), type, "initialization", isAtTopLevel());
+        declare(node, node->getSymbol(), type);
+    }
+    return {};
+}
+
+ASTType ASTTypeChecker::visitArrayDefinition(ASTArrayDefinitionNode *node) {
+    const ASTType type = {node->getType()};
+    if (checkValueType(node, type, true)) {
+        declare(node, node->getSymbol(), type, true, node->getSize());
+    }
+    return {};
+}
+
+ASTType ASTTypeChecker::visitArrayInitialization(ASTArrayInitializationNode *node) {
+    const ASTType type = {node->getType()};
+    if (!checkValueType(node, type, true)) {
+        return {};
+    }
+    if (node->getValues().size() != node->getSize()) {
+        error(node, "Type Error: array '" + node->getName() + "' of size " + std::to_string(node->getSize()) +
+                " initialized with " + std::to_string(node->getValues().size()) + " value(s)");
+    }
+    for (ASTExprNode *value : *node) {
+        expect(value, type, "array initialization", isAtTopLevel());
+    }
+    declare(node, node->getSymbol(), type, true, node->getSize());
+    return {};
+}
+
+ASTType ASTTypeChecker::visitAssignment(ASTAssignmentNode *node) {
+    if (!checkInFunction(node, "assignment")) {
+        return {};
+    }
+    if (const Variable *variable = lookupVariable(node, node->getSymbol(), false)) {
+        expect(node->getValue(), variable->type, "assignment");
+    }
+    return {};
+}
+
+ASTType ASTTypeChecker::visitReturn(ASTReturnNode *node) {
+    if (!m_InFunction) {
+        error(node, "Type Error: return outside of a function");
+        return {};
+    }
+    if (m_ReturnType.type == ASTNode::VOID) {
+        error(node, "Type Error: return in a void function");
+        return {};
+    }
+    expect(node->getExpr(), m_ReturnType, "return");
+    return {};
+}
+
+ASTType ASTTypeChecker::visitBlock(ASTBlockNode *node) {
+    for (ASTNode *statement : *node) {
+        if (statement != nullptr) {
+            checkStatement(statement);
+        }
+    }
+    return {};
+}
+
+ASTType ASTTypeChecker::visitIf(ASTIfNode *node) {
+    if (!checkInFunction(node, "if statement")) {
+        return {};
+    }
+    checkCondition(node->getCond(), "a condition");
+    visitBlock(node->getThen());
+    if (node->getElse() != nullptr) {
+        visitBlock(node->getElse());
+    }
+    return {};
+}
+
+ASTType ASTTypeChecker::visitFor(ASTForNode *node) {
+    if (!checkInFunction(node, "for loop")) {
+        return {};
+    }
+
+    pushScope();
+
+    ASTDeclarationNode *iterator = node->getDecl();
+    if (iterator->getKind() != ASTNode::Kind::Declaration || iterator->getType() != ASTNode::INT) {
+        error(iterator, "Type Error: the iterator of a for loop must be an int declaration");
+    } else {
+        declare(iterator, iterator->getSymbol(), {ASTNode::INT});
+    }
+
+    if (auto range = dyn_cast<ASTRangeNode>(node->getCond())) {
+        expect(range->getStart(), {ASTNode::INT}, "range");
+        expect(range->getStop(), {ASTNode::INT}, "range");
+        range->setType(ASTNode::INT, ASTNode::INT);
+    } else {
+        error(node, "Type Error: the condition of a for loop must be a range");
+    }
+
+    visitBlock(node->getBlock());
+
+    popScope();
+    return {};
+}
+
+ASTType ASTTypeChecker::visitFunctionDefinition(ASTFunctionDefinitionNode *node) {
+    if (!isAtTopLevel()) {
+        error(node, "Type Error: function '" + node->getName() + "' defined inside a function");
+        return {};
+    }
+
+    checkFunction(node, nullptr);
+
+    // Like in the IR, a function is only visible after its definition.
+    Function function = {{node->getType(), node->getReturnStructSymbol()}, {}};
+    for (ASTDeclarationNode *arg : node->getArgs()) {
+        function.args.push_back({arg->getType(), arg->getStructSymbol()});
+    }
+    if (!m_Functions.emplace(node->getSymbol(), std::move(function)).second) {
+        error(node, "Type Error: redefinition of function '" + node->getName() + "'");
+    }
+    return {};
+}
+
+ASTType ASTTypeChecker::visitStructDefinition(ASTStructDefinitionNode *node) {
+    if (!isAtTopLevel()) {
+        error(node, "Type Error: struct '" + node->getName() + "' defined inside a function");
+        return {};
+    }
+    if (m_Structs.find(node->getSymbol()) != m_Structs.end()) {
+        error(node, "Type Error: redefinition of struct '" + node->getName() + "'");
+        return {};
+    }
+
+    Struct &structure = m_Structs[node->getSymbol()];
+    for (ASTDeclarationNode *attribute : node->getAttributes()) {
+        const ASTType type = {attribute->getType(), attribute->getStructSymbol()};
+        if (!checkValueType(attribute, type, true)) {
+            continue;
+        }
+        for (const auto &[name, other] : structure.attributes) {
+            if (name == attribute->getSymbol()) {
+                error(attribute, "Type Error: redefinition of attribute '" + attribute->getName() + "'");
+            }
+        }
+        structure.attributes.emplace_back(attribute->getSymbol(), type);
+    }
+
+    for (ASTFunctionDefinitionNode *method : node->getMethods()) {
+        checkFunction(method, &structure);
+
+        Function function = {{method->getType()}, {}};
+        for (ASTDeclarationNode *arg : method->getArgs()) {
+            function.args.push_back({arg->getType()});
+        }
+        if (!structure.methods.emplace(method->getSymbol(), std::move(function)).second) {
+            error(method, "Type Error: redefinition of method '" + method->getName() + "'");
+        }
+    }
+    return {};
+}
+
+ASTType ASTTypeChecker::visitStructInitialization(ASTStructInitializationNode *node) {
+    const Symbol structName = node->getStruct()->getSymbol();
+    auto structure = m_Structs.find(structName);
+    if (structure == m_Structs.end()) {
+        error(node, "Type Error: unknown struct '" + structName.str() + "'");
+        return {};
+    }
+
+    const auto &attributes = structure->second.attributes;
+    const ASTList<ASTExprNode*> values = node->getAttributesValues();
+    if (values.size() != attributes.size()) {
+        error(node, "Type Error: struct '" + structName.str() + "' expects " + std::to_string(attributes.size()) +
+                " value(s) instead of " + std::to_string(values.size()));
+    } else {
+        for (size_t i = 0; i < values.size(); i++) {
+            expect(values[i], attributes[i].second, "struct initialization", isAtTopLevel());
+        }
+    }
+
+    declare(node, node->getSymbol(), {ASTNode::STRUCT, structName});
+    return {};
+}
+
+ASTType ASTTypeChecker::visitStructAssignment(ASTStructAssignmentNode *node) {
+    if (!checkInFunction(node, "assignment")) {
+        return {};
+    }
+    const Struct *structure = lookupStruct(node, lookupVariable(node, node->getSymbol(), false));
+    if (structure == nullptr) {
+        return {};
+    }
+
+    const ASTList<ASTExprNode*> values = node->getAttributesValues();
+    if (values.size() != structure->attributes.size()) {
+        error(node, "Type Error: assignment to '" + node->getName() + "' expects " +
+                std::to_string(structure->attributes.size()) + " value(s) instead of " +
+                std::to_string(values.size()));
+        return {};
+    }
+    for (size_t i = 0; i < values.size(); i++) {
+        expect(values[i], structure->attributes[i].second, "struct assignment");
+    }
+    return {};
+}
+
+ASTType ASTTypeChecker::visitAttributeAssignment(ASTAttributeAssignmentNode *node) {
+    if (!checkInFunction(node, "assignment")) {
+        return {};
+    }
+    const Struct *structure = lookupStruct(node, lookupVariable(node, node->getStructSymbol(), false));
+    if (structure == nullptr) {
+        return {};
+    }
+    for (const auto &[name, type] : structure->attributes) {
+        if (name == node->getAttributeSymbol()) {
+            expect(node->getValue(), type, "assignment");
+            return {};
+        }
+    }
+    error(node, "Type Error: '" + node->getStructName() + "' has no attribute '" + node->getAttributeName() + "'");
+    return {};
+}
+
+ASTType ASTTypeChecker::visitArrayAssignment(ASTArrayAssignmentNode *node) {
+    if (!checkInFunction(node, "assignment")) {
+        return {};
+    }
+    const Variable *array = lookupVariable(node, node->getSymbol(), true);
+    if (array == nullptr) {
+        return {};
+    }
+    if (node->getSize() != array->size) {
+        error(node, "Type Error: assignment to '" + node->getName() + "' expects " + std::to_string(array->size) +
+                " value(s) instead of " + std::to_string(node->getSize()));
+        return {};
+    }
+    for (ASTExprNode *value : *node) {
+        expect(value, array->type, "array assignment");
+    }
+    return {};
+}
+
+ASTType ASTTypeChecker::visitArrayMemberAssignment(ASTArrayMemeberAssignmentNode *node) {
+    if (!checkInFunction(node, "assignment")) {
+        return {};
+    }
+    const Variable *array = lookupVariable(node, node->getSymbol(), true);
+    if (array == nullptr) {
+        return {};
+    }
+    if (node->getIndex() >= array->size) {
+        error(node, "Type Error: index " + std::to_string(node->getIndex()) + " out of bound, '" +
+                node->getName() + "' has a size of " + std::to_string(array->size));
+        return {};
+    }
+    expect(node->getValue(), array->type, "assignment");
+    return {};
+}
+
+bool ASTTypeChecker::check(ASTNode *node) {
+    const size_t errorCount = m_Errors.size();
+    if (node != nullptr) {
+        checkStatement(node);
+    }
+    return m_Errors.size() == errorCount;
+}
+
+bool ASTTypeChecker::check(ASTProgramNode &program) {
+    const size_t errorCount = m_Errors.size();
+    for (ASTNode *node : program) {
+        check(node);
+    }
+    return m_Errors.size() == errorCount;
+}
@@ -2,6 +2,7 @@
 #include <iostream>
 
 #include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/Support/Error.h>
 
@@ -10,16 +11,76 @@
 
 unsigned IRGenerator::m_AnonCount = 0;
 
-void IRGenerator::generate() {
-    m_Parser->parse();
+void IRGenerator::generate(bool streaming) {
+    if (m_Parser == nullptr) {
+        // Loaded from the cache.
+        if (!m_TypeChecker.check(*m_Program)) {
+            printTypeErrors(0);
+            m_Logger.printError("{} type error(s), no code generated", m_TypeChecker.getErrors().size());
+            return;
+        }
+
+        ASTFolder(m_Program->getContext()).fold(*m_Program);
 
-    m_Program = m_Parser->getProgram();
+        m_Module = std::make_unique<llvm::Module>("main", m_LLVMContext);
 
-    m_Module = std::make_unique<llvm::Module>("main", m_LLVMContext);
+        for (const auto& node : *m_Program) {
+            if (node)
+                generate(node);
+        }
+    } else if (streaming) {
+        m_Module = std::make_unique<llvm::Module>("main", m_LLVMContext);
+
+        ASTFolder folder(m_Parser->getParsedProgram().getContext());
+        while (!m_Parser->atEnd()) {
+            const size_t errorCount = m_TypeChecker.getErrors().size();
+            ASTNode *node = m_Parser->parseNext();
+            // Once there is a syntax error the rest is only parsed, for its
+            // diagnostics, like in a whole program parse.
+            if (m_Parser->getErrorCount() == 0) {
+                if (!m_TypeChecker.check(node)) {
+                    printTypeErrors(errorCount);
+                } else if ((node = folder.fold(node))) {
+                    generate(node);
+                }
+            }
+            m_Parser->releaseNodes();
+        }
+
+        if (m_Parser->getErrorCount() > 0) {
+            m_Logger.printError("{} syntax error(s), no code generated", m_Parser->getErrorCount());
+            return;
+        }
+    } else {
+        m_Parser->parse();
+
+        // Every syntax error has been reported, the IR of what is left would
+        // only add errors about the missing declarations.
+        if (m_Parser->getErrorCount() > 0) {
+            m_Logger.printError("{} syntax error(s), no code generated", m_Parser->getErrorCount());
+            return;
+        }
 
-    for (const auto& node : *m_Program) {
-        if (node)
-            generate(node.get());
+        m_Program = m_Parser->getProgram();
+
+        if (m_Cache && !m_Parser->hasDiagnostics() && !m_Cache->store(m_CacheKey, *m_Program)) {
+            m_Logger.printWarn("Cannot write the AST cache");
+        }
+
+        if (!m_TypeChecker.check(*m_Program)) {
+            printTypeErrors(0);
+            m_Logger.printError("{} type error(s), no code generated", m_TypeChecker.getErrors().size());
+            return;
+        }
+
+        ASTFolder(m_Program->getContext()).fold(*m_Program);
+
+        m_Module = std::make_unique<llvm::Module>("main", m_LLVMContext);
+
+        for (const auto& node : *m_Program) {
+            if (node)
+                generate(node);
+        }
     }
 
 
@@ -45,93 +106,37 @@ void IRGenerator::generate() {
 
 }
 
-llvm::Value *IRGenerator::generate(ASTNode* node) {
-    if (auto expr = dynamic_cast<ASTExprNode*>(node)) {
-        auto genExpr = generateExpr(expr);
-        return genExpr;
-    } else {
-        if (auto declaration = dynamic_cast<ASTDeclarationNode*>(node)){
-            return generateDeclaration(declaration);
+void IRGenerator::printTypeErrors(size_t first) {
+    const auto &errors = m_TypeChecker.getErrors();
+    if (m_Parser == nullptr) {
+        SourceManager sourceManager(*m_CachedSource);
+        for (size_t i = first; i < errors.size(); i++) {
+            m_Logger.printError("{}: " + errors[i].message, sourceManager.getLocation(errors[i].offset));
         }
-        if (auto assignment = dynamic_cast<ASTAssignmentNode*>(node)) {
-            return generateAssignment(assignment);
-        }
-
-        if (auto returnStatement = dynamic_cast<ASTReturnNode*>(node)) {
-            return generateReturn(returnStatement);
-        }
-        if (auto funcDef = dynamic_cast<ASTFunctionDefinitionNode*>(node)) {
-            return generateFunctionDefinition(funcDef);
-        }
-        if (auto structDef = dynamic_cast<ASTStructDefinitionNode*>(node)) {
-            return generateStructDefinition(structDef);
-        }
-        if (auto structInit = dynamic_cast<ASTStructInitializationNode*>(node)) {
-            return generateStructInitialization(structInit);
-        }
-        if (auto structAssignment = dynamic_cast<ASTStructAssignmentNode*>(node)) {
-            return generateStructAssignment(structAssignment);
-        }
-        if (auto attrAssignment = dynamic_cast<ASTAttributeAssignmentNode*>(node)) {
-            return generateAttributeAssignment(attrAssignment);
-        }
-        if (auto arrAssignment = dynamic_cast<ASTArrayAssignmentNode*>(node)) {
-            return generateArrayAssignment(arrAssignment);
-        }
-        if (auto arrMemAssignment = dynamic_cast<ASTArrayMemeberAssignmentNode*>(node)) {
-            return generateArrayMemberAssignment(arrMemAssignment);
-        }
-
-        if (auto ifNode = dynamic_cast<ASTIfNode*>(node)) {
-            return generateIf(ifNode);
-        }
-
-        if (auto forNode = dynamic_cast<ASTForNode*>(node)) {
-            return generateFor(forNode);
-        }
-    }
-
-    m_Logger.printError("The code you wrote cannot be compiled yet :(");
-    return nullptr;
-}
-
-llvm::Value *IRGenerator::generateExpr(ASTExprNode *expr) {
-    if (auto bin = dynamic_cast<ASTBinaryNode*>(expr)) {
-        return generateBinary(bin);
-    }
-
-    if (auto literalInt = dynamic_cast<ASTLiteralNode<int>*>(expr)) {
-        return generateLiteralInt(literalInt);
+        return;
     }
-
-    if (auto literalDouble = dynamic_cast<ASTLiteralNode<double>*>(expr)) {
-        return generateLiteralDouble(literalDouble);
-    }
-
-    if (auto literalBool = dynamic_cast<ASTLiteralNode<bool>*>(expr)) {
-        return generateLiteralBool(literalBool);
-    }
-
-    if (auto identifier = dynamic_cast<ASTIdentifierNode*>(expr)) {
-        return generateIdentifier(identifier);
-    }
-
-    if (auto methodCall = dynamic_cast<ASTMethodCallNode*>(expr)) {
-        return generateMethodCall(methodCall);
-    }
-
-    if (auto attrAccess = dynamic_cast<ASTAttributeAccessNode*>(expr)) {
-        return generateAttributeAccess(attrAccess);
+    for (size_t i = first; i < errors.size(); i++) {
+        m_Logger.printError("{}: " + errors[i].message, m_Parser->getLocation(errors[i].offset));
     }
+}
 
-    if (auto arrAccess = dynamic_cast<ASTArrayAccessNode*>(expr)) {
-        return generateArrayAccess(arrAccess);
+llvm::Value *IRGenerator::generate(ASTNode* node) {
+    if (node == nullptr) {
+        return visitNode(node);
     }
+    return visit(node);
+}
 
-    if (auto funcCall = dynamic_cast<ASTFunctionCallNode*>(expr)) {
-        return generateFunctionCall(funcCall);
+// The conversion found by the type checker is applied here, so the value
+// always has the type its user expects.
+llvm::Value *IRGenerator::generateExpr(ASTExprNode *expr) {
+    if (expr == nullptr) {
+        return nullptr;
     }
+    return convert(generate(expr), expr->getExprType(), expr->getConvertedType());
+}
 
+llvm::Value *IRGenerator::visitNode(ASTNode *) {
     m_Logger.printError("The code you wrote cannot be compiled yet :(");
     return nullptr;
 }
@@ -141,6 +146,11 @@ llvm::Value *IRGenerator::generateLiteralInt(ASTLiteralNode<int> *literalInt) {
     return val;
 }
 
+llvm::Value *IRGenerator::generateLiteralLong(ASTLiteralNode<int64_t> *literalLong) {
+    auto val = llvm::ConstantInt::get(m_LLVMContext, llvm::APInt(64, literalLong->getValue(), true));
+    return val;
+}
+
 llvm::Value *IRGenerator::generateLiteralDouble(ASTLiteralNode<double> *literalDouble) {
     auto val = llvm::ConstantFP::get(m_LLVMContext, llvm::APFloat(literalDouble->getValue()));
     return val;
@@ -152,7 +162,7 @@ llvm::Value *IRGenerator::generateLiteralBool(ASTLiteralNode<bool> *literalBool)
 }
 
 llvm::Value *IRGenerator::generateIdentifier(ASTIdentifierNode *identifier) {
-    auto valueOrErr = (m_YAPLContext->getCurrentScope()->lookup(identifier->getName()));
+    auto valueOrErr = (m_YAPLContext->getCurrentScope()->lookup(identifier->getSymbol()));
 
     if (auto Err = valueOrErr.takeError()) {
         m_Logger.printError("Symbol not found: '{}'", identifier->getName());
@@ -165,105 +175,245 @@ llvm::Value *IRGenerator::generateIdentifier(ASTIdentifierNode *identifier) {
     return value;
 }
 
+namespace {
+
+// Whether `expr` can be evaluated even when its value is not used: it has no
+// side effect and cannot trap, so it can be an operand of a select.
+bool isSafeToSpeculate(const ASTExprNode *expr) {
+    switch (expr->getKind()) {
+        case ASTNode::Kind::LiteralInt:
+        case ASTNode::Kind::LiteralLong:
+        case ASTNode::Kind::LiteralDouble:
+        case ASTNode::Kind::LiteralBool:
+        case ASTNode::Kind::Identifier:
+        case ASTNode::Kind::AttributeAccess:
+            return true;
+        case ASTNode::Kind::Binary: {
+            auto binary = cast<ASTBinaryNode>(expr);
+            // An integer division by zero is undefined.
+            if ((binary->getOperator() == Operator::divide || binary->getOperator() == Operator::mod) &&
+                    binary->getLeftOperrand()->getConvertedType() != ASTNode::DOUBLE) {
+                return false;
+            }
+            return isSafeToSpeculate(binary->getLeftOperrand()) && isSafeToSpeculate(binary->getRightOperrand());
+        }
+        case ASTNode::Kind::Conditional: {
+            auto conditional = cast<ASTConditionalNode>(expr);
+            return isSafeToSpeculate(conditional->getCond()) && isSafeToSpeculate(conditional->getThen()) &&
+                isSafeToSpeculate(conditional->getElse());
+        }
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
 llvm::Value *IRGenerator::generateBinary(ASTBinaryNode *bin) {
     auto lhs = bin->getLeftOperrand();
     auto rhs = bin->getRightOperrand();
 
-    auto genLhs = generateExpr(lhs.get());
-    auto genRhs = generateExpr(rhs.get());
+    if (bin->getOperator() == Operator::andandsym || bin->getOperator() == Operator::ororsym) {
+        return generateLogical(bin);
+    }
 
-    auto genOp = [this](llvm::Value* L, Operator op, llvm::Value *R) {
-        switch (op) {
-            case Operator::plus:
-                return m_Builder.CreateAdd(L, R, "addtmp");
-            case Operator::minus:
-                return m_Builder.CreateSub(L, R, "subtemp");
-            case Operator::times:
-                if (L->getType()->isDoubleTy()) {
-                    return m_Builder.CreateFMul(L, R, "multmp");
-                }
-                return m_Builder.CreateMul(L, R, "multmp");
-            case Operator::divide:
-                if (L->getType()->isDoubleTy()) {
-                    return m_Builder.CreateFDiv(L, R, "divtmp");
-                }
-                return m_Builder.CreateSDiv(L, R, "divtmp");
-            case Operator::mod:
-                if (L->getType()->isDoubleTy()) {
-                    return m_Builder.CreateFRem(L, R, "modtmp");
-                }
-                return m_Builder.CreateSRem(L, R, "modtmp");
-            case Operator::lth:
-                if (L->getType()->isDoubleTy()) {
-                    return m_Builder.CreateFCmpOLT(L, R, "lthtmp");
-                }
-                return m_Builder.CreateICmpSLT(L, R, "lthtmp");
-            case Operator::mth:
-                if (L->getType()->isDoubleTy()) {
-                    return m_Builder.CreateFCmpOGT(L, R, "gthtmp"); 
-                }
-                return m_Builder.CreateICmpSGE(L, R, "gthtmp");
-            case Operator::orsym:
-                return m_Builder.CreateOr(L, R, "ortmp");
-            case Operator::andsym:
-                return m_Builder.CreateAnd(L, R, "ortmp");
-            case Operator::eqcomp:
-                if (L->getType()->isDoubleTy()) {
-                    return m_Builder.CreateFCmpOEQ(L, R, "eqtmp");
-                }
-                return m_Builder.CreateICmpEQ(L, R, "eqtmp");
-            case Operator::leq:
-                if (L->getType()->isDoubleTy()) {
-                    return m_Builder.CreateFCmpOLE(L, R, "leqtmp");
-                }
-                return m_Builder.CreateICmpSLE(L, R, "leqtmp");
-            case Operator::meq:
-                if (L->getType()->isDoubleTy()) {
-                    return m_Builder.CreateFCmpOGE(L, R, "geqtmp");
-                }
-                return m_Builder.CreateICmpSGE(L, R, "geqtmp");
-            case Operator::neq:
-                if (L->getType()->isDoubleTy()) {
-                    return m_Builder.CreateFCmpONE(L, R, "neqtmp");
-                }
-                return m_Builder.CreateICmpNE(L, R, "neqtmp");
-        } 
-    };
+    // Both operands are converted to the type of the operation.
+    auto L = generateExpr(lhs);
+    auto R = generateExpr(rhs);
+
+    if (!L || !R){
+        return nullptr;
+    }
+
+    const bool isDouble = lhs->getConvertedType() == ASTNode::DOUBLE;
+
+    switch (bin->getOperator()) {
+        case Operator::plus:
+            if (isDouble) {
+                return m_Builder.CreateFAdd(L, R, "addtmp");
+            }
+            return m_Builder.CreateAdd(L, R, "addtmp");
+        case Operator::minus:
+            if (isDouble) {
+                return m_Builder.CreateFSub(L, R, "subtemp");
+            }
+            return m_Builder.CreateSub(L, R, "subtemp");
+        case Operator::times:
+            if (isDouble) {
+                return m_Builder.CreateFMul(L, R, "multmp");
+            }
+            return m_Builder.CreateMul(L, R, "multmp");
+        case Operator::divide:
+            if (isDouble) {
+                return m_Builder.CreateFDiv(L, R, "divtmp");
+            }
+            return m_Builder.CreateSDiv(L, R, "divtmp");
+        case Operator::mod:
+            if (isDouble) {
+                return m_Builder.CreateFRem(L, R, "modtmp");
+            }
+            return m_Builder.CreateSRem(L, R, "modtmp");
+        case Operator::lth:
+            if (isDouble) {
+                return m_Builder.CreateFCmpOLT(L, R, "lthtmp");
+            }
+            return m_Builder.CreateICmpSLT(L, R, "lthtmp");
+        case Operator::mth:
+            if (isDouble) {
+                return m_Builder.CreateFCmpOGT(L, R, "gthtmp");
+            }
+            return m_Builder.CreateICmpSGT(L, R, "gthtmp");
+        case Operator::orsym:
+            return m_Builder.CreateOr(L, R, "ortmp");
+        case Operator::andsym:
+            return m_Builder.CreateAnd(L, R, "andtmp");
+        case Operator::eqcomp:
+            if (isDouble) {
+                return m_Builder.CreateFCmpOEQ(L, R, "eqtmp");
+            }
+            return m_Builder.CreateICmpEQ(L, R, "eqtmp");
+        case Operator::leq:
+            if (isDouble) {
+                return m_Builder.CreateFCmpOLE(L, R, "leqtmp");
+            }
+            return m_Builder.CreateICmpSLE(L, R, "leqtmp");
+        case Operator::meq:
+            if (isDouble) {
+                return m_Builder.CreateFCmpOGE(L, R, "geqtmp");
+            }
+            return m_Builder.CreateICmpSGE(L, R, "geqtmp");
+        case Operator::neq:
+            if (isDouble) {
+                return m_Builder.CreateFCmpONE(L, R, "neqtmp");
+            }
+            return m_Builder.CreateICmpNE(L, R, "neqtmp");
+        case Operator::andandsym:
+        case Operator::ororsym:
+            break;
+    }
+
+    return nullptr;
+}
+
+// The right operand only runs when the left one does not decide the result.
+// When it is safe to evaluate anyway, e.g. a comparison of two variables,
+// both are evaluated and the result is a select, without any branch.
+llvm::Value *IRGenerator::generateLogical(ASTBinaryNode *bin) {
+    const bool isAnd = bin->getOperator() == Operator::andandsym;
+    auto rhs = bin->getRightOperrand();
 
-    if (!genLhs || !genRhs){
+    auto L = generateCondition(bin->getLeftOperrand());
+    if (!L) {
         return nullptr;
     }
 
-    if (genLhs->getType() != genRhs->getType()) {
-        if (genLhs->getType()->isIntegerTy() && genRhs->getType()->isDoubleTy()) {
-            auto newRhs = m_Builder.CreateCast(llvm::Instruction::CastOps::FPToSI, genRhs, genLhs->getType());
-            return genOp(genLhs, bin->getOperator(), newRhs);
+    auto shortCircuit = llvm::ConstantInt::get(llvm::Type::getInt1Ty(m_LLVMContext), !isAnd);
+
+    if (m_YAPLContext->isAtTopLevelScope() || isSafeToSpeculate(rhs)) {
+        auto R = generateCondition(rhs);
+        if (!R) {
+            return nullptr;
+        }
+        if (isAnd) {
+            return m_Builder.CreateSelect(L, R, shortCircuit, "andtmp");
         }
+        return m_Builder.CreateSelect(L, shortCircuit, R, "ortmp");
+    }
+
+    llvm::Function *parentFunction = m_Builder.GetInsertBlock()->getParent();
+    llvm::BasicBlock *lhsBlock = m_Builder.GetInsertBlock();
+    llvm::BasicBlock *rhsBlock = llvm::BasicBlock::Create(m_LLVMContext, isAnd ? "and.rhs" : "or.rhs",
+            parentFunction);
+    llvm::BasicBlock *mergeBlock = llvm::BasicBlock::Create(m_LLVMContext, isAnd ? "and.end" : "or.end");
+
+    if (isAnd) {
+        m_Builder.CreateCondBr(L, rhsBlock, mergeBlock);
+    } else {
+        m_Builder.CreateCondBr(L, mergeBlock, rhsBlock);
+    }
+
+    m_Builder.SetInsertPoint(rhsBlock);
+    auto R = generateCondition(rhs);
+    if (!R) {
+        return nullptr;
+    }
+    // The right operand may have added blocks.
+    rhsBlock = m_Builder.GetInsertBlock();
+    m_Builder.CreateBr(mergeBlock);
+
+    parentFunction->getBasicBlockList().push_back(mergeBlock);
+    m_Builder.SetInsertPoint(mergeBlock);
+    llvm::PHINode *result = m_Builder.CreatePHI(llvm::Type::getInt1Ty(m_LLVMContext), 2,
+            isAnd ? "andtmp" : "ortmp");
+    result->addIncoming(shortCircuit, lhsBlock);
+    result->addIncoming(R, rhsBlock);
+    return result;
+}
+
+// Lowered to a select when both operands are safe to evaluate, which x86
+// turns into a cmov, and to branches otherwise.
+llvm::Value *IRGenerator::generateConditional(ASTConditionalNode *conditional) {
+    auto then = conditional->getThen();
+    auto t_Else = conditional->getElse();
+
+    auto cond = generateCondition(conditional->getCond());
+    if (!cond) {
+        return nullptr;
+    }
 
-        if (genLhs->getType()->isDoubleTy() && genRhs->getType()->isIntegerTy()) {
-            auto newRhs = m_Builder.CreateCast(llvm::Instruction::CastOps::SIToFP, genRhs, genLhs->getType());
-            return genOp(genLhs, bin->getOperator(), newRhs);
+    if (m_YAPLContext->isAtTopLevelScope() || (isSafeToSpeculate(then) && isSafeToSpeculate(t_Else))) {
+        auto thenVal = generateExpr(then);
+        auto elseVal = generateExpr(t_Else);
+        if (!thenVal || !elseVal) {
+            return nullptr;
         }
+        return m_Builder.CreateSelect(cond, thenVal, elseVal, "condtmp");
+    }
+
+    llvm::Function *parentFunction = m_Builder.GetInsertBlock()->getParent();
+    llvm::BasicBlock *thenBlock = llvm::BasicBlock::Create(m_LLVMContext, "cond.then", parentFunction);
+    llvm::BasicBlock *elseBlock = llvm::BasicBlock::Create(m_LLVMContext, "cond.else");
+    llvm::BasicBlock *mergeBlock = llvm::BasicBlock::Create(m_LLVMContext, "cond.end");
+
+    m_Builder.CreateCondBr(cond, thenBlock, elseBlock);
 
-        m_Logger.printError("Binary op impossible between two types.");
+    m_Builder.SetInsertPoint(thenBlock);
+    auto thenVal = generateExpr(then);
+    if (!thenVal) {
+        return nullptr;
+    }
+    thenBlock = m_Builder.GetInsertBlock();
+    m_Builder.CreateBr(mergeBlock);
+
+    parentFunction->getBasicBlockList().push_back(elseBlock);
+    m_Builder.SetInsertPoint(elseBlock);
+    auto elseVal = generateExpr(t_Else);
+    if (!elseVal) {
         return nullptr;
     }
+    elseBlock = m_Builder.GetInsertBlock();
+    m_Builder.CreateBr(mergeBlock);
 
-    return genOp(genLhs, bin->getOperator(), genRhs);
+    parentFunction->getBasicBlockList().push_back(mergeBlock);
+    m_Builder.SetInsertPoint(mergeBlock);
+    llvm::PHINode *result = m_Builder.CreatePHI(thenVal->getType(), 2, "condtmp");
+    result->addIncoming(thenVal, thenBlock);
+    result->addIncoming(elseVal, elseBlock);
+    return result;
 }
 
 llvm::Value *IRGenerator::generateDeclaration(ASTDeclarationNode *declaration) {
-    if (auto initialization = dynamic_cast<ASTInitializationNode*>(declaration)) {
+    if (auto initialization = dyn_cast<ASTInitializationNode>(declaration)) {
         return generateInitialization(initialization);
     }
 
-    if (auto arrDef = dynamic_cast<ASTArrayDefinitionNode*>(declaration)) {
+    if (auto arrDef = dyn_cast<ASTArrayDefinitionNode>(declaration)) {
         return generateArrayDefinition(arrDef);
     }
 
     // We are on top level scope so we want a global variable
     if (m_YAPLContext->isAtTopLevelScope()) {
-        if (auto var = m_YAPLContext->getCurrentScope()->lookup(declaration->getName())) {
+        if (auto var = m_YAPLContext->getCurrentScope()->lookup(declaration->getSymbol())) {
             m_Logger.printError("Redefintion of {}.", declaration->getName());
             m_DeferredErrors = llvm::joinErrors(std::move(m_DeferredErrors),
                     llvm::make_error<RedefinitionError>(declaration->getName()));
@@ -277,12 +427,12 @@ llvm::Value *IRGenerator::generateDeclaration(ASTDeclarationNode *declaration) {
         llvm::GlobalVariable *globalVar = m_Module->getNamedGlobal(declaration->getName());
         globalVar->setLinkage(llvm::GlobalValue::PrivateLinkage);
         globalVar->setAlignment(llvm::MaybeAlign(4));
-        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(declaration->getName(), globalVar));
+        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(declaration->getSymbol(), globalVar));
 
         return globalVar;
     }
 
-    if (auto val = m_YAPLContext->getCurrentScope()->lookupScope(declaration->getName())) {
+    if (auto val = m_YAPLContext->getCurrentScope()->lookupScope(declaration->getSymbol())) {
         m_Logger.printError("Redefintion of {}", declaration->getName());
         m_DeferredErrors = llvm::joinErrors(std::move(m_DeferredErrors),
                 llvm::make_error<RedefinitionError>(declaration->getName()));
@@ -300,14 +450,14 @@ llvm::Value *IRGenerator::generateDeclaration(ASTDeclarationNode *declaration) {
 
     auto variable = tmpBuilder.CreateAlloca(llvmType, nullptr, declaration->getName());
 
-    llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(declaration->getName(), variable));
+    llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(declaration->getSymbol(), variable));
 
     return variable;
 }
 
 llvm::Value *IRGenerator::generateInitialization(ASTInitializationNode *initialization) {
     if (m_YAPLContext->isAtTopLevelScope()) {
-        if (auto var = m_YAPLContext->getCurrentScope()->lookup(initialization->getName())) {
+        if (auto var = m_YAPLContext->getCurrentScope()->lookup(initialization->getSymbol())) {
             m_Logger.printError("Redefintion of {}.", initialization->getName());
             m_DeferredErrors = llvm::joinErrors(std::move(m_DeferredErrors),
                     llvm::make_error<RedefinitionError>(initialization->getName()));
@@ -325,12 +475,12 @@ llvm::Value *IRGenerator::generateInitialization(ASTInitializationNode *initiali
         globalVar->setAlignment(llvm::MaybeAlign(4));
 
         globalVar->setInitializer(static_cast<llvm::Constant *>(value));
-        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(initialization->getName(), globalVar));
+        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(initialization->getSymbol(), globalVar));
 
         return globalVar;
     }
 
-    if (auto var = m_YAPLContext->getCurrentScope()->lookupScope(initialization->getName())) {
+    if (auto var = m_YAPLContext->getCurrentScope()->lookupScope(initialization->getSymbol())) {
         m_Logger.printError("Redefintion of {}", initialization->getName());
         m_DeferredErrors = llvm::joinErrors(std::move(m_DeferredErrors),
                 llvm::make_error<RedefinitionError>(initialization->getName()));
@@ -349,7 +499,7 @@ llvm::Value *IRGenerator::generateInitialization(ASTInitializationNode *initiali
     auto variableAlloc = m_Builder.CreateAlloca(llvmType, nullptr, initialization->getName());
     auto variableStore = m_Builder.CreateStore(value, variableAlloc);
 
-    llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(initialization->getName(), variableAlloc));
+    llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(initialization->getSymbol(), variableAlloc));
 
     return variableStore;
 }
@@ -360,7 +510,7 @@ llvm::Value *IRGenerator::generateAssignment(ASTAssignmentNode *assignment) {
         return nullptr;
     }
 
-    auto variable = m_YAPLContext->getCurrentScope()->lookup(assignment->getName());
+    auto variable = m_YAPLContext->getCurrentScope()->lookup(assignment->getSymbol());
     if (variable) {
         llvm::Value *value = generateExpr(assignment->getValue());
         return m_Builder.CreateStore(value, *variable);
@@ -372,7 +522,7 @@ llvm::Value *IRGenerator::generateAssignment(ASTAssignmentNode *assignment) {
 }
 
 llvm::Value *IRGenerator::generateFunctionDefinition(ASTFunctionDefinitionNode *funcDef) {
-    if (auto var = m_YAPLContext->getCurrentScope()->lookupFunction(funcDef->getName())) {
+    if (auto var = m_YAPLContext->getCurrentScope()->lookupFunction(funcDef->getSymbol())) {
         m_Logger.printError("Redefintion of {}.", funcDef->getName());
         m_DeferredErrors = llvm::joinErrors(std::move(m_DeferredErrors),
                 llvm::make_error<RedefinitionError>(funcDef->getName()));
@@ -382,7 +532,7 @@ llvm::Value *IRGenerator::generateFunctionDefinition(ASTFunctionDefinitionNode *
     }
 
     auto llvmReturnType = ASTTypeToLLVM(funcDef->getType(), funcDef->getReturnStructName());
-    auto argsVector = std::move(funcDef->getArgs());
+    auto argsVector = funcDef->getArgs();
     llvm::SmallVector<llvm::Type *, 10> argsType;
 
     for ( const auto& arg: argsVector ) {
@@ -394,6 +544,9 @@ llvm::Value *IRGenerator::generateFunctionDefinition(ASTFunctionDefinitionNode *
             llvm::Function::ExternalLinkage,
             funcDef->getName(),
             m_Module.get());
+    if (funcDef->isCold()) {
+        func->addFnAttr(llvm::Attribute::Cold);
+    }
 
     auto parentBlock = m_Builder.GetInsertBlock();
     llvm::BasicBlock* returnBlock = llvm::BasicBlock::Create(m_LLVMContext, "return");
@@ -415,14 +568,14 @@ llvm::Value *IRGenerator::generateFunctionDefinition(ASTFunctionDefinitionNode *
     uint32_t i = 0;
     for ( const auto& arg: argsVector ) {
         func->getArg(i)->setName(arg->getName());
-        auto argDecl = generateDeclaration(arg.get());
+        auto argDecl = generateDeclaration(arg);
         m_Builder.CreateStore(func->getArg(i), argDecl);
         ++i;
     }
 
     if(generateBlock(funcDef->getBody())) {
         m_YAPLContext->popScope();
-        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushFunction(funcDef->getName(), func));
+        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushFunction(funcDef->getSymbol(), func));
         if (funcDef->getType() != ASTNode::VOID)
             func->getBasicBlockList().push_back(m_YAPLContext->getReturnBlock());
         else
@@ -446,7 +599,7 @@ llvm::Value *IRGenerator::generateFunctionDefinition(ASTFunctionDefinitionNode *
 bool IRGenerator::generateBlock(ASTBlockNode *block) {
 
     for( const auto& node : *block ) {
-        auto generatedNode = generate(node.get());
+        auto generatedNode = generate(node);
 
         if (!generatedNode) {
             return false;
@@ -476,11 +629,11 @@ llvm::Value *IRGenerator::generateStructDefinition(ASTStructDefinitionNode* stru
     auto methods = structDef->getMethods();
 
     llvm::SmallVector<llvm::Type *, 10> llvmTypes;
-    llvm::SmallVector<std::string, 10> argsName;
+    llvm::SmallVector<Symbol, 10> argsName;
 
     for ( const auto &attribute: attributes ) {
         llvmTypes.push_back(ASTTypeToLLVM(attribute->getType()));
-        argsName.push_back(attribute->getName());
+        argsName.push_back(attribute->getSymbol());
     }
 
     llvm::StructType *structType = llvm::StructType::create(m_LLVMContext, llvmTypes, "struct." + name);
@@ -492,7 +645,7 @@ llvm::Value *IRGenerator::generateStructDefinition(ASTStructDefinitionNode* stru
     }
 
     for ( const auto &method: methods ) {
-        generateMethod(structType, argsName, method.get());
+        generateMethod(structType, argsName, method);
     }
 
     return nullptr;
@@ -509,12 +662,12 @@ llvm::Value *IRGenerator::generateStructInitialization(ASTStructInitializationNo
         llvm::GlobalVariable *globalVar = m_Module->getNamedGlobal(structInit->getName());
         globalVar->setLinkage(llvm::GlobalValue::PrivateLinkage);
         globalVar->setAlignment(llvm::MaybeAlign(4));
-        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(structInit->getName(), globalVar));
+        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(structInit->getSymbol(), globalVar));
 
         llvm::SmallVector<llvm::Constant *, 5> structVals;
 
         for ( const auto& val:structInit->getAttributesValues() ) {
-            auto expr = generateExpr(val.get());
+            auto expr = generateExpr(val);
             structVals.push_back((llvm::Constant *)expr);
         }
 
@@ -523,7 +676,7 @@ llvm::Value *IRGenerator::generateStructInitialization(ASTStructInitializationNo
         return globalVar;
     }
 
-    if (auto var = m_YAPLContext->getCurrentScope()->lookupScope(structInit->getName())) {
+    if (auto var = m_YAPLContext->getCurrentScope()->lookupScope(structInit->getSymbol())) {
         m_Logger.printError("Redefintion of {}", structInit->getName());
         m_DeferredErrors = llvm::joinErrors(std::move(m_DeferredErrors),
                 llvm::make_error<RedefinitionError>(structInit->getName()));
@@ -537,32 +690,35 @@ llvm::Value *IRGenerator::generateStructInitialization(ASTStructInitializationNo
 
     int i = 0;
     for ( const auto &elt: structInit->getAttributesValues() ) {
-        auto val = generateExpr(elt.get());
+        auto val = generateExpr(elt);
         auto gep = m_Builder.CreateConstGEP2_32(structType, variableAlloc, 0, i, "gep" + std::to_string(i));
         auto store = m_Builder.CreateStore(val, gep);
         i++;
     }
 
-    llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(structInit->getName(), variableAlloc));
+    llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(structInit->getSymbol(), variableAlloc));
 
     return variableAlloc;
 }
 
 llvm::Value *IRGenerator::generateMethod(llvm::StructType* structType,
-        llvm::SmallVector<std::string, 10> attrName,
+        llvm::SmallVector<Symbol, 10> attrName,
         ASTFunctionDefinitionNode *method) {
     auto retType = ASTTypeToLLVM(method->getType());
     auto args = method->getArgs();
-    auto methodMangledName = structType->getName() + "." + method->getName();
+    auto methodMangledName = StringInterner::get().intern(
+            (structType->getName() + "." + method->getName()).str());
 
-    if(auto var = m_YAPLContext->getCurrentScope()->lookupFunction(methodMangledName.str())) {
+    if(auto var = m_YAPLContext->getCurrentScope()->lookupFunction(methodMangledName)) {
         m_Logger.printError("Redefinition of {}", methodMangledName.str());
         m_DeferredErrors = llvm::joinErrors(std::move(m_DeferredErrors),
                 llvm::make_error<RedefinitionError>(methodMangledName.str()));
     }
 
+    // The struct is passed by pointer, so that a call does not copy it and
+    // the attributes the method assigns are those of the caller's struct.
     llvm::SmallVector<llvm::Type *, 5> argsType;
-    argsType.push_back(structType);
+    argsType.push_back(structType->getPointerTo());
 
     for ( const auto &arg: args ) {
         argsType.push_back(ASTTypeToLLVM(arg->getType()));
@@ -572,8 +728,11 @@ llvm::Value *IRGenerator::generateMethod(llvm::StructType* structType,
     auto methodDef = llvm::Function::Create(
             methodType,
             llvm::Function::LinkOnceODRLinkage,
-            structType->getName() + "." + method->getName(),
+            methodMangledName.str(),
             m_Module.get());
+    if (method->isCold()) {
+        methodDef->addFnAttr(llvm::Attribute::Cold);
+    }
 
 
     auto parentBlock = m_Builder.GetInsertBlock();
@@ -593,37 +752,33 @@ llvm::Value *IRGenerator::generateMethod(llvm::StructType* structType,
     auto entryBlock = llvm::BasicBlock::Create(m_LLVMContext, "entry", methodDef);
     m_Builder.SetInsertPoint(entryBlock);
 
-    methodDef->getArg(0)->setName("this");
-    auto structDecl = m_Builder.CreateAlloca(structType, nullptr, "this");
-    m_Builder.CreateStore(methodDef->getArg(0), structDecl);
-    auto currentFunction = m_YAPLContext->getCurrentScope()->getCurrentFunction();
+    auto thisPtr = methodDef->getArg(0);
+    thisPtr->setName("this");
 
     uint32_t i = 1;
     for ( const auto& arg: args ) {
         methodDef->getArg(i)->setName(arg->getName());
-        auto argDecl = generateDeclaration(arg.get());
+        auto argDecl = generateDeclaration(arg);
         m_Builder.CreateStore(methodDef->getArg(i), argDecl);
         i++;
     }
 
-    i = 0;
-    for ( const auto& attr: structType->elements() ) {
-        llvm::IRBuilder<> tmpBuilder(&currentFunction->getEntryBlock(),
-                currentFunction->getEntryBlock().begin());
-        auto attrDecl = tmpBuilder.CreateAlloca(attr, nullptr, attrName[i]);
-        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(attrName[i], attrDecl));
-        auto GEP = m_Builder.CreateStructGEP(structDecl, i, "gep." + attrName[i]);
-        auto load = m_Builder.CreateLoad(GEP, attrName[i]);
-        m_Builder.CreateStore(load, attrDecl);
-        i++;
+    // An attribute is bound to its address in `this`, it is then loaded
+    // and stored like any other variable.
+    for (i = 0; i < structType->getNumElements(); i++) {
+        auto GEP = m_Builder.CreateStructGEP(structType, thisPtr, i, "gep." + attrName[i].str());
+        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(attrName[i], GEP));
     }
 
 
     if(generateBlock(method->getBody())) {
         m_YAPLContext->popScope();
-        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushFunction(methodDef->getName(), methodDef));
+        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushFunction(
+                StringInterner::get().intern(methodDef->getName()), methodDef));
         if (method->getType() != ASTNode::VOID)
             methodDef->getBasicBlockList().push_back(m_YAPLContext->getReturnBlock());
+        else
+            m_Builder.CreateRetVoid();
         m_YAPLContext->resetReturnHelper();
         llvm::verifyFunction(*methodDef, &llvm::errs());
         return methodDef;
@@ -643,7 +798,7 @@ llvm::Value *IRGenerator::generateStructAssignment(ASTStructAssignmentNode *stru
         return nullptr;
     } 
 
-    auto structValue = m_YAPLContext->getCurrentScope()->lookup(structAssignment->getName());
+    auto structValue = m_YAPLContext->getCurrentScope()->lookup(structAssignment->getSymbol());
 
     if (auto err = structValue.takeError()) {
         m_DeferredErrors = llvm::joinErrors(std::move(m_DeferredErrors), std::move(err));
@@ -667,7 +822,7 @@ llvm::Value *IRGenerator::generateStructAssignment(ASTStructAssignmentNode *stru
     uint32_t i = 0;
     for (const auto &value: newValues) {
         auto eltPtr = m_Builder.CreateStructGEP(*structValue, i, "elt" + llvm::itostr(i) + "ptr");
-        auto eltValue = generateExpr(newValues[i].get());
+        auto eltValue = generateExpr(newValues[i]);
         m_Builder.CreateStore(eltValue, eltPtr);
         i++;
     }
@@ -676,7 +831,7 @@ llvm::Value *IRGenerator::generateStructAssignment(ASTStructAssignmentNode *stru
 }
 
 llvm::Value *IRGenerator::generateAttributeAssignment(ASTAttributeAssignmentNode *attrAssignment) {
-    auto structPtrOrErr = m_YAPLContext->getCurrentScope()->lookup(attrAssignment->getStructName());
+    auto structPtrOrErr = m_YAPLContext->getCurrentScope()->lookup(attrAssignment->getStructSymbol());
 
     if (auto err = structPtrOrErr.takeError()) {
         m_Logger.printError("Undefined symbol {}", attrAssignment->getStructName());
@@ -696,7 +851,7 @@ llvm::Value *IRGenerator::generateAttributeAssignment(ASTAttributeAssignmentNode
 }
 
 llvm::Value *IRGenerator::generateAttributeAccess(ASTAttributeAccessNode *attrAccess) {
-    auto structPtrOrErr = m_YAPLContext->getCurrentScope()->lookup(attrAccess->getName());
+    auto structPtrOrErr = m_YAPLContext->getCurrentScope()->lookup(attrAccess->getSymbol());
 
     if (auto err = structPtrOrErr.takeError()) {
         m_Logger.printError("Undefined symbol: {}", attrAccess->getName());
@@ -716,7 +871,7 @@ llvm::Value *IRGenerator::generateAttributeAccess(ASTAttributeAccessNode *attrAc
 }
 
 llvm::Value *IRGenerator::generateArrayDefinition(ASTArrayDefinitionNode *arrDef) {
-    if (auto var = m_YAPLContext->getCurrentScope()->lookup(arrDef->getName())) {
+    if (auto var = m_YAPLContext->getCurrentScope()->lookupScope(arrDef->getSymbol())) {
         m_Logger.printError("Redefintion of {}.", arrDef->getName());
         m_DeferredErrors = llvm::joinErrors(std::move(m_DeferredErrors),
                 llvm::make_error<RedefinitionError>(arrDef->getName()));
@@ -725,7 +880,7 @@ llvm::Value *IRGenerator::generateArrayDefinition(ASTArrayDefinitionNode *arrDef
         llvm::consumeError(var.takeError());
     }
 
-    if (auto arrInit = dynamic_cast<ASTArrayInitializationNode*>(arrDef)) {
+    if (auto arrInit = dyn_cast<ASTArrayInitializationNode>(arrDef)) {
         return generateArrayInitialization(arrInit);
     }
 
@@ -735,7 +890,7 @@ llvm::Value *IRGenerator::generateArrayDefinition(ASTArrayDefinitionNode *arrDef
                 );
         globalVar->setLinkage(llvm::GlobalVariable::ExternalLinkage);
         globalVar->setAlignment(llvm::MaybeAlign(4));
-        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(arrDef->getName(), globalVar));
+        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(arrDef->getSymbol(), globalVar));
         
         return globalVar;
     }
@@ -749,7 +904,7 @@ llvm::Value *IRGenerator::generateArrayDefinition(ASTArrayDefinitionNode *arrDef
 
     auto arr = tmpBuilder.CreateAlloca(llvmType, 0, arrDef->getName());
 
-    llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(arrDef->getName(), arr));
+    llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(arrDef->getSymbol(), arr));
 
     return arr;
 }
@@ -767,7 +922,7 @@ llvm::Value *IRGenerator::generateArrayInitialization(ASTArrayInitializationNode
 
         uint32_t i = 0;
         for ( const auto &val: *arrInit ) {
-            auto value = generateExpr(val.get());
+            auto value = generateExpr(val);
             arrVals.push_back((llvm::Constant *)value);
             i++;
         }
@@ -780,7 +935,7 @@ llvm::Value *IRGenerator::generateArrayInitialization(ASTArrayInitializationNode
         globalVar->setInitializer(llvm::ConstantArray::get(
                     llvm::ArrayType::get(ASTTypeToLLVM(arrInit->getType()), arrInit->getSize()),
                     arrVals));
-        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(arrInit->getName(), globalVar));
+        llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(arrInit->getSymbol(), globalVar));
 
         return globalVar;
     }
@@ -797,7 +952,7 @@ llvm::Value *IRGenerator::generateArrayInitialization(ASTArrayInitializationNode
 
     uint32_t i = 0;
     for ( const auto &val: *arrInit ) {
-        auto value = generateExpr(val.get());
+        auto value = generateExpr(val);
         arrVals.push_back(value);
         i++;
     }
@@ -819,7 +974,7 @@ llvm::Value *IRGenerator::generateArrayInitialization(ASTArrayInitializationNode
         i++;
     }
 
-    llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(arrInit->getName(), arr));
+    llvm::cantFail(m_YAPLContext->getCurrentScope()->pushValue(arrInit->getSymbol(), arr));
 
     return arr;
 }
@@ -829,7 +984,7 @@ llvm::Value *IRGenerator::generateArrayAssignment(ASTArrayAssignmentNode *arrAss
         m_Logger.printError("Assignment at top level scope is forbidden");
         return nullptr;
     }
-    auto arrOrErr = m_YAPLContext->getCurrentScope()->lookup(arrAssignment->getName());
+    auto arrOrErr = m_YAPLContext->getCurrentScope()->lookup(arrAssignment->getSymbol());
 
     if (auto err = arrOrErr.takeError()) {
         m_Logger.printError("Undefined symbol: '{}'", arrAssignment->getName());
@@ -848,7 +1003,7 @@ llvm::Value *IRGenerator::generateArrayAssignment(ASTArrayAssignmentNode *arrAss
 
     uint32_t i = 0;
     for (const auto &val : *arrAssignment) {
-        auto value = generateExpr(val.get());
+        auto value = generateExpr(val);
         auto eltPtr = m_Builder.CreateConstGEP2_32(
                 arr->getType()->getPointerElementType(),
                 arr,
@@ -863,7 +1018,7 @@ llvm::Value *IRGenerator::generateArrayAssignment(ASTArrayAssignmentNode *arrAss
 }
 
 llvm::Value *IRGenerator::generateArrayMemberAssignment(ASTArrayMemeberAssignmentNode *arrMemAssignment) {
-    auto arrOrErr = m_YAPLContext->getCurrentScope()->lookup(arrMemAssignment->getName());
+    auto arrOrErr = m_YAPLContext->getCurrentScope()->lookup(arrMemAssignment->getSymbol());
 
     if (auto err = arrOrErr.takeError()) {
         m_Logger.printError("Undefined symbol: '{}'", arrMemAssignment->getName());
@@ -897,7 +1052,7 @@ llvm::Value *IRGenerator::generateArrayMemberAssignment(ASTArrayMemeberAssignmen
 }
 
 llvm::Value *IRGenerator::generateArrayAccess(ASTArrayAccessNode *arrAccess) {
-    auto arrOrErr = m_YAPLContext->getCurrentScope()->lookup(arrAccess->getName());
+    auto arrOrErr = m_YAPLContext->getCurrentScope()->lookup(arrAccess->getSymbol());
 
     if (auto err = arrOrErr.takeError()) {
         m_Logger.printError("Undefined symbol: '{}'", arrAccess->getName());
@@ -935,11 +1090,11 @@ llvm::Value *IRGenerator::generateFunctionCall(ASTFunctionCallNode *call) {
     llvm::SmallVector<llvm::Value *, 5> argsValue;
 
     for(const auto &arg : args) {
-        auto val = generateExpr(arg.get());
+        auto val = generateExpr(arg);
         argsValue.push_back(val);
     }
 
-    auto funcOrErr = m_YAPLContext->getCurrentScope()->lookupFunction(name);
+    auto funcOrErr = m_YAPLContext->getCurrentScope()->lookupFunction(calleeIdentifier->getSymbol());
 
     if (auto err = funcOrErr.takeError()) {
         m_DeferredErrors = llvm::joinErrors(std::move(m_DeferredErrors), std::move(err));
@@ -948,17 +1103,18 @@ llvm::Value *IRGenerator::generateFunctionCall(ASTFunctionCallNode *call) {
 
     llvm::Function *func = *funcOrErr;
 
+    // A void value cannot be named.
     auto callInst = m_Builder.CreateCall(
             func->getFunctionType(),
             func,
             argsValue,
-            "call" + name);
+            func->getReturnType()->isVoidTy() ? "" : "call" + name);
 
     return callInst;
 }
 
 llvm::Value *IRGenerator::generateMethodCall(ASTMethodCallNode *methodCall) {
-    auto structOrErr = m_YAPLContext->getCurrentScope()->lookup(methodCall->getName());
+    auto structOrErr = m_YAPLContext->getCurrentScope()->lookup(methodCall->getSymbol());
     
     if (auto err = structOrErr.takeError()) {
         m_DeferredErrors = llvm::joinErrors(std::move(m_DeferredErrors), std::move(err));
@@ -969,10 +1125,8 @@ llvm::Value *IRGenerator::generateMethodCall(ASTMethodCallNode *methodCall) {
 
     std::string typeName = structPtr->getType()->getPointerElementType()->getStructName().str();
 
-    auto structVar = m_Builder.CreateLoad(structPtr, "this");
-
     auto methodOrErr = m_YAPLContext->getCurrentScope()->lookupFunction(
-            typeName + "." + methodCall->getAttribute()
+            StringInterner::get().intern(typeName + "." + methodCall->getAttribute())
             );
 
     if (auto err = methodOrErr.takeError()) {
@@ -985,54 +1139,53 @@ llvm::Value *IRGenerator::generateMethodCall(ASTMethodCallNode *methodCall) {
     auto args = methodCall->getArgs();
     llvm::SmallVector<llvm::Value *, 5> argVals;
 
-    argVals.push_back(structVar);
+    // The alloca or the global of the struct, see generateMethod().
+    argVals.push_back(structPtr);
 
     for (const auto &arg : args) {
-        auto expr = generateExpr(arg.get());
+        auto expr = generateExpr(arg);
         argVals.push_back(expr);
     }
 
     auto callInst = m_Builder.CreateCall(
             method,
             argVals,
-            "call" + method->getName());
+            method->getReturnType()->isVoidTy() ? "" : "call" + method->getName());
 
     return callInst;
 }
 
 llvm::Value *IRGenerator::generateIf(ASTIfNode *ifNode) {
-    auto condExpr = ifNode->getCond();
-    auto condVal = generateExpr(condExpr);
-
     if (m_YAPLContext->isAtTopLevelScope()) {
         m_Logger.printError("Cannot have an if statement in top level scope.");
         return nullptr;
     }
-    
 
-    if (condVal->getType()->getTypeID() != llvm::Type::getDoubleTy(m_LLVMContext)->getTypeID()) {
-        condVal = m_Builder.CreateCast(
-                llvm::Instruction::CastOps::SIToFP,
-                condVal,
-                llvm::Type::getDoubleTy(m_LLVMContext),
-                "cast"
-                );
+    auto condVal = generateCondition(ifNode->getCond());
+    if (!condVal) {
+        return nullptr;
     }
 
     uint8_t numRet = 0;
 
-    condVal = m_Builder.CreateFCmpOGT(
-            condVal,
-            llvm::ConstantFP::get(m_LLVMContext, llvm::APFloat(0.0)),
-            "ifcond"
-            );
-
     llvm::Function *parentFunction = m_Builder.GetInsertBlock()->getParent();
     llvm::BasicBlock *thenBlock = llvm::BasicBlock::Create(m_LLVMContext, "then", parentFunction);
     llvm::BasicBlock *elseBlock = llvm::BasicBlock::Create(m_LLVMContext, "else");
     llvm::BasicBlock *mergeBlock = llvm::BasicBlock::Create(m_LLVMContext, "merge");
 
-    m_Builder.CreateCondBr(condVal, thenBlock, elseBlock);
+    llvm::MDNode *weights = nullptr;
+    switch (ifNode->getHint()) {
+        case BranchHint::likely:
+            weights = llvm::MDBuilder(m_LLVMContext).createBranchWeights(s_LikelyWeight, 1);
+            break;
+        case BranchHint::unlikely:
+            weights = llvm::MDBuilder(m_LLVMContext).createBranchWeights(1, s_LikelyWeight);
+            break;
+        case BranchHint::none:
+            break;
+    }
+
+    m_Builder.CreateCondBr(condVal, thenBlock, elseBlock, weights);
 
     m_Builder.SetInsertPoint(thenBlock);
 
@@ -1097,7 +1250,7 @@ llvm::Value *IRGenerator::generateFor(ASTForNode *forNode) {
 
     auto it = generateDeclaration(forNode->getDecl());
 
-    if (auto range = dynamic_cast<ASTRangeNode*>(forNode->getCond())) {
+    if (auto range = dyn_cast<ASTRangeNode>(forNode->getCond())) {
         auto startVal = generateExpr(range->getStart());
         auto stopVal = generateExpr(range->getStop());
         auto store = m_Builder.CreateStore(startVal, it);
@@ -1177,3 +1330,33 @@ llvm::Value *IRGenerator::generateFor(ASTForNode *forNode) {
     m_Logger.printError("For condition is expected to be a range");
     return nullptr;
 }
+
+llvm::Value *IRGenerator::generateCondition(ASTExprNode *cond) {
+    auto value = generateExpr(cond);
+    if (!value) {
+        return nullptr;
+    }
+
+    switch (cond->getConvertedType()) {
+        case ASTNode::BOOL:
+            return value;
+        case ASTNode::DOUBLE:
+            return m_Builder.CreateFCmpUNE(value, llvm::ConstantFP::get(value->getType(), 0.0), "ifcond");
+        default:
+            return m_Builder.CreateICmpNE(value, llvm::ConstantInt::get(value->getType(), 0), "ifcond");
+    }
+}
+
+llvm::Value *IRGenerator::convert(llvm::Value *value, ASTNode::TYPE from, ASTNode::TYPE to) {
+    if (!value || from == to) {
+        return value;
+    }
+
+    if (from == ASTNode::DOUBLE) {
+        return m_Builder.CreateFPToSI(value, ASTTypeToLLVM(to), "conv");
+    }
+    if (to == ASTNode::DOUBLE) {
+        return m_Builder.CreateSIToFP(value, ASTTypeToLLVM(to), "conv");
+    }
+    return m_Builder.CreateSExtOrTrunc(value, ASTTypeToLLVM(to), "conv");
+}
@@ -1,79 +1,112 @@
 #include "IRGenerator/Scope.hpp"
+#include <cassert>
+#include <llvm/Support/Casting.h>
 #include <llvm/Support/Error.h>
 
 char UndefindSymbolError::ID;
 char RedefinitionError::ID;
 
-llvm::Expected<llvm::Value *> Scope::lookupScope(llvm::StringRef searchValue) {
-    auto it = m_Values.find(searchValue);
-    if (it == m_Values.end()) {
-        return llvm::make_error<UndefindSymbolError>(searchValue);
-    }
+Scope::Scope() {
+    m_Frames.push_back({0, 0, nullptr});
+}
 
-    return it->second;
+bool Scope::find(const std::vector<uint32_t> &innermost, Symbol name, uint32_t base, uint32_t &slot) {
+    if (name.getId() >= innermost.size() || innermost[name.getId()] == 0) {
+        return false;
+    }
+    slot = innermost[name.getId()] - 1;
+    return slot >= base;
 }
 
-llvm::Expected<llvm::Function*> Scope::lookupFunctionScope(llvm::StringRef searchFunction) {
-    auto it = m_Functions.find(searchFunction);
+void Scope::bind(std::vector<Binding> &bindings, std::vector<uint32_t> &innermost, Symbol name,
+        llvm::Value *value) {
+    if (name.getId() >= innermost.size()) {
+        innermost.resize(name.getId() + 1, 0);
+    }
+    bindings.push_back({name, value, innermost[name.getId()]});
+    innermost[name.getId()] = (uint32_t)bindings.size();
+}
 
-    if (it == m_Functions.end()) {
-        return llvm::make_error<UndefindSymbolError>(searchFunction);
+void Scope::unbind(std::vector<Binding> &bindings, std::vector<uint32_t> &innermost, uint32_t base) {
+    while (bindings.size() > base) {
+        innermost[bindings.back().name.getId()] = bindings.back().shadowed;
+        bindings.pop_back();
     }
+}
 
-    return it->second;
+void Scope::pushScope() {
+    m_Frames.push_back({(uint32_t)m_Values.size(), (uint32_t)m_Functions.size(), m_Frames.back().currentFunction});
 }
 
-llvm::Expected<llvm::Value*> Scope::lookup(llvm::StringRef searchValue) {
-    auto it = m_Values.find(searchValue);
+void Scope::popScope() {
+    assert(!isAtTopLevel() && "popping the top-level scope");
+    unbind(m_Values, m_InnermostValues, m_Frames.back().valueBase);
+    unbind(m_Functions, m_InnermostFunctions, m_Frames.back().functionBase);
+    m_Frames.pop_back();
+}
 
-    if (it == m_Values.end()) {
-        if (m_ParentScope) {
-            return m_ParentScope->lookup(searchValue);
-        }
+llvm::Expected<llvm::Value *> Scope::lookupScope(Symbol searchValue) {
+    uint32_t slot;
+    if (!find(m_InnermostValues, searchValue, m_Frames.back().valueBase, slot)) {
+        return llvm::make_error<UndefindSymbolError>(searchValue.str());
+    }
 
-        return llvm::make_error<UndefindSymbolError>(searchValue);
+    return m_Values[slot].value;
+}
+
+llvm::Expected<llvm::Function*> Scope::lookupFunctionScope(Symbol searchFunction) {
+    uint32_t slot;
+    if (!find(m_InnermostFunctions, searchFunction, m_Frames.back().functionBase, slot)) {
+        return llvm::make_error<UndefindSymbolError>(searchFunction.str());
     }
-    
-    return it->second;
+
+    return llvm::cast<llvm::Function>(m_Functions[slot].value);
 }
 
-llvm::Expected<llvm::Function*> Scope::lookupFunction(llvm::StringRef searchFunction) {
-    auto it = m_Functions.find(searchFunction);
-    if (it == m_Functions.end()) {
-        if (m_ParentScope) {
-            return m_ParentScope->lookupFunction(searchFunction);
-        }
+llvm::Expected<llvm::Value*> Scope::lookup(Symbol searchValue) {
+    uint32_t slot;
+    if (!find(m_InnermostValues, searchValue, 0, slot)) {
+        return llvm::make_error<UndefindSymbolError>(searchValue.str());
+    }
 
-        return llvm::make_error<UndefindSymbolError>(searchFunction);
+    return m_Values[slot].value;
+}
+
+llvm::Expected<llvm::Function*> Scope::lookupFunction(Symbol searchFunction) {
+    uint32_t slot;
+    if (!find(m_InnermostFunctions, searchFunction, 0, slot)) {
+        return llvm::make_error<UndefindSymbolError>(searchFunction.str());
     }
-    
-    return it->second;
+
+    return llvm::cast<llvm::Function>(m_Functions[slot].value);
 }
 
 void Scope::setCurrentFunction(llvm::Function *func) {
-    m_CurrentFunction = func;
+    m_Frames.back().currentFunction = func;
 }
 
 llvm::Function *Scope::getCurrentFunction() {
-    return m_CurrentFunction;
+    return m_Frames.back().currentFunction;
 }
 
-llvm::Error Scope::pushValue(llvm::StringRef name, llvm::Value *value) {
-    if (m_Values.find(name) != m_Values.end()) {
-        return llvm::make_error<RedefinitionError>(name);
+llvm::Error Scope::pushValue(Symbol name, llvm::Value *value) {
+    uint32_t slot;
+    if (find(m_InnermostValues, name, m_Frames.back().valueBase, slot)) {
+        return llvm::make_error<RedefinitionError>(name.str());
     }
 
-    m_Values[name] = value;
+    bind(m_Values, m_InnermostValues, name, value);
 
     return llvm::Error::success();
 }
 
-llvm::Error Scope::pushFunction(llvm::StringRef name, llvm::Function *value) {
-    if (m_Functions.find(name) != m_Functions.end()) {
-        return llvm::make_error<RedefinitionError>(name);
+llvm::Error Scope::pushFunction(Symbol name, llvm::Function *value) {
+    uint32_t slot;
+    if (find(m_InnermostFunctions, name, m_Frames.back().functionBase, slot)) {
+        return llvm::make_error<RedefinitionError>(name.str());
     }
 
-    m_Functions[name] = value;
+    bind(m_Functions, m_InnermostFunctions, name, value);
 
     return llvm::Error::success();
 }
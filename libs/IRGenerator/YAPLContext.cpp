@@ -4,8 +4,8 @@
 #include <memory>
 #include <stdexcept>
 
-const std::shared_ptr<Scope> &YAPLContext::getCurrentScope() const {
-    return m_CurrentScope;
+Scope *YAPLContext::getCurrentScope() {
+    return &m_Scope;
 }
 
 void YAPLContext::addStruct(YAPLStruct t_Struct) {
@@ -25,24 +25,18 @@ YAPLStruct YAPLContext::getStruct(llvm::StringRef name) {
 }
 
 void YAPLContext::pushScope() {
-    auto newScope = Scope::Create(m_CurrentScope);
-    m_CurrentScope = newScope;
+    m_Scope.pushScope();
 }
 
 void YAPLContext::popScope() {
-    if (m_CurrentScope->getParentScope()) {
-        m_CurrentScope = m_CurrentScope->getParentScope();
-    } else {
+    if (m_Scope.isAtTopLevel()) {
         throw std::runtime_error("Trying to access a scope to high");
     }
+    m_Scope.popScope();
 }
 
 bool YAPLContext::isAtTopLevelScope() {
-    if (m_CurrentScope->getParentScope()) {
-        return false;
-    }
-
-    return true;
+    return m_Scope.isAtTopLevel();
 }
 
 void YAPLContext::addAttributeOffset(llvm::StringRef name, uint32_t offset) {
@@ -1,18 +1,23 @@
 #include "Lexer/Lexer.hpp"
+#include "Lexer/Keywords.hpp"
+#include "Lexer/Scanner.hpp"
 #include "CppLogger2/include/CppLogger.h"
 #include "CppLogger2/include/Format.h"
 #include "Lexer/TokenUtils.hpp"
+#include "Support/StringInterner.hpp"
 
+#include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ostream>
 #include <string>
-
-std::ostream& operator<<(std::ostream& os, const Position& pos){
-    os << pos.line << ":" << pos.column;
-    return os;
-}
+#include <string_view>
+#include <vector>
 
 std::ostream& operator<<(std::ostream& os, const Token& token){
     os << "Token: " << tokenToString(token.token) << " / Identifier: " << token.identifier;
@@ -22,40 +27,62 @@ std::ostream& operator<<(std::ostream& os, const Token& token){
 Lexer::Lexer(const std::string& filepath)
     :m_Logger(CppLogger::Level::Trace, "Lexer")
 {
-
-    CppLogger::Format format({
-            CppLogger::FormatAttribute::Name,
-            CppLogger::FormatAttribute::Message
-    });
-
-    m_Logger.setFormat(format);
+    setupLogger();
 
     if (!filepath.empty()) {
-        pFile = fopen(filepath.c_str(), "r");
-        if (pFile == nullptr) {
-            m_Logger.printError("Cannot open file: {}\nExiting!!", filepath);
+        auto buffer = SourceBuffer::fromFile(filepath);
+        if (buffer == nullptr) {
+            m_Logger.printError("Cannot open file: {}: {}\nExiting!!", filepath, std::strerror(errno));
             exit(EXIT_FAILURE);
         }
+        setOwnedBuffer(std::move(buffer));
     } else {
-        pFile = stdin;
+        setOwnedBuffer(SourceBuffer::fromStream(stdin));
     }
 }
 
 Lexer::Lexer(FILE* file)
     :m_Logger(CppLogger::Level::Trace, "Lexer")
 {
+    setupLogger();
+
+    setOwnedBuffer(SourceBuffer::fromStream(file));
+    fclose(file);
+}
 
+Lexer::Lexer(std::unique_ptr<SourceBuffer> buffer)
+    :m_Logger(CppLogger::Level::Trace, "Lexer")
+{
+    setupLogger();
+    setOwnedBuffer(std::move(buffer));
+}
+
+Lexer::Lexer(const SourceBuffer &buffer, uint32_t begin, uint32_t end)
+    :m_Logger(CppLogger::Level::Trace, "Lexer"), m_Buffer(&buffer),
+    m_RangeBegin(buffer.begin() + begin), m_RangeEnd(buffer.begin() + end)
+{
+    setupLogger();
+}
+
+void Lexer::setOwnedBuffer(std::unique_ptr<SourceBuffer> buffer) {
+    // Only a source too large for 32-bit offsets has no buffer.
+    if (buffer == nullptr) {
+        m_Logger.printError("The source is larger than 4 GiB\nExiting!!");
+        exit(EXIT_FAILURE);
+    }
+    m_OwnedBuffer = std::move(buffer);
+    m_Buffer = m_OwnedBuffer.get();
+    m_RangeBegin = m_Buffer->begin();
+    m_RangeEnd = m_Buffer->end();
+}
+
+void Lexer::setupLogger() {
     CppLogger::Format format({
             CppLogger::FormatAttribute::Name,
             CppLogger::FormatAttribute::Message
     });
 
     m_Logger.setFormat(format);
-
-    pFile = file;
-}
-Lexer::~Lexer(){
-    fclose(pFile);
 }
 
 Token Lexer::peekToken() {
@@ -63,379 +90,489 @@ Token Lexer::peekToken() {
 }
 
 int Lexer::getNextChar(){
-    m_CurrentChar = getc(pFile);
-    if (m_CurrentChar == '\n') {
-        m_Pos.line++;
-        m_Pos.column = 0;
+    m_CurPtr = m_CurPtr ? m_CurPtr + 1 : m_RangeBegin;
+    if (m_CurPtr < m_RangeEnd) {
+        m_CurrentChar = (unsigned char)*m_CurPtr;
     } else {
-        m_Pos.column++;
+        m_CurPtr = m_RangeEnd;
+        m_CurrentChar = EOF;
     }
-    m_Pos.character++;
     return m_CurrentChar;
 }
 
-Token Lexer::getNextToken(){
-    std::string identifier;
-    std::string numVal;
+void Lexer::skipTo(const char *ptr) {
+    m_CurPtr = ptr;
+    m_CurrentChar = ptr < m_RangeEnd ? (unsigned char)*ptr : EOF;
+}
 
-    if (m_CurrentChar == '\0') {
-        getNextChar();
-    }
+void Lexer::setSource(std::unique_ptr<SourceBuffer> buffer) {
+    setOwnedBuffer(std::move(buffer));
+    m_SourceManager.reset();
+    m_CurPtr = nullptr;
+    m_CurrentChar = '\0';
+    m_CurrentToken = {token::unknown, ""};
+}
 
-    while (std::isspace(m_CurrentChar)) {
-        getNextChar();
+SourceManager &Lexer::getSourceManager() {
+    if (!m_SourceManager) {
+        m_SourceManager = std::make_unique<SourceManager>(*m_Buffer);
     }
+    return *m_SourceManager;
+}
 
-    if(m_CurrentChar == EOF) {
-        m_CurrentToken = {token::eof, "", m_Pos};
-        return m_CurrentToken;
+std::vector<uint32_t> Lexer::findChunkBoundaries(const SourceBuffer &source, size_t chunkCount) {
+    const char *begin = source.begin();
+    const char *end = source.end();
+    const size_t chunkSize = source.size() / std::max<size_t>(chunkCount, 1);
+
+    std::vector<uint32_t> boundaries = {0};
+
+    // Strings are lexed as separate tokens, so comments are the only state
+    // that matters. `ptr` is never inside of a comment, it only has to stop
+    // on the ones that start before the next candidate boundary.
+    const char *ptr = begin;
+    while (boundaries.size() < chunkCount) {
+        const char *target = std::max(ptr, begin + boundaries.size() * chunkSize);
+        const char *lineEnd = scan::findLineEnd(target, end);
+        if (end - lineEnd <= 1) {
+            break;
+        }
+
+        auto slash = (const char *)std::memchr(ptr, '/', lineEnd - ptr);
+        if (slash == nullptr) {
+            boundaries.push_back(lineEnd + 1 - begin);
+            ptr = lineEnd + 1;
+        } else if (slash[1] == '/') {
+            // Stop on the newline ending the comment, it is a valid boundary.
+            ptr = scan::findLineEnd(slash + 2, end);
+        } else if (slash[1] == '*') {
+            const char *commentEnd = scan::findBlockCommentEnd(slash + 2, end);
+            ptr = commentEnd == end ? end : commentEnd + 2;
+        } else {
+            ptr = slash + 1;
+        }
     }
 
-    if (std::isalpha(m_CurrentChar)) {
-        identifier = (char)m_CurrentChar;
-        getNextChar();
+    boundaries.push_back(source.size());
+    return boundaries;
+}
 
-        while (std::isalnum(m_CurrentChar) || m_CurrentChar == '_') {
-            identifier += (char)m_CurrentChar;
-            getNextChar();
-        }
+uint32_t Lexer::findLastBoundary(const SourceBuffer &source, uint32_t begin, uint32_t end) {
+    const char *ptr = source.begin() + begin;
+    const char *last = ptr;
+    const char *limit = source.begin() + end;
 
-        if(identifier == "int") {
-            m_CurrentToken = {token::type, "int", m_Pos};
-            return m_CurrentToken;
+    while (ptr < limit) {
+        auto slash = (const char *)std::memchr(ptr, '/', limit - ptr);
+        const char *normalEnd = slash ? slash : limit;
+        for (const char *newline = scan::findLineEnd(ptr, normalEnd); newline != normalEnd;
+                newline = scan::findLineEnd(newline + 1, normalEnd)) {
+            last = newline + 1;
         }
 
-        if (identifier == "float" || identifier == "double") {
-            m_CurrentToken = {token::type, "double", m_Pos};
-            return m_CurrentToken;
+        // Comments that are not terminated yet may still swallow anything.
+        if (slash == nullptr || slash + 1 == limit) {
+            break;
         }
-
-        if (identifier == "void") {
-            m_CurrentToken = {token::type, "void", m_Pos};
-            return m_CurrentToken;
+        if (slash[1] == '/') {
+            const char *lineEnd = scan::findLineEnd(slash + 2, limit);
+            if (lineEnd == limit) {
+                break;
+            }
+            last = lineEnd + 1;
+            ptr = lineEnd + 1;
+        } else if (slash[1] == '*') {
+            const char *commentEnd = scan::findBlockCommentEnd(slash + 2, limit);
+            if (commentEnd == limit) {
+                break;
+            }
+            ptr = commentEnd + 2;
+        } else {
+            ptr = slash + 1;
         }
+    }
 
-        if (identifier == "bool") {
-            m_CurrentToken = {token::type, "bool", m_Pos};
-            return m_CurrentToken;
-        }
+    return last - source.begin();
+}
 
-        if (identifier == "string") {
-            m_CurrentToken = {token::type, "string", m_Pos};
-            return m_CurrentToken;
-        }
+bool Lexer::endsOutsideComments(const SourceBuffer &source, uint32_t begin, uint32_t end) {
+    const char *ptr = source.begin() + begin;
+    const char *limit = source.begin() + end;
 
-        if (identifier == "struct") {
-            m_CurrentToken = {token::structlabel, "", m_Pos};
-            return m_CurrentToken;
+    while (ptr < limit) {
+        auto slash = (const char *)std::memchr(ptr, '/', limit - ptr);
+        if (slash == nullptr) {
+            return true;
         }
-
-        if (identifier == "func") {
-            m_CurrentToken = {token::func, "", m_Pos};
-            return m_CurrentToken;
+        // The next character may start a comment with this one.
+        if (slash + 1 == limit) {
+            return false;
         }
-
-        if (identifier == "for") {
-            m_CurrentToken = {token::forlabel, "", m_Pos};
-            return m_CurrentToken;
+        if (slash[1] == '/') {
+            const char *lineEnd = scan::findLineEnd(slash + 2, limit);
+            if (lineEnd == limit) {
+                return false;
+            }
+            ptr = lineEnd + 1;
+        } else if (slash[1] == '*') {
+            const char *commentEnd = scan::findBlockCommentEnd(slash + 2, limit);
+            if (commentEnd + 1 >= limit) {
+                return false;
+            }
+            ptr = commentEnd + 2;
+        } else {
+            ptr = slash + 1;
         }
+    }
+    return true;
+}
 
-        if (identifier == "while") {
-            m_CurrentToken = {token::whilelabel, "", m_Pos};
-            return m_CurrentToken;
-        }
+static const char *skipRadixDigits(const char *ptr, const char *end, int base) {
+    while (ptr < end && (base == 16 ? std::isxdigit((unsigned char)*ptr) : (*ptr == '0' || *ptr == '1'))) {
+        ptr++;
+    }
+    return ptr;
+}
 
-        if (identifier == "if") {
-            m_CurrentToken = {token::iflabel, "", m_Pos};
-            return m_CurrentToken;
-        }
+static bool parseDouble(std::string_view spelling, double &value) {
+#if defined(__cpp_lib_to_chars)
+    auto [ptr, ec] = std::from_chars(spelling.data(), spelling.data() + spelling.size(), value);
+    return ec == std::errc();
+#else
+    // No floating point from_chars in this standard library: strtod needs a
+    // terminated string, literals are short enough for a stack copy.
+    char buffer[128];
+    if (spelling.size() >= sizeof(buffer)) {
+        return false;
+    }
+    std::memcpy(buffer, spelling.data(), spelling.size());
+    buffer[spelling.size()] = '\0';
 
-        if (identifier == "else") {
-            m_CurrentToken = {token::elselabel, "", m_Pos};
-            return m_CurrentToken;
-        }
+    errno = 0;
+    value = std::strtod(buffer, nullptr);
+    return errno != ERANGE;
+#endif
+}
 
-        if (identifier == "in") {
-            m_CurrentToken = {token::inlabel, "", m_Pos};
-            return m_CurrentToken;
-        }
+Token Lexer::lexNumber(const char *start) {
+    const char *end = m_RangeEnd;
+    const bool negative = *start == '-';
 
-        if (identifier == "true") {
-            m_CurrentToken = {token::truelabel, "", m_Pos};
-            return m_CurrentToken;
+    int base = 10;
+    if (m_CurrentChar == '0' && m_CurPtr + 1 < end) {
+        if (m_CurPtr[1] == 'x' || m_CurPtr[1] == 'X') {
+            base = 16;
+        } else if (m_CurPtr[1] == 'b' || m_CurPtr[1] == 'B') {
+            base = 2;
         }
+    }
 
-        if (identifier == "false") {
-            m_CurrentToken = {token::falselabel, "", m_Pos};
-            return m_CurrentToken;
-        }
+    // A prefix without any digit is a 0 followed by an identifier.
+    if (base != 10 && skipRadixDigits(m_CurPtr + 2, end, base) != m_CurPtr + 2) {
+        const char *digits = m_CurPtr + 2;
+        skipTo(skipRadixDigits(digits, end, base));
 
-        if (identifier == "import") {
-            m_CurrentToken = {token::importlabel, "", m_Pos};
-            return m_CurrentToken;
-        }
+        uint64_t bits = 0;
+        auto [ptr, ec] = std::from_chars(digits, m_CurPtr, bits, base);
 
-        if (identifier == "export") {
-            m_CurrentToken = {token::exportlalbel, "", m_Pos};
+        m_CurrentToken = {token::int_value, sliceFrom(start), getTokenOffset()};
+        if (ec != std::errc()) {
+            m_Logger.printError("{}: Integer literal {} does not fit in 64 bits",
+                    getSourceManager().getLocation(getTokenOffset()), m_CurrentToken.identifier);
+            m_CurrentToken.token = token::unknown;
             return m_CurrentToken;
         }
 
-        if (identifier == "return") {
-            m_CurrentToken = {token::returnlabel, "", m_Pos};
-            return m_CurrentToken;
-        }
-        m_CurrentToken = {token::identifier, identifier, m_Pos};
+        // Hexadecimal and binary literals spell out the bits, 0xFFFFFFFFFFFFFFFF is -1.
+        m_CurrentToken.intValue = (int64_t)(negative ? 0 - bits : bits);
         return m_CurrentToken;
     }
 
-    if (std::isdigit(m_CurrentChar)) {
-        bool isFloat = false;
-        numVal += (char)m_CurrentChar;
+    if (m_CurrentChar != '.') {
+        skipTo(scan::skipDigits(m_CurPtr + 1, end));
+    }
+    const bool isFloat = m_CurrentChar == '.';
+    if (isFloat) {
+        skipTo(scan::skipDigits(m_CurPtr + 1, end));
+    }
+
+    m_CurrentToken = {isFloat ? token::float_value : token::int_value, sliceFrom(start), getTokenOffset()};
+    const std::string_view numVal = m_CurrentToken.identifier;
+
+    bool inRange;
+    if (isFloat) {
+        inRange = parseDouble(numVal, m_CurrentToken.floatValue);
+    } else {
+        auto [ptr, ec] = std::from_chars(numVal.data(), numVal.data() + numVal.size(), m_CurrentToken.intValue);
+        inRange = ec == std::errc();
+    }
+
+    if (!inRange) {
+        m_Logger.printError("{}: Numeric literal {} is out of range",
+                getSourceManager().getLocation(getTokenOffset()), numVal);
+        m_CurrentToken.token = token::unknown;
+    }
+
+    return m_CurrentToken;
+}
+
+Token Lexer::getNextToken(){
+    if (m_CurrentChar == '\0') {
         getNextChar();
-        while (std::isdigit(m_CurrentChar) || (!isFloat && m_CurrentChar == '.')) {
-            if (m_CurrentChar == '.') {
-                isFloat = true;
-            }
-            numVal += (char)m_CurrentChar;
-            getNextChar();
-        }
+    }
+
+    if (std::isspace(m_CurrentChar)) {
+        skipTo(scan::skipWhitespace(m_CurPtr, m_RangeEnd));
+    }
+
+    m_TokenStart = m_CurPtr;
+
+    if(m_CurrentChar == EOF) {
+        m_CurrentToken = {token::eof, "", getTokenOffset()};
+        return m_CurrentToken;
+    }
+
+    if (std::isalpha(m_CurrentChar)) {
+        const char *start = m_CurPtr;
+        skipTo(scan::skipIdentifier(m_CurPtr + 1, m_RangeEnd));
 
-        m_CurrentToken = isFloat ? Token{token::float_value, numVal} :
-            Token{token::int_value, numVal, m_Pos};
+        std::string_view identifier = sliceFrom(start);
 
+        const Keyword keyword = lookupKeyword(identifier);
+        if (keyword.token != token::identifier) {
+            m_CurrentToken = {keyword.token, keyword.spelling, getTokenOffset()};
+            return m_CurrentToken;
+        }
+
+        m_CurrentToken = {token::identifier, identifier, getTokenOffset(), StringInterner::get().intern(identifier)};
         return m_CurrentToken;
     }
 
+    if (std::isdigit(m_CurrentChar)) {
+        return lexNumber(m_CurPtr);
+    }
+
     if (std::ispunct(m_CurrentChar)) {
-        identifier = (char)m_CurrentChar;
+        const char *start = m_CurPtr;
+        char punct = (char)m_CurrentChar;
 
         getNextChar();
 
-        if (identifier  == "(") {
-            m_CurrentToken = {token::paropen, "", m_Pos};
+        if (punct == '(') {
+            m_CurrentToken = {token::paropen, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == ")" ) {
-            m_CurrentToken = {token::parclose, "", m_Pos};
+        if (punct == ')') {
+            m_CurrentToken = {token::parclose, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "{") {
-            m_CurrentToken = {token::bopen, "", m_Pos};
+        if (punct == '{') {
+            m_CurrentToken = {token::bopen, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "}") {
-            m_CurrentToken = {token::bclose, "", m_Pos};
+        if (punct == '}') {
+            m_CurrentToken = {token::bclose, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "[") {
-            m_CurrentToken = {token::iopen, "", m_Pos};
+        if (punct == '[') {
+            m_CurrentToken = {token::iopen, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "]") {
-            m_CurrentToken = {token::iclose, "", m_Pos};
+        if (punct == ']') {
+            m_CurrentToken = {token::iclose, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "=") {
+        if (punct == '=') {
             if (m_CurrentChar == '=') {
                 getNextChar();
-                m_CurrentToken = {token::eqcomp, "", m_Pos};
+                m_CurrentToken = {token::eqcomp, "", getTokenOffset()};
                 return m_CurrentToken;
             }
-            m_CurrentToken = {token::eq, "", m_Pos};
+            m_CurrentToken = {token::eq, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "+") {
-            m_CurrentToken = {token::plus, "", m_Pos};
+        if (punct == '+') {
+            m_CurrentToken = {token::plus, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "-") {
+        if (punct == '-') {
             if (m_CurrentChar == '>') {
                 getNextChar();
-                m_CurrentToken = {token::arrow_op, "", m_Pos};
+                m_CurrentToken = {token::arrow_op, "", getTokenOffset()};
                 return m_CurrentToken;
             } else if (std::isdigit(m_CurrentChar)) {
-                bool isFloat = false;
-                std::string numVal = "-";
-                numVal += (char)m_CurrentChar;
-                getNextChar();
-                while (std::isdigit(m_CurrentChar) || (!isFloat && m_CurrentChar == '.')) {
-                    numVal += (char)m_CurrentChar;
-                    if (m_CurrentChar == '.') {
-                        isFloat = true;
-                    }
-                    getNextChar();
-                }
-                m_CurrentToken = {isFloat ? token::float_value : token:: int_value, numVal, m_Pos};
-                return m_CurrentToken;
+                return lexNumber(start);
             }
-            m_CurrentToken = {token::minus, "", m_Pos};
+            m_CurrentToken = {token::minus, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "/") {
+        if (punct == '/') {
             if (m_CurrentChar == '/') {
-                getNextChar();
-                while (m_CurrentChar != '\n') {
-                    getNextChar();
-                }
+                skipTo(scan::findLineEnd(m_CurPtr + 1, m_RangeEnd));
                 return getNextToken();
             }
             if (m_CurrentChar == '*') {
-                getNextChar();
-                while (true) {
-                    if (m_CurrentChar == '*') {
-                        getNextChar();
-                        if (m_CurrentChar == '/') {
-                            return getNextToken();
-                        }
-                    }
-                    getNextChar();
-                }
+                const char *end = m_RangeEnd;
+                const char *commentEnd = scan::findBlockCommentEnd(m_CurPtr + 1, end);
+                skipTo(commentEnd == end ? end : commentEnd + 2);
+                return getNextToken();
             }
-            m_CurrentToken = {token::divide, "", m_Pos};
+            m_CurrentToken = {token::divide, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "*") {
-            m_CurrentToken = {token::times, "", m_Pos};
+        if (punct == '*') {
+            m_CurrentToken = {token::times, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "%") {
-            m_CurrentToken = {token::mod, "", m_Pos};
+        if (punct == '%') {
+            m_CurrentToken = {token::mod, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "<") {
+        if (punct == '<') {
             if (m_CurrentChar == '=') {
                 getNextChar();
-                m_CurrentToken = {token::leq, "", m_Pos};
+                m_CurrentToken = {token::leq, "", getTokenOffset()};
                 return m_CurrentToken;
             } else if (m_CurrentChar == '.') {
                 getNextChar();
                 if (m_CurrentChar == '.') {
                     getNextChar();
-                    m_CurrentToken = {token::fromoreto, "", m_Pos};
+                    m_CurrentToken = {token::fromoreto, "", getTokenOffset()};
                     return m_CurrentToken;
                 }
-                identifier += ".";
-                identifier += (char)m_CurrentChar;
-                m_CurrentToken = {token::unknown, identifier, m_Pos};
+                m_CurrentToken = {token::unknown, sliceUnknown(start), getTokenOffset()};
                 return m_CurrentToken;
             }
-            m_CurrentToken = {token::lth, "", m_Pos};
+            m_CurrentToken = {token::lth, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == ">") {
+        if (punct == '>') {
             if (m_CurrentChar == '=') {
                 getNextChar();
-                m_CurrentToken = {token::meq, "", m_Pos};
+                m_CurrentToken = {token::meq, "", getTokenOffset()};
                 return m_CurrentToken;
             }
-            m_CurrentToken = {token::mth, "", m_Pos};
+            m_CurrentToken = {token::mth, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "!") {
+        if (punct == '!') {
             if (m_CurrentChar == '=') {
                 getNextChar();
-                m_CurrentToken = {token::neq, "", m_Pos};
+                m_CurrentToken = {token::neq, "", getTokenOffset()};
                 return m_CurrentToken;
             }
             m_Logger.printWarn("Unary operation not yet supported please avoid using them."
-                    "At position: {}:{}", m_Pos.line, m_Pos.column);
-            m_CurrentToken = {token::notsym, "", m_Pos};
+                    "At position: {}", getSourceManager().getLocation(getTokenOffset()));
+            m_CurrentToken = {token::notsym, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == ";") {
-            m_CurrentToken = {token::semicolon, "", m_Pos};
+        if (punct == ';') {
+            m_CurrentToken = {token::semicolon, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == ",") {
-            m_CurrentToken = {token::comma, "", m_Pos};
+        if (punct == ',') {
+            m_CurrentToken = {token::comma, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == ".") {
+        if (punct == '.') {
             if (std::isdigit(m_CurrentChar)) {
-                std::string numVal = ".";
-                numVal += (char)m_CurrentChar;
-                getNextChar();
-                while (std::isdigit(m_CurrentChar)) {
-                    numVal += (char)m_CurrentChar;
-                    getNextChar();
-                }
-                m_CurrentToken = {token::float_value, numVal, m_Pos};
-                return m_CurrentToken;
+                skipTo(start);
+                return lexNumber(start);
             }
             if (m_CurrentChar == '.') {
                 getNextChar();
                 if (m_CurrentChar == '.') {
                     getNextChar();
-                    m_CurrentToken = {token::fromto, "", m_Pos};
+                    m_CurrentToken = {token::fromto, "", getTokenOffset()};
                     return m_CurrentToken;
                 }
                 if (m_CurrentChar == '<') {
                     getNextChar();
-                    m_CurrentToken = {token::fromtol, "", m_Pos};
+                    m_CurrentToken = {token::fromtol, "", getTokenOffset()};
                     return m_CurrentToken;
                 }
                 if (m_CurrentChar == '-') {
                     getNextChar();
-                    m_CurrentToken = {token::fromtominus, "", m_Pos};
+                    m_CurrentToken = {token::fromtominus, "", getTokenOffset()};
                     return m_CurrentToken;
                 }
-                identifier += ".";
-                identifier += (char)m_CurrentChar;
-                return {token::unknown, identifier, m_Pos};
+                return {token::unknown, sliceUnknown(start), getTokenOffset()};
             }
-            m_CurrentToken = {token::point, "", m_Pos};
+            m_CurrentToken = {token::point, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == ":") {
+        if (punct == ':') {
             if (m_CurrentChar == ':') {
                 getNextChar();
-                m_CurrentToken = {token::access_sym, "", m_Pos};
+                m_CurrentToken = {token::access_sym, "", getTokenOffset()};
                 return m_CurrentToken;
             }
-            m_CurrentToken = {token::colon, "", m_Pos};
+            m_CurrentToken = {token::colon, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "|") {
-            m_CurrentToken = {token::orsym, "", m_Pos};
+        if (punct == '|') {
+            if (m_CurrentChar == '|') {
+                getNextChar();
+                m_CurrentToken = {token::ororsym, "", getTokenOffset()};
+                return m_CurrentToken;
+            }
+            m_CurrentToken = {token::orsym, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "&") {
-            m_CurrentToken = {token::andsym, "", m_Pos};
+        if (punct == '&') {
+            if (m_CurrentChar == '&') {
+                getNextChar();
+                m_CurrentToken = {token::andandsym, "", getTokenOffset()};
+                return m_CurrentToken;
+            }
+            m_CurrentToken = {token::andsym, "", getTokenOffset()};
+            return m_CurrentToken;
+        }
+
+        if (punct == '?') {
+            m_CurrentToken = {token::question, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "\"") {
-            m_CurrentToken = {token::dquote, "", m_Pos};
+        if (punct == '"') {
+            m_CurrentToken = {token::dquote, "", getTokenOffset()};
             return m_CurrentToken;
         }
 
-        if (identifier == "'") {
-            m_CurrentToken = {token::squote, "", m_Pos};
+        if (punct == '\'') {
+            m_CurrentToken = {token::squote, "", getTokenOffset()};
             return m_CurrentToken;
         }
+
+        m_CurrentToken = {token::unknown, sliceFrom(start), getTokenOffset()};
+        return m_CurrentToken;
     }
 
-    m_CurrentToken = {m_CurrentChar, "", m_Pos};
+    // Anything else (control or non ASCII characters) is consumed as an
+    // unknown token, so that the lexer always makes progress.
+    const char *start = m_CurPtr;
+    getNextChar();
+    m_CurrentToken = {token::unknown, sliceFrom(start), getTokenOffset()};
     return m_CurrentToken;
 }
 
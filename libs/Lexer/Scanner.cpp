@@ -0,0 +1,300 @@
+#include "Lexer/Scanner.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SCAN_HAS_X86 1
+#include <immintrin.h>
+#define SCAN_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+// Scalar kernels, also used to finish the tail of the vectorized ones.
+
+static inline bool isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static inline bool isIdentifierChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static const char *skipWhitespaceScalar(const char *ptr, const char *end) {
+    while (ptr < end && isSpace(*ptr)) {
+        ptr++;
+    }
+    return ptr;
+}
+
+static const char *skipIdentifierScalar(const char *ptr, const char *end) {
+    while (ptr < end && isIdentifierChar(*ptr)) {
+        ptr++;
+    }
+    return ptr;
+}
+
+static const char *skipDigitsScalar(const char *ptr, const char *end) {
+    while (ptr < end && *ptr >= '0' && *ptr <= '9') {
+        ptr++;
+    }
+    return ptr;
+}
+
+static const char *findLineEndScalar(const char *ptr, const char *end) {
+    while (ptr < end && *ptr != '\n') {
+        ptr++;
+    }
+    return ptr;
+}
+
+static const char *findBlockCommentEndScalar(const char *ptr, const char *end) {
+    for (; ptr + 1 < end; ptr++) {
+        if (ptr[0] == '*' && ptr[1] == '/') {
+            return ptr;
+        }
+    }
+    return end;
+}
+
+static size_t countNewlinesScalar(const char *ptr, const char *end) {
+    size_t count = 0;
+    for (; ptr < end; ptr++) {
+        count += *ptr == '\n';
+    }
+    return count;
+}
+
+// SSE2 kernels, 16 bytes at a time. Bytes above 0x7f are negative for the
+// signed comparisons, so they never fall inside an ASCII range.
+
+#ifdef __SSE2__
+static inline __m128i inRangeSSE2(__m128i chunk, char low, char high) {
+    return _mm_and_si128(
+            _mm_cmpgt_epi8(chunk, _mm_set1_epi8(low - 1)),
+            _mm_cmplt_epi8(chunk, _mm_set1_epi8(high + 1)));
+}
+
+static const char *skipWhitespaceSSE2(const char *ptr, const char *end) {
+    for (; ptr + 16 <= end; ptr += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)ptr);
+        __m128i space = _mm_or_si128(
+                _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+                inRangeSSE2(chunk, '\t', '\r'));
+        uint32_t mask = ~(uint32_t)_mm_movemask_epi8(space) & 0xFFFF;
+        if (mask) {
+            return ptr + __builtin_ctz(mask);
+        }
+    }
+    return skipWhitespaceScalar(ptr, end);
+}
+
+static const char *skipIdentifierSSE2(const char *ptr, const char *end) {
+    for (; ptr + 16 <= end; ptr += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)ptr);
+        __m128i lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+        __m128i ident = _mm_or_si128(
+                _mm_or_si128(inRangeSSE2(lower, 'a', 'z'), inRangeSSE2(chunk, '0', '9')),
+                _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')));
+        uint32_t mask = ~(uint32_t)_mm_movemask_epi8(ident) & 0xFFFF;
+        if (mask) {
+            return ptr + __builtin_ctz(mask);
+        }
+    }
+    return skipIdentifierScalar(ptr, end);
+}
+
+static const char *skipDigitsSSE2(const char *ptr, const char *end) {
+    for (; ptr + 16 <= end; ptr += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)ptr);
+        uint32_t mask = ~(uint32_t)_mm_movemask_epi8(inRangeSSE2(chunk, '0', '9')) & 0xFFFF;
+        if (mask) {
+            return ptr + __builtin_ctz(mask);
+        }
+    }
+    return skipDigitsScalar(ptr, end);
+}
+
+static const char *findLineEndSSE2(const char *ptr, const char *end) {
+    for (; ptr + 16 <= end; ptr += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)ptr);
+        uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')));
+        if (mask) {
+            return ptr + __builtin_ctz(mask);
+        }
+    }
+    return findLineEndScalar(ptr, end);
+}
+
+static const char *findBlockCommentEndSSE2(const char *ptr, const char *end) {
+    for (; ptr + 17 <= end; ptr += 16) {
+        __m128i star = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)ptr), _mm_set1_epi8('*'));
+        __m128i slash = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(ptr + 1)), _mm_set1_epi8('/'));
+        uint32_t mask = _mm_movemask_epi8(_mm_and_si128(star, slash));
+        if (mask) {
+            return ptr + __builtin_ctz(mask);
+        }
+    }
+    return findBlockCommentEndScalar(ptr, end);
+}
+
+static size_t countNewlinesSSE2(const char *ptr, const char *end) {
+    size_t count = 0;
+    for (; ptr + 16 <= end; ptr += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)ptr);
+        count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))));
+    }
+    return count + countNewlinesScalar(ptr, end);
+}
+#endif
+
+// AVX2 kernels, 32 bytes at a time. They are compiled for AVX2 regardless of
+// the global flags and only called when the CPU supports it.
+
+#ifdef SCAN_HAS_X86
+SCAN_TARGET_AVX2 static inline __m256i inRangeAVX2(__m256i chunk, char low, char high) {
+    return _mm256_and_si256(
+            _mm256_cmpgt_epi8(chunk, _mm256_set1_epi8(low - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), chunk));
+}
+
+SCAN_TARGET_AVX2 static const char *skipWhitespaceAVX2(const char *ptr, const char *end) {
+    for (; ptr + 32 <= end; ptr += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)ptr);
+        __m256i space = _mm256_or_si256(
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')),
+                inRangeAVX2(chunk, '\t', '\r'));
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(space);
+        if (mask) {
+            return ptr + __builtin_ctz(mask);
+        }
+    }
+    return skipWhitespaceScalar(ptr, end);
+}
+
+SCAN_TARGET_AVX2 static const char *skipIdentifierAVX2(const char *ptr, const char *end) {
+    for (; ptr + 32 <= end; ptr += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)ptr);
+        __m256i lower = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+        __m256i ident = _mm256_or_si256(
+                _mm256_or_si256(inRangeAVX2(lower, 'a', 'z'), inRangeAVX2(chunk, '0', '9')),
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('_')));
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(ident);
+        if (mask) {
+            return ptr + __builtin_ctz(mask);
+        }
+    }
+    return skipIdentifierScalar(ptr, end);
+}
+
+SCAN_TARGET_AVX2 static const char *skipDigitsAVX2(const char *ptr, const char *end) {
+    for (; ptr + 32 <= end; ptr += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)ptr);
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(inRangeAVX2(chunk, '0', '9'));
+        if (mask) {
+            return ptr + __builtin_ctz(mask);
+        }
+    }
+    return skipDigitsScalar(ptr, end);
+}
+
+SCAN_TARGET_AVX2 static const char *findLineEndAVX2(const char *ptr, const char *end) {
+    for (; ptr + 32 <= end; ptr += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)ptr);
+        uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')));
+        if (mask) {
+            return ptr + __builtin_ctz(mask);
+        }
+    }
+    return findLineEndScalar(ptr, end);
+}
+
+SCAN_TARGET_AVX2 static const char *findBlockCommentEndAVX2(const char *ptr, const char *end) {
+    for (; ptr + 33 <= end; ptr += 32) {
+        __m256i star = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)ptr), _mm256_set1_epi8('*'));
+        __m256i slash = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(ptr + 1)), _mm256_set1_epi8('/'));
+        uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(star, slash));
+        if (mask) {
+            return ptr + __builtin_ctz(mask);
+        }
+    }
+    return findBlockCommentEndScalar(ptr, end);
+}
+
+SCAN_TARGET_AVX2 static size_t countNewlinesAVX2(const char *ptr, const char *end) {
+    size_t count = 0;
+    for (; ptr + 32 <= end; ptr += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)ptr);
+        count += __builtin_popcount(
+                (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))));
+    }
+    return count + countNewlinesScalar(ptr, end);
+}
+#endif
+
+// Runtime dispatch
+
+struct ScanKernels {
+    const char *name;
+    const char *(*skipWhitespace)(const char *, const char *);
+    const char *(*skipIdentifier)(const char *, const char *);
+    const char *(*skipDigits)(const char *, const char *);
+    const char *(*findLineEnd)(const char *, const char *);
+    const char *(*findBlockCommentEnd)(const char *, const char *);
+    size_t (*countNewlines)(const char *, const char *);
+};
+
+static ScanKernels selectKernels() {
+#ifdef SCAN_HAS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {
+            "avx2", skipWhitespaceAVX2, skipIdentifierAVX2, skipDigitsAVX2,
+            findLineEndAVX2, findBlockCommentEndAVX2, countNewlinesAVX2
+        };
+    }
+#endif
+#ifdef __SSE2__
+    return {
+        "sse2", skipWhitespaceSSE2, skipIdentifierSSE2, skipDigitsSSE2,
+        findLineEndSSE2, findBlockCommentEndSSE2, countNewlinesSSE2
+    };
+#else
+    return {
+        "scalar", skipWhitespaceScalar, skipIdentifierScalar, skipDigitsScalar,
+        findLineEndScalar, findBlockCommentEndScalar, countNewlinesScalar
+    };
+#endif
+}
+
+static const ScanKernels &getKernels() {
+    static const ScanKernels kernels = selectKernels();
+    return kernels;
+}
+
+const char *scan::skipWhitespace(const char *ptr, const char *end) {
+    return getKernels().skipWhitespace(ptr, end);
+}
+
+const char *scan::skipIdentifier(const char *ptr, const char *end) {
+    return getKernels().skipIdentifier(ptr, end);
+}
+
+const char *scan::skipDigits(const char *ptr, const char *end) {
+    return getKernels().skipDigits(ptr, end);
+}
+
+const char *scan::findLineEnd(const char *ptr, const char *end) {
+    return getKernels().findLineEnd(ptr, end);
+}
+
+const char *scan::findBlockCommentEnd(const char *ptr, const char *end) {
+    return getKernels().findBlockCommentEnd(ptr, end);
+}
+
+size_t scan::countNewlines(const char *ptr, const char *end) {
+    return getKernels().countNewlines(ptr, end);
+}
+
+const char *scan::getImplementationName() {
+    return getKernels().name;
+}
@@ -0,0 +1,167 @@
+#include "Lexer/SourceBuffer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr size_t s_ReadBlockSize = 64 * 1024;
+// Keeps a byte for the sentinel.
+static constexpr size_t s_MaxStreamSize = SourceBuffer::s_MaxSize + 1;
+
+SourceBuffer::~SourceBuffer() {
+    if (m_Mapping) {
+        munmap(m_Mapping, m_MappingSize);
+    }
+}
+
+void SourceBuffer::setOwnedBuffer(std::string buffer) {
+    m_OwnedBuffer = std::move(buffer);
+    // std::string guarantees the trailing '\0' used as sentinel.
+    m_BufferStart = m_OwnedBuffer.c_str();
+    m_BufferEnd = m_BufferStart + m_OwnedBuffer.size();
+}
+
+std::unique_ptr<SourceBuffer> SourceBuffer::fromFile(const std::string &filepath) {
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    auto fileSize = (size_t)fileStat.st_size;
+    if (fileSize > s_MaxSize) {
+        close(fd);
+        errno = EFBIG;
+        return nullptr;
+    }
+
+    auto buffer = std::unique_ptr<SourceBuffer>(new SourceBuffer());
+    auto pageSize = (size_t)sysconf(_SC_PAGESIZE);
+
+    // The zero filled tail of the last page is our sentinel, so a file whose
+    // size is a multiple of the page size cannot be mapped.
+    if (S_ISREG(fileStat.st_mode) && fileSize != 0 && fileSize % pageSize != 0) {
+        void *mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            close(fd);
+            buffer->m_Mapping = mapping;
+            buffer->m_MappingSize = fileSize;
+            buffer->m_BufferStart = static_cast<const char *>(mapping);
+            buffer->m_BufferEnd = buffer->m_BufferStart + fileSize;
+            return buffer;
+        }
+    }
+
+    std::string content;
+    content.reserve(fileSize);
+    char block[s_ReadBlockSize];
+    ssize_t readSize;
+    while ((readSize = read(fd, block, s_ReadBlockSize)) > 0) {
+        content.append(block, readSize);
+        // Pipes and devices have no size to check up front.
+        if (content.size() > s_MaxSize) {
+            close(fd);
+            errno = EFBIG;
+            return nullptr;
+        }
+    }
+    close(fd);
+
+    if (readSize < 0) {
+        return nullptr;
+    }
+
+    buffer->setOwnedBuffer(std::move(content));
+    return buffer;
+}
+
+std::unique_ptr<SourceBuffer> SourceBuffer::fromStream(FILE *file) {
+    std::string content;
+    char block[s_ReadBlockSize];
+    size_t readSize;
+    while ((readSize = fread(block, 1, s_ReadBlockSize, file)) > 0) {
+        content.append(block, readSize);
+        if (content.size() > s_MaxSize) {
+            return nullptr;
+        }
+    }
+
+    return fromString(std::move(content));
+}
+
+std::unique_ptr<SourceBuffer> SourceBuffer::fromString(std::string source) {
+    if (source.size() > s_MaxSize) {
+        return nullptr;
+    }
+    auto buffer = std::unique_ptr<SourceBuffer>(new SourceBuffer());
+    buffer->setOwnedBuffer(std::move(source));
+    return buffer;
+}
+
+std::unique_ptr<SourceBuffer> SourceBuffer::fromMemory(std::string_view source) {
+    if (source.size() > s_MaxSize) {
+        return nullptr;
+    }
+    auto buffer = std::unique_ptr<SourceBuffer>(new SourceBuffer());
+    buffer->m_BufferStart = source.data();
+    buffer->m_BufferEnd = source.data() + source.size();
+    return buffer;
+}
+
+std::unique_ptr<SourceBuffer> SourceBuffer::forStream(FILE *file) {
+    void *mapping = mmap(nullptr, s_MaxStreamSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return fromStream(file);
+    }
+
+    auto buffer = std::unique_ptr<SourceBuffer>(new SourceBuffer());
+    buffer->m_Mapping = mapping;
+    buffer->m_MappingSize = s_MaxStreamSize;
+    buffer->m_BufferStart = static_cast<const char *>(mapping);
+    buffer->m_BufferEnd = buffer->m_BufferStart;
+    buffer->m_Stream = file;
+    return buffer;
+}
+
+bool SourceBuffer::readBlock() {
+    if (m_Stream == nullptr) {
+        return false;
+    }
+
+    // Anonymous mappings are zero filled, keeping the last byte free keeps
+    // the sentinel.
+    // Once it is full, one more byte tells whether the stream ends there.
+    const size_t room = m_MappingSize - size() - 1;
+    char next;
+    ssize_t readSize;
+    do {
+        readSize = room == 0 ? read(fileno(m_Stream), &next, 1) :
+            read(fileno(m_Stream), static_cast<char *>(m_Mapping) + size(), std::min(room, s_ReadBlockSize));
+    } while (readSize < 0 && errno == EINTR);
+
+    if (readSize <= 0) {
+        m_Stream = nullptr;
+        return false;
+    }
+    if (room == 0) {
+        fputs("The source is larger than 4 GiB\nExiting!!\n", stderr);
+        exit(EXIT_FAILURE);
+    }
+
+    m_BufferEnd += readSize;
+    return true;
+}
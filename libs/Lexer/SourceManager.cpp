@@ -0,0 +1,32 @@
+#include "Lexer/SourceManager.hpp"
+#include "Lexer/Scanner.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+std::ostream& operator<<(std::ostream& os, const SourceLocation& location) {
+    os << location.line << ":" << location.column;
+    return os;
+}
+
+void SourceManager::extendLineTable(uint32_t offset) {
+    const char *begin = m_Buffer.begin();
+    const char *end = begin + offset;
+
+    m_LineStarts.reserve(m_LineStarts.size() + scan::countNewlines(begin + m_ScannedUpTo, end));
+    for (const char *ptr = scan::findLineEnd(begin + m_ScannedUpTo, end); ptr != end; ptr = scan::findLineEnd(ptr + 1, end)) {
+        m_LineStarts.push_back(ptr + 1 - begin);
+    }
+    m_ScannedUpTo = offset;
+}
+
+SourceLocation SourceManager::getLocation(uint32_t offset) {
+    if (offset > m_ScannedUpTo) {
+        extendLineTable(offset);
+    }
+
+    auto lineIt = std::upper_bound(m_LineStarts.begin(), m_LineStarts.end(), offset) - 1;
+    auto line = (uint32_t)(lineIt - m_LineStarts.begin());
+
+    return {line + 1, offset - *lineIt + 1};
+}
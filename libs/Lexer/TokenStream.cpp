@@ -0,0 +1,285 @@
+#include "Lexer/TokenStream.hpp"
+#include "Lexer/TokenUtils.hpp"
+#include "Support/SpscQueue.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Lexer thread of a pipelined stream and the queue of batches it sends. The
+// queue is only touched once per batch, and a batch is also sent every time
+// the lexer reaches the end of what has been read from an incremental stream.
+class TokenStream::Pipeline {
+private:
+    static constexpr size_t s_BatchSize = 4096;
+
+    SpscQueue<std::unique_ptr<TokenStream>, 16> m_Queue;
+    std::thread m_Thread;
+
+    // Lexes [begin, end), its eof is only sent when `last`.
+    bool sendRange(const SourceBuffer &source, uint32_t begin, uint32_t end, bool last) {
+        Lexer lexer(source, begin, end);
+        auto batch = std::unique_ptr<TokenStream>(new TokenStream(source.begin()));
+
+        Token tok;
+        do {
+            tok = lexer.getNextToken();
+            if (tok != token::eof || last) {
+                batch->push(tok);
+            }
+            if (batch->size() == s_BatchSize) {
+                if (!m_Queue.push(std::move(batch))) {
+                    return false;
+                }
+                batch.reset(new TokenStream(source.begin()));
+            }
+        } while (tok != token::eof);
+
+        return batch->size() == 0 || m_Queue.push(std::move(batch));
+    }
+
+    void run(const SourceBuffer &source, SourceBuffer *stream) {
+        if (stream == nullptr) {
+            sendRange(source, 0, source.size(), true);
+            m_Queue.close();
+            return;
+        }
+
+        // Only the text up to the last boundary is lexed, the end of the
+        // block may be in the middle of a token or of a comment.
+        uint32_t lexed = 0;
+        while (stream->readBlock()) {
+            uint32_t boundary = Lexer::findLastBoundary(source, lexed, stream->size());
+            if (boundary != lexed) {
+                if (!sendRange(source, lexed, boundary, false)) {
+                    return;
+                }
+                lexed = boundary;
+            }
+        }
+
+        sendRange(source, lexed, stream->size(), true);
+        m_Queue.close();
+    }
+
+public:
+    Pipeline(const SourceBuffer &source, SourceBuffer *stream)
+        : m_Thread([this, &source, stream]() { run(source, stream); })
+    {}
+
+    // Stops the lexer thread if the stream is not read until the end.
+    ~Pipeline() {
+        m_Queue.close();
+        m_Thread.join();
+    }
+
+    bool receive(std::unique_ptr<TokenStream> &batch) { return m_Queue.pop(batch); }
+};
+
+TokenStream::TokenStream(const char *source)
+    : m_Source(source)
+{}
+
+TokenStream::TokenStream(Lexer &lexer)
+    : m_Source(lexer.getSource().begin())
+{
+    // Roughly one token every five bytes of source.
+    size_t expected = lexer.getRange().size() / 5 + 1;
+    m_Kinds.reserve(expected);
+    m_Offsets.reserve(expected);
+    m_Payloads.reserve(expected);
+
+    Token tok;
+    do {
+        tok = lexer.getNextToken();
+        push(tok);
+    } while (tok != token::eof);
+}
+
+TokenStream::TokenStream(const SourceBuffer &source, unsigned threadCount)
+    : m_Source(source.begin())
+{
+    const std::vector<uint32_t> boundaries = Lexer::findChunkBoundaries(source, std::max(threadCount, 1u));
+    const size_t chunkCount = boundaries.size() - 1;
+
+    std::vector<std::unique_ptr<TokenStream>> chunks(chunkCount);
+    std::vector<std::thread> workers;
+    workers.reserve(chunkCount);
+    for (size_t i = 0; i < chunkCount; i++) {
+        workers.emplace_back([&, i]() {
+            Lexer lexer(source, boundaries[i], boundaries[i + 1]);
+            chunks[i] = std::make_unique<TokenStream>(lexer);
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    size_t tokenCount = 1;
+    for (const auto &chunk : chunks) {
+        tokenCount += chunk->size() - 1;
+    }
+    m_Kinds.reserve(tokenCount);
+    m_Offsets.reserve(tokenCount);
+    m_Payloads.reserve(tokenCount);
+
+    // Every chunk ends with its own eof, only the last one is kept.
+    for (size_t i = 0; i < chunkCount; i++) {
+        append(*chunks[i], i + 1 == chunkCount);
+    }
+}
+
+TokenStream::TokenStream(TokenStream &&) noexcept = default;
+TokenStream &TokenStream::operator=(TokenStream &&) noexcept = default;
+TokenStream::~TokenStream() = default;
+
+TokenStream TokenStream::tokenize(Lexer &lexer) {
+    const unsigned threadCount = std::thread::hardware_concurrency();
+    if (threadCount > 1 && lexer.getSource().size() >= ParallelThreshold) {
+        return TokenStream(lexer.getSource(), threadCount);
+    }
+    return TokenStream(lexer);
+}
+
+TokenStream TokenStream::pipeline(Lexer &lexer) {
+    SourceBuffer *stream = lexer.getOwnedSource();
+    if (stream != nullptr && !stream->isIncremental()) {
+        stream = nullptr;
+    }
+
+    TokenStream tokens(lexer.getSource().begin());
+    tokens.m_Pipeline = std::make_unique<Pipeline>(lexer.getSource(), stream);
+    return tokens;
+}
+
+void TokenStream::push(const Token &tok) {
+    uint32_t payload = 0;
+    if (tok == token::identifier || tok == token::type) {
+        payload = tok == token::type ?
+            StringInterner::get().intern(tok.identifier).getId() : tok.symbol.getId();
+    } else if (tok == token::int_value || tok == token::float_value) {
+        payload = m_Literals.size();
+        Literal literal;
+        if (tok == token::int_value) {
+            literal.intValue = tok.intValue;
+        } else {
+            literal.floatValue = tok.floatValue;
+        }
+        literal.length = tok.identifier.size();
+        m_Literals.push_back(literal);
+    } else if (tok == token::unknown) {
+        payload = tok.identifier.size();
+    }
+
+    m_Kinds.push_back((int8_t)tok.token);
+    m_Offsets.push_back(tok.offset);
+    m_Payloads.push_back(payload);
+}
+
+void TokenStream::append(const TokenStream &other, bool withEof) {
+    size_t count = other.size();
+    if (!withEof && count > 0 && other.m_Kinds.back() == token::eof) {
+        count--;
+    }
+    const auto literalBase = (uint32_t)m_Literals.size();
+
+    m_Kinds.insert(m_Kinds.end(), other.m_Kinds.begin(), other.m_Kinds.begin() + count);
+    m_Offsets.insert(m_Offsets.end(), other.m_Offsets.begin(), other.m_Offsets.begin() + count);
+    for (size_t i = 0; i < count; i++) {
+        const bool isLiteral = other.m_Kinds[i] == token::int_value || other.m_Kinds[i] == token::float_value;
+        m_Payloads.push_back(isLiteral ? other.m_Payloads[i] + literalBase : other.m_Payloads[i]);
+    }
+    m_Literals.insert(m_Literals.end(), other.m_Literals.begin(), other.m_Literals.end());
+}
+
+void TokenStream::splice(size_t begin, size_t end, const TokenStream &tokens, int64_t delta, const char *source) {
+    size_t count = tokens.size();
+    if (count > 0 && tokens.m_Kinds.back() == token::eof) {
+        count--;
+    }
+    const auto literalBase = (uint32_t)m_Literals.size();
+
+    auto replace = [&](auto &values, const auto &newValues) {
+        values.erase(values.begin() + begin, values.begin() + end);
+        values.insert(values.begin() + begin, newValues.begin(), newValues.begin() + count);
+    };
+    replace(m_Kinds, tokens.m_Kinds);
+    replace(m_Offsets, tokens.m_Offsets);
+    replace(m_Payloads, tokens.m_Payloads);
+    m_Literals.insert(m_Literals.end(), tokens.m_Literals.begin(), tokens.m_Literals.end());
+
+    for (size_t i = begin; i < begin + count; i++) {
+        if (m_Kinds[i] == token::int_value || m_Kinds[i] == token::float_value) {
+            m_Payloads[i] += literalBase;
+        }
+    }
+    for (size_t i = begin + count; i < m_Offsets.size(); i++) {
+        m_Offsets[i] += delta;
+    }
+    m_Source = source;
+}
+
+void TokenStream::receive(size_t index) {
+    std::unique_ptr<TokenStream> batch;
+    while (index >= m_Kinds.size()) {
+        if (!m_Pipeline->receive(batch)) {
+            // The lexer is done, the last batch ended with the eof.
+            m_Pipeline.reset();
+            return;
+        }
+        append(*batch, true);
+    }
+}
+
+Symbol TokenStream::getSymbol(size_t index) const {
+    index = clamp(index);
+    if (m_Kinds[index] == token::identifier || m_Kinds[index] == token::type) {
+        return Symbol(m_Payloads[index]);
+    }
+    return Symbol();
+}
+
+std::string_view TokenStream::getSpelling(size_t index) const {
+    index = clamp(index);
+    switch (m_Kinds[index]) {
+        case token::identifier:
+        case token::type:
+            return Symbol(m_Payloads[index]).str();
+        case token::int_value:
+        case token::float_value:
+            return {m_Source + m_Offsets[index], m_Literals[m_Payloads[index]].length};
+        case token::unknown:
+            return {m_Source + m_Offsets[index], m_Payloads[index]};
+        default:
+            return "";
+    }
+}
+
+const TokenStream::Literal &TokenStream::getLiteral(size_t index) const {
+    static const Literal none = {{0}, 0};
+    index = clamp(index);
+    if (m_Kinds[index] == token::int_value || m_Kinds[index] == token::float_value) {
+        return m_Literals[m_Payloads[index]];
+    }
+    return none;
+}
+
+int64_t TokenStream::getIntValue(size_t index) const {
+    return getKind(index) == token::int_value ? getLiteral(index).intValue : 0;
+}
+
+double TokenStream::getFloatValue(size_t index) const {
+    return getKind(index) == token::float_value ? getLiteral(index).floatValue : 0.0;
+}
+
+Token TokenStream::getToken(size_t index) const {
+    Token tok = {getKind(index), getSpelling(index), getOffset(index), getSymbol(index)};
+    if (tok == token::int_value) {
+        tok.intValue = getIntValue(index);
+    } else if (tok == token::float_value) {
+        tok.floatValue = getFloatValue(index);
+    }
+    return tok;
+}
@@ -2,21 +2,61 @@
 #include "AST/ASTExprNode.hpp"
 #include "AST/ASTNode.hpp"
 #include "AST/ASTStatementNode.hpp"
+#include "AST/ASTVisitor.hpp"
 #include "CppLogger2/include/CppLogger.h"
 #include "CppLogger2/include/Format.h"
 #include "Lexer/TokenUtils.hpp"
+#include "Support/Casting.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 //#define LOG_PARSER
 
-Parser::Parser(std::string filepath, CppLogger::Level level)
-    : m_Logger(level, "Parser"), m_Lexer(filepath)
+static Lexer openSource(const std::string &filepath, bool pipelined) {
+    if (filepath.empty() && pipelined) {
+        return Lexer(SourceBuffer::forStream(stdin));
+    }
+    return Lexer(filepath);
+}
+
+Parser::Parser(std::string filepath, CppLogger::Level level, bool pipelined)
+    : m_Logger(level, "Parser"), m_Lexer(openSource(filepath, pipelined)),
+    m_OwnedTokens(pipelined ? TokenStream::pipeline(m_Lexer) : TokenStream::tokenize(m_Lexer)),
+    m_Tokens(m_OwnedTokens), m_Program(std::make_unique<ASTProgramNode>())
 {
+    setupLogger();
+    m_Tokens.require(s_MaxLookahead);
+}
+
+Parser::Parser(std::unique_ptr<SourceBuffer> source, CppLogger::Level level, bool pipelined)
+    : m_Logger(level, "Parser"), m_Lexer(std::move(source)),
+    m_OwnedTokens(pipelined ? TokenStream::pipeline(m_Lexer) : TokenStream::tokenize(m_Lexer)),
+    m_Tokens(m_OwnedTokens), m_Program(std::make_unique<ASTProgramNode>())
+{
+    setupLogger();
+    m_Tokens.require(s_MaxLookahead);
+}
+
+// The lexer and the token stream of a worker are empty, it only reads the
+// tokens of its parent, which are complete and never written to again.
+Parser::Parser(Parser &parent, size_t begin)
+    : m_Logger(CppLogger::Level::Warn, "Parser"), m_Lexer(parent.m_Lexer.getSource(), 0, 0),
+    m_OwnedTokens(m_Lexer), m_Tokens(parent.m_Tokens), m_Cursor(begin),
+    m_Program(std::make_unique<ASTProgramNode>()), m_Deferred(true)
+{}
+
+void Parser::setupLogger() {
     CppLogger::Format format({
             CppLogger::FormatAttribute::Name,
             CppLogger::FormatAttribute::Level,
@@ -50,972 +90,1445 @@ int Parser::getOpPrecedence(Operator t_Operator){
         case Operator::neq:
             return 10;
         case Operator::andsym:
-            return 14;
+            return 11;
         case Operator::orsym:
+            return 13;
+        case Operator::andandsym:
+            return 14;
+        case Operator::ororsym:
             return 15;
     }
 }
 
+bool Parser::toBinaryOperator(int kind, Operator &t_Operator) {
+    switch (kind) {
+        case token::plus:
+            t_Operator = Operator::plus;
+            return true;
+        case token::minus:
+            t_Operator = Operator::minus;
+            return true;
+        case token::times:
+            t_Operator = Operator::times;
+            return true;
+        case token::divide:
+            t_Operator = Operator::divide;
+            return true;
+        case token::mod:
+            t_Operator = Operator::mod;
+            return true;
+        case token::lth:
+            t_Operator = Operator::lth;
+            return true;
+        case token::mth:
+            t_Operator = Operator::mth;
+            return true;
+        case token::orsym:
+            t_Operator = Operator::orsym;
+            return true;
+        case token::andsym:
+            t_Operator = Operator::andsym;
+            return true;
+        case token::andandsym:
+            t_Operator = Operator::andandsym;
+            return true;
+        case token::ororsym:
+            t_Operator = Operator::ororsym;
+            return true;
+        case token::eqcomp:
+            t_Operator = Operator::eqcomp;
+            return true;
+        case token::leq:
+            t_Operator = Operator::leq;
+            return true;
+        case token::meq:
+            t_Operator = Operator::meq;
+            return true;
+        case token::neq:
+            t_Operator = Operator::neq;
+            return true;
+        default:
+            return false;
+    }
+}
+
 void Parser::parse() {
-    std::vector<std::unique_ptr<ASTNode>> nodes;
-    while (m_Lexer.peekToken().token != token::eof) {
-        auto node = parseNext();
-        nodes.push_back(std::move(node));
+    const unsigned threadCount = std::thread::hardware_concurrency();
+    if (threadCount > 1 && m_Tokens.isComplete() && m_Tokens.size() - m_Cursor >= s_ParallelThreshold &&
+            parseParallel(threadCount)) {
+        return;
     }
 
-    m_Program = std::make_unique<ASTProgramNode>(std::move(nodes));
+    while (peek() != token::eof) {
+        parseTopLevel();
+    }
 }
 
-std::unique_ptr<ASTProgramNode> Parser::getProgram() {
-    return std::move(m_Program);
+void Parser::parseTopLevel() {
+    const size_t start = m_Cursor;
+    const size_t bytes = m_Program->getContext().getBytesAllocated();
+    ASTNode *node = parseNext();
+    const size_t nodeBytes = m_Program->getContext().getBytesAllocated() - bytes;
+    if (node != nullptr) {
+        m_NodeTokens.push_back(start);
+        m_NodeBytes.push_back(nodeBytes);
+        m_Program->addNode(node);
+    } else {
+        m_DeadBytes += nodeBytes;
+    }
 }
 
-std::unique_ptr<ASTNode> Parser::parseNext() {
-    parseInfo("next");
-
-    if (m_CurrentToken == token::semicolon) {
-        m_CurrentToken = m_Lexer.getNextToken();
+bool Parser::parseParallel(unsigned threadCount) {
+    if (!m_Tokens.isComplete() || threadCount < 2) {
+        return false;
     }
 
-    if (m_CurrentToken.token == token::importlabel) {
-        return parseImport();
+    // Ranges of about the same number of tokens, each starting on a
+    // top-level declaration.
+    const DeclarationScan scan = scanDeclarations();
+    const size_t eofIndex = m_Tokens.size() - 1;
+    std::vector<size_t> bounds = {m_Cursor};
+    for (size_t start : scan.starts) {
+        if (bounds.size() == threadCount) {
+            break;
+        }
+        if (start >= m_Cursor + (eofIndex - m_Cursor) * bounds.size() / threadCount) {
+            bounds.push_back(start);
+        }
     }
-
-    if (m_CurrentToken == token::exportlalbel) {
-        return parseExport();
+    if (bounds.size() < 2) {
+        return false;
     }
+    bounds.push_back(eofIndex);
 
-    if (m_CurrentToken == token::type) {
-        return parseDeclaration();
+    // A worker knows the structs declared before its range, like the
+    // sequential parse does when it reaches it.
+    const size_t rangeCount = bounds.size() - 1;
+    std::vector<std::unique_ptr<Parser>> workers;
+    phmap::flat_hash_set<Symbol> structNames = m_StructNames;
+    auto nextStruct = scan.structs.begin();
+    for (size_t i = 0; i < rangeCount; i++) {
+        for (; nextStruct != scan.structs.end() && nextStruct->first < bounds[i]; ++nextStruct) {
+            structNames.insert(nextStruct->second);
+        }
+        workers.push_back(std::unique_ptr<Parser>(new Parser(*this, bounds[i])));
+        workers.back()->m_StructNames = structNames;
     }
 
-    if (m_CurrentToken == token::bopen) {
-        m_Logger.printError("A block must be inside a function");
-        return parseBlock();
+    auto parseRange = [](Parser &worker, size_t end) {
+        while (worker.m_Cursor < end && worker.peek() != token::eof) {
+            worker.parseTopLevel();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < rangeCount; i++) {
+        threads.emplace_back(parseRange, std::ref(*workers[i]), bounds[i + 1]);
     }
-
-    if (m_CurrentToken == token::iflabel) {
-        return parseIf();
+    parseRange(*workers[0], bounds[1]);
+    for (auto &thread : threads) {
+        thread.join();
     }
 
-    if (m_CurrentToken == token::forlabel) {
-        return parseFor();
+    // A declaration that runs past the end of its range means the split
+    // was wrong, the next range did not start on a statement.
+    for (size_t i = 0; i < rangeCount; i++) {
+        if (workers[i]->m_HasDiagnostics || workers[i]->m_Cursor != bounds[i + 1]) {
+            return false;
+        }
     }
 
-    if (m_CurrentToken == token::func) {
-        return parseFunctionDefinition();
+    for (auto &worker : workers) {
+        m_Program->merge(std::move(*worker->m_Program));
+        m_NodeTokens.insert(m_NodeTokens.end(), worker->m_NodeTokens.begin(), worker->m_NodeTokens.end());
+        m_NodeBytes.insert(m_NodeBytes.end(), worker->m_NodeBytes.begin(), worker->m_NodeBytes.end());
+        m_DeadBytes += worker->m_DeadBytes;
     }
-
-    if (m_CurrentToken == token::structlabel) {
-        return parseStructDefintion();
+    for (const auto &[index, name] : scan.structs) {
+        m_StructNames.insert(name);
     }
+    m_Cursor = eofIndex;
+    return true;
+}
 
-    if (m_CurrentToken == token::returnlabel) {
-        return parseReturn();
+Parser::DeclarationScan Parser::scanDeclarations() const {
+    DeclarationScan scan;
+    size_t depth = 0;
+    for (size_t i = m_Cursor; i < m_Tokens.size(); i++) {
+        switch (m_Tokens.getKind(i)) {
+            case token::bopen:
+                depth++;
+                break;
+            case token::bclose: {
+                if (depth == 0 || --depth > 0) {
+                    break;
+                }
+                const int next = m_Tokens.getKind(i + 1);
+                if (next == token::func || next == token::coldlabel || next == token::structlabel ||
+                        next == token::exportlalbel) {
+                    scan.starts.push_back(i + 1);
+                }
+                break;
+            }
+            case token::structlabel:
+                if (depth == 0 && m_Tokens.getKind(i + 1) == token::identifier) {
+                    scan.structs.emplace_back(i, m_Tokens.getSymbol(i + 1));
+                }
+                break;
+            default:
+                break;
+        }
     }
+    return scan;
+}
 
-    if (m_CurrentToken == token::identifier) {
-        return parseLabel(m_CurrentToken.identifier);
+// Name of the struct a top-level node declares, if any.
+static Symbol getDeclaredStruct(const ASTNode *node) {
+    if (auto exportNode = dyn_cast<ASTExportNode>(node)) {
+        node = exportNode->getModule();
     }
-
-    return parseExpr();
+    auto structNode = dyn_cast<ASTStructDefinitionNode>(node);
+    return structNode != nullptr ? structNode->getSymbol() : Symbol();
 }
 
-std::unique_ptr<ASTNode> Parser::parseNextBlock() {
-    parseInfo("next");
-
-    if (m_CurrentToken == token::semicolon) {
-        m_CurrentToken = m_Lexer.getNextToken();
+// Nodes after an edit cannot start at 0, those at 0 were given no location.
+static void moveOffsets(ASTNode *node, int64_t delta) {
+    if (node->getOffset() != 0) {
+        node->setOffset(node->getOffset() + delta);
     }
+    forEachChild(node, [delta](ASTNode *child) { moveOffsets(child, delta); });
+}
 
-    if (m_CurrentToken.token == token::importlabel) {
-        return parseImport();
+bool Parser::applyEdit(uint32_t offset, uint32_t removed, std::string_view inserted) {
+    const std::string_view source = m_Lexer.getSource().getBuffer();
+    assert(m_Tokens.isComplete() && offset + removed <= source.size() && "invalid edit");
+
+    std::string text;
+    text.reserve(source.size() - removed + inserted.size());
+    text.append(source.substr(0, offset)).append(inserted).append(source.substr(offset + removed));
+    const int64_t delta = (int64_t)inserted.size() - (int64_t)removed;
+    auto buffer = SourceBuffer::fromString(std::move(text));
+    if (buffer == nullptr) {
+        m_Logger.printError("The edited source is larger than 4 GiB, the edit is ignored");
+        return false;
+    }
+
+    if (m_NodeTokens.empty()) {
+        m_Lexer.setSource(std::move(buffer));
+        reparseAll();
+        return false;
+    }
+
+    // Reparsed nodes go from the one holding the byte before the edit, a
+    // token of which may be extended by the edit, to the one holding the
+    // first byte after it. The text around the region is left as it was.
+    auto findNode = [this](uint32_t position) -> size_t {
+        auto it = std::upper_bound(m_NodeTokens.begin() + 1, m_NodeTokens.end(), position,
+            [this](uint32_t position, size_t token) { return position < m_Tokens.getOffset(token); });
+        return it - m_NodeTokens.begin() - 1;
+    };
+    const size_t first = findNode(offset == 0 ? 0 : offset - 1);
+    const size_t last = findNode(offset + removed);
+    const size_t eofToken = m_Tokens.size() - 1;
+    // Tokens before the first node are a statement that had a syntax error.
+    const size_t beginToken = first == 0 ? 0 : m_NodeTokens[first];
+    const size_t endToken = last + 1 < m_NodeTokens.size() ? m_NodeTokens[last + 1] : eofToken;
+    const uint32_t regionBegin = first == 0 ? 0 : m_Tokens.getOffset(beginToken);
+    const auto regionEnd = (uint32_t)(endToken == eofToken ? buffer->size() : m_Tokens.getOffset(endToken) + delta);
+
+    if (endToken != eofToken && !Lexer::endsOutsideComments(*buffer, regionBegin, regionEnd)) {
+        m_Lexer.setSource(std::move(buffer));
+        reparseAll();
+        return false;
+    }
+
+    Lexer regionLexer(*buffer, regionBegin, regionEnd);
+    const TokenStream regionTokens(regionLexer);
+    m_Lexer.setSource(std::move(buffer));
+    m_Tokens.splice(beginToken, endToken, regionTokens, delta, m_Lexer.getSource().begin());
+
+    const int64_t tokenDelta = (int64_t)(regionTokens.size() - 1) - (int64_t)(endToken - beginToken);
+    for (size_t i = last + 1; i < m_NodeTokens.size(); i++) {
+        m_NodeTokens[i] += tokenDelta;
+    }
+
+    // The diagnostics of the region are found again by its parse, those
+    // after it move with their tokens.
+    const auto regionDiagnostics = std::partition_point(m_Diagnostics.begin(), m_Diagnostics.end(),
+        [beginToken](const Diagnostic &diagnostic) { return diagnostic.token < beginToken; });
+    std::vector<Diagnostic> laterDiagnostics;
+    for (auto it = regionDiagnostics; it != m_Diagnostics.end(); ++it) {
+        if (it->token >= endToken) {
+            laterDiagnostics.push_back({(size_t)(it->token + tokenDelta), it->isError});
+        }
     }
+    m_Diagnostics.erase(regionDiagnostics, m_Diagnostics.end());
 
-    if (m_CurrentToken == token::exportlalbel) {
-        return parseExport();
+    // Struct names as the sequential parse knew them when it reached `first`.
+    const std::vector<ASTNode*> oldNodes(m_Program->begin(), m_Program->end());
+    m_StructNames.clear();
+    for (size_t i = 0; i < first; i++) {
+        if (Symbol name = getDeclaredStruct(oldNodes[i]); !name.empty()) {
+            m_StructNames.insert(name);
+        }
     }
 
-    if (m_CurrentToken == token::type) {
-        return parseDeclaration();
+    // Parse until an old node starts where the cursor is, which can be
+    // further than the region if the edit merged declarations.
+    std::vector<ASTNode*> nodes;
+    std::vector<size_t> nodeTokens, nodeBytes;
+    size_t kept = last + 1;
+    m_Cursor = beginToken;
+    while (peek() != token::eof) {
+        while (kept < m_NodeTokens.size() && m_NodeTokens[kept] < m_Cursor) {
+            kept++;
+        }
+        if (kept < m_NodeTokens.size() && m_NodeTokens[kept] == m_Cursor) {
+            break;
+        }
+        const size_t start = m_Cursor;
+        const size_t bytes = m_Program->getContext().getBytesAllocated();
+        ASTNode *node = parseNext();
+        const size_t allocated = m_Program->getContext().getBytesAllocated() - bytes;
+        if (node != nullptr) {
+            nodeTokens.push_back(start);
+            nodeBytes.push_back(allocated);
+            nodes.push_back(node);
+        } else {
+            m_DeadBytes += allocated;
+        }
     }
-
-    if (m_CurrentToken == token::bopen) {
-        return parseBlock();
+    if (peek() == token::eof) {
+        kept = m_NodeTokens.size();
     }
 
-    if (m_CurrentToken == token::iflabel) {
-        return parseIf();
+    // Kept nodes were parsed knowing the structs declared before them.
+    if (kept < m_NodeTokens.size()) {
+        std::vector<Symbol> oldStructs, newStructs;
+        for (size_t i = first; i < kept; i++) {
+            if (Symbol name = getDeclaredStruct(oldNodes[i]); !name.empty()) {
+                oldStructs.push_back(name);
+            }
+        }
+        for (ASTNode *node : nodes) {
+            if (Symbol name = getDeclaredStruct(node); !name.empty()) {
+                newStructs.push_back(name);
+            }
+        }
+        if (oldStructs != newStructs) {
+            reparseAll();
+            return false;
+        }
     }
 
-    if (m_CurrentToken == token::forlabel) {
-        return parseFor();
+    for (size_t i = kept; i < oldNodes.size(); i++) {
+        if (oldNodes[i] != nullptr) {
+            moveOffsets(oldNodes[i], delta);
+        }
+        if (Symbol name = getDeclaredStruct(oldNodes[i]); !name.empty()) {
+            m_StructNames.insert(name);
+        }
     }
+    // Diagnostics after the region are kept, unless the parse went on over
+    // their tokens and found them again.
+    for (const Diagnostic &diagnostic : laterDiagnostics) {
+        if (kept < m_NodeTokens.size() && diagnostic.token >= m_Cursor) {
+            m_Diagnostics.push_back(diagnostic);
+        }
+    }
+    m_ErrorCount = std::count_if(m_Diagnostics.begin(), m_Diagnostics.end(),
+        [](const Diagnostic &diagnostic) { return diagnostic.isError; });
+    m_HasDiagnostics = !m_Diagnostics.empty();
+
+    m_Program->replaceNodes(first, kept, nodes);
+    m_NodeTokens.erase(m_NodeTokens.begin() + first, m_NodeTokens.begin() + kept);
+    m_NodeTokens.insert(m_NodeTokens.begin() + first, nodeTokens.begin(), nodeTokens.end());
+    for (size_t i = first; i < kept; i++) {
+        m_DeadBytes += m_NodeBytes[i];
+    }
+    m_NodeBytes.erase(m_NodeBytes.begin() + first, m_NodeBytes.begin() + kept);
+    m_NodeBytes.insert(m_NodeBytes.begin() + first, nodeBytes.begin(), nodeBytes.end());
+    m_Cursor = m_Tokens.size() - 1;
+
+    // The replaced nodes are only freed with the whole arena. The new parse
+    // has the same diagnostics, which were printed already.
+    if (m_DeadBytes > s_MinDeadBytes && m_DeadBytes > m_Program->getBytesAllocated() - m_DeadBytes) {
+        m_Deferred = true;
+        reparseAll();
+        m_Deferred = false;
+        return false;
+    }
+    return true;
+}
+
+void Parser::reparseAll() {
+    m_Tokens = TokenStream::tokenize(m_Lexer);
+    m_Cursor = 0;
+    m_Program = std::make_unique<ASTProgramNode>();
+    m_NodeTokens.clear();
+    m_NodeBytes.clear();
+    m_DeadBytes = 0;
+    m_StructNames.clear();
+    m_HasDiagnostics = false;
+    m_ErrorCount = 0;
+    m_Diagnostics.clear();
+    m_Panicking = false;
+    parse();
+}
+
+std::unique_ptr<ASTProgramNode> Parser::getProgram() {
+    return std::move(m_Program);
+}
+
+// Statement parsers by token kind, anything that does not start with a
+// keyword, a type or a label is an expression.
+const std::array<Parser::StatementParser, Parser::s_TokenKinds> Parser::s_StatementParsers = []() {
+    std::array<StatementParser, s_TokenKinds> parsers;
+    parsers.fill(&Parser::parseAs<&Parser::parseExpr>);
+    parsers[-token::importlabel] = &Parser::parseAs<&Parser::parseImport>;
+    parsers[-token::exportlalbel] = &Parser::parseAs<&Parser::parseExport>;
+    parsers[-token::type] = &Parser::parseAs<&Parser::parseDeclaration>;
+    parsers[-token::bopen] = &Parser::parseAs<&Parser::parseBlock>;
+    parsers[-token::iflabel] = &Parser::parseAs<&Parser::parseIf>;
+    parsers[-token::forlabel] = &Parser::parseAs<&Parser::parseFor>;
+    parsers[-token::func] = &Parser::parseAs<&Parser::parseFunctionDefinition>;
+    parsers[-token::coldlabel] = &Parser::parseAs<&Parser::parseFunctionDefinition>;
+    parsers[-token::structlabel] = &Parser::parseAs<&Parser::parseStructDefintion>;
+    parsers[-token::returnlabel] = &Parser::parseAs<&Parser::parseReturn>;
+    parsers[-token::identifier] = &Parser::parseAs<&Parser::parseLabelStatement>;
+    return parsers;
+}();
+
+ASTNode *Parser::parseNext() {
+    return parseStatement(true);
+}
+
+ASTNode *Parser::parseNextBlock() {
+    return parseStatement(false);
+}
 
-    if (m_CurrentToken == token::func) {
-        return parseFunctionDefinition();
+ASTNode *Parser::parseStatement(bool topLevel) {
+    parseInfo("next");
+
+    // Empty statements, up to the end of the block or of the source.
+    while (peek() == token::semicolon) {
+        nextToken();
     }
+    if (peek() == token::eof || (!topLevel && peek() == token::bclose)) {
+        return nullptr;
+    }
+
+    const uint32_t offset = currentOffset();
+    const int kind = peek();
 
-    if (m_CurrentToken == token::structlabel) {
-        return parseStructDefintion();
+    if (topLevel && kind == token::bopen) {
+        if (canReport(true)) {
+            m_Logger.printError("A block must be inside a function");
+        }
     }
 
-    if (m_CurrentToken == token::returnlabel) {
-        return parseReturn();
+    StatementParser parser = kind < 0 && -kind < (int)s_TokenKinds ?
+        s_StatementParsers[-kind] : &Parser::parseAs<&Parser::parseExpr>;
+    ASTNode *node = (this->*parser)();
+
+    // A statement with a syntax error is left out. Its parser stopped at the
+    // error, unless it only lost a sub-expression and still reached its end.
+    if (m_Panicking) {
+        const int last = m_Tokens.getKind(m_Cursor - 1);
+        if (node == nullptr || (last != token::semicolon && last != token::bclose)) {
+            synchronize(topLevel);
+        }
+        m_Panicking = false;
+        return nullptr;
     }
 
-    if (m_CurrentToken == token::identifier) {
-        return parseLabel(m_CurrentToken.identifier);
+    return setLocation(node, offset);
+}
+
+// Skips to the end of the statement: its ';', or the '}' that closes a block
+// opened after the error, or the keyword that starts the next declaration.
+// Within a block it also stops before its '}' and before the keyword of any
+// statement. A '}' that closes nothing is only skipped at the top level.
+void Parser::synchronize(bool topLevel) {
+    size_t depth = 0;
+    while (peek() != token::eof) {
+        switch (peek()) {
+            case token::semicolon:
+                if (depth == 0) {
+                    nextToken();
+                    return;
+                }
+                break;
+            case token::bopen:
+                depth++;
+                break;
+            case token::bclose:
+                if (depth == 0) {
+                    if (topLevel) {
+                        nextToken();
+                    }
+                    return;
+                }
+                if (--depth == 0) {
+                    nextToken();
+                    return;
+                }
+                break;
+            case token::func:
+            case token::coldlabel:
+            case token::structlabel:
+            case token::exportlalbel:
+            case token::importlabel:
+                if (depth == 0) {
+                    return;
+                }
+                break;
+            case token::type:
+            case token::iflabel:
+            case token::forlabel:
+            case token::returnlabel:
+                if (depth == 0 && !topLevel) {
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+        nextToken();
     }
+}
 
-    return parseExpr();
+ASTNode *Parser::parseLabelStatement() {
+    return parseLabel(currentSymbol());
 }
-std::unique_ptr<ASTExprNode> Parser::parseExpr() {
-    std::unique_ptr<ASTExprNode> tmpExpr;
 
+// Operator precedence parsing with explicit stacks, so that neither long
+// chains of operators nor deeply nested parentheses recurse. Operators of a
+// same precedence are left associative.
+ASTExprNode *Parser::parseExpr() {
     parseInfo("expr");
 
-    if (m_CurrentToken == token::int_value) {
-        parseInfo("int literal");
-        tmpExpr = parseLiteral<int>();
-    }
+    // Nested expressions (e.g. call arguments) share the stacks, each one
+    // only touches what is above its base.
+    const size_t operandBase = m_Operands.size();
+    const size_t operatorBase = m_Operators.size();
+    size_t openParens = 0;
+
+    while (true) {
+        while (peek() == token::paropen) {
+            m_Operators.push_back({Operator::plus, true, currentOffset()});
+            openParens++;
+            nextToken();
+        }
 
-    if (m_CurrentToken == token::float_value) {
-        parseInfo("double literal");
-        tmpExpr = parseLiteral<double>();
+        const uint32_t offset = currentOffset();
+        ASTExprNode *primary = parsePrimary();
+        if (primary == nullptr) {
+            m_Operands.resize(operandBase);
+            m_Operators.resize(operatorBase);
+            return nullptr;
+        }
+        m_Operands.push_back({setLocation(primary, offset), offset});
+
+        while (true) {
+            while (openParens > 0 && peek() == token::parclose) {
+                while (!m_Operators.back().isParen) {
+                    reduceOperator();
+                }
+                // The parenthesized expression starts at its '('.
+                const uint32_t parenOffset = m_Operators.back().offset;
+                m_Operators.pop_back();
+                openParens--;
+                m_Operands.back().offset = parenOffset;
+                setLocation(m_Operands.back().node, parenOffset);
+                nextToken();
+            }
+            if (peek() != token::question) {
+                break;
+            }
+            if (!parseConditional(operatorBase)) {
+                m_Operands.resize(operandBase);
+                m_Operators.resize(operatorBase);
+                return nullptr;
+            }
+        }
+
+        Operator t_Operator;
+        if (!toBinaryOperator(peek(), t_Operator)) {
+            break;
+        }
+
+        const int precedence = getOpPrecedence(t_Operator);
+        while (m_Operators.size() > operatorBase && !m_Operators.back().isParen
+                && getOpPrecedence(m_Operators.back().op) <= precedence) {
+            reduceOperator();
+        }
+        m_Operators.push_back({t_Operator, false, 0});
+        nextToken();
     }
 
-    if (m_CurrentToken == token::truelabel || m_CurrentToken == token::falselabel) {
-        parseInfo("bool literal");
-        tmpExpr = parseLiteral<bool>();
+    if (openParens > 0) {
+        m_Operands.resize(operandBase);
+        m_Operators.resize(operatorBase);
+        return parseError<ASTExprNode>("Syntax Error: Expecting ')' instead of {}", currentToken());
     }
 
-    if (m_CurrentToken == token::dquote) {
-        parseInfo("string literal");
-        tmpExpr = parseLiteral<std::string>();
+    while (m_Operators.size() > operatorBase) {
+        reduceOperator();
     }
 
-    if (m_CurrentToken == token::paropen) {
-        tmpExpr = parseParenExpr();
+    const PendingOperand result = m_Operands.back();
+    m_Operands.pop_back();
+
+    if (peek() == token::fromto
+            || peek() == token::fromtol
+            || peek() == token::fromtominus
+            || peek() == token::fromoreto) {
+        return setLocation(parseRange(result.node), result.offset);
     }
 
+    return result.node;
+}
 
-    if (m_CurrentToken == token::identifier) {
-        // Handles Warn: has array member assignment until better parsing
-        // Identifier, NamespaceIdentifier, FunctionCall, MethodCall
-        tmpExpr = parseLabelExpr();
-    } else {
-        m_CurrentToken = m_Lexer.getNextToken();
+void Parser::reduceOperator() {
+    const Operator t_Operator = m_Operators.back().op;
+    m_Operators.pop_back();
+
+    const PendingOperand rhs = m_Operands.back();
+    m_Operands.pop_back();
+    const PendingOperand lhs = m_Operands.back();
+
+    m_Operands.back().node = setLocation(create<ASTBinaryNode>(lhs.node, t_Operator, rhs.node), lhs.offset);
+}
+
+bool Parser::parseConditional(size_t operatorBase) {
+    parseInfo("conditional");
+    while (m_Operators.size() > operatorBase && !m_Operators.back().isParen) {
+        reduceOperator();
     }
+    nextToken();
 
-    if (m_CurrentToken == token::plus
-            || m_CurrentToken == token::minus
-            || m_CurrentToken == token::times
-            || m_CurrentToken == token::divide
-            || m_CurrentToken == token::mod
-            || m_CurrentToken == token::lth
-            || m_CurrentToken == token::mth
-            || m_CurrentToken == token::orsym
-            || m_CurrentToken == token::andsym
-            || m_CurrentToken == token::eqcomp
-            || m_CurrentToken == token::leq
-            || m_CurrentToken == token::meq
-            || m_CurrentToken == token::neq) {
-        return parseBinary(std::move(tmpExpr));
+    ASTExprNode *then = parseExpr();
+    if (then == nullptr) {
+        return false;
+    }
+    if (peek() != token::colon) {
+        parseError<ASTExprNode>("Syntax Error: Expecting ':' instead of {}", currentToken());
+        return false;
+    }
+    nextToken();
+    ASTExprNode *t_Else = parseExpr();
+    if (t_Else == nullptr) {
+        return false;
     }
 
-    if (m_CurrentToken == token::fromto
-            || m_CurrentToken == token::fromtol
-            || m_CurrentToken == token::fromtominus
-            || m_CurrentToken == token::fromoreto) {
-        return parseRange(std::move(tmpExpr));
+    const PendingOperand cond = m_Operands.back();
+    m_Operands.back().node = setLocation(create<ASTConditionalNode>(cond.node, then, t_Else), cond.offset);
+    return true;
+}
+
+// Literals and labels, anything else cannot start an expression and is a
+// syntax error.
+ASTExprNode *Parser::parsePrimary() {
+    ASTExprNode *primary = nullptr;
+
+    switch (peek()) {
+        case token::int_value:
+            parseInfo("int literal");
+            primary = parseIntLiteral();
+            break;
+        case token::float_value:
+            parseInfo("double literal");
+            primary = parseLiteral<double>();
+            break;
+        case token::truelabel:
+        case token::falselabel:
+            parseInfo("bool literal");
+            primary = parseLiteral<bool>();
+            break;
+        case token::dquote:
+            parseInfo("string literal");
+            primary = parseLiteral<std::string_view>();
+            break;
+        case token::identifier:
+            // Identifier, NamespaceIdentifier, FunctionCall, MethodCall
+            return parseLabelExpr();
+        default:
+            break;
     }
 
-    return std::move(tmpExpr);
+    if (primary == nullptr) {
+        return parseError<ASTExprNode>("Syntax Error: Expecting an expression instead of {}", currentToken());
+    }
+    nextToken();
+    return primary;
 }
 
-std::unique_ptr<ASTImportNode> Parser::parseImport() {
+ASTImportNode *Parser::parseImport() {
     parseInfo("import");
-    m_CurrentToken = m_Lexer.getNextToken();
-    if (m_CurrentToken.token != token::identifier) {
+    nextToken();
+    if (peek() != token::identifier) {
         return std::move(parseError<ASTImportNode>(
                     "Syntax error: expected label instead of {}",
-                    tokenToString(m_CurrentToken.token)
+                    tokenToString(currentToken().token)
                     ));
     }
 
-    std::string module = m_CurrentToken.identifier;
+    Symbol module = currentSymbol();
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken.token == token::semicolon) {
-        return std::make_unique<ASTImportNode>(module);
+    if (peek() == token::semicolon) {
+        return create<ASTImportNode>(module);
     }
 
-    if (m_CurrentToken.token == token::access_sym) {
-        m_CurrentToken = m_Lexer.getNextToken();
-        if (m_CurrentToken != token::bopen) {
+    if (peek() == token::access_sym) {
+        nextToken();
+        if (peek() != token::bopen) {
             return std::move(parseError<ASTImportNode>(
                         "Syntax error: Expected '{' instead of {}",
-                        m_CurrentToken
+                        currentToken()
                         ));
         }
 
-        m_CurrentToken = m_Lexer.getNextToken();
+        nextToken();
 
-        if (m_CurrentToken != token::identifier) {
+        if (peek() != token::identifier) {
             return std::move(parseError<ASTImportNode>(
-                        "Syntax error: Expected a label instead of {}", m_CurrentToken));
+                        "Syntax error: Expected a label instead of {}", currentToken()));
         }
 
-        std::vector<std::string> subModules;
+        std::vector<Symbol> subModules;
 
-        subModules.push_back(m_CurrentToken.identifier);
+        subModules.push_back(currentSymbol());
 
-        m_CurrentToken = m_Lexer.getNextToken();
+        nextToken();
 
-        while (m_CurrentToken == token::comma) {
-            m_CurrentToken = m_Lexer.getNextToken();
+        while (peek() == token::comma) {
+            nextToken();
 
-            if (m_CurrentToken != token::identifier) {
+            if (peek() != token::identifier) {
                 return std::move(parseError<ASTImportNode>(
                             "Syntax error: Expected a label instead of {}",
-                            m_CurrentToken
+                            currentToken()
                             ));
             }
 
-            subModules.push_back(m_CurrentToken.identifier);
+            subModules.push_back(currentSymbol());
 
-            m_CurrentToken = m_Lexer.getNextToken();
+            nextToken();
         }
 
-        if (m_CurrentToken != token::bclose) {
+        if (peek() != token::bclose) {
             return std::move(parseError<ASTImportNode>(
                         "Syntax error: Expected '}' instead of {}",
-                        m_CurrentToken));
+                        currentToken()));
         }
 
-        m_CurrentToken = m_Lexer.getNextToken();
+        nextToken();
 
-        if (m_CurrentToken != token::semicolon) {
+        if (peek() != token::semicolon) {
             return std::move(parseError<ASTImportNode>(
                         "Syntax error: Expected ';' instead of {}",
-                        m_CurrentToken));
+                        currentToken()));
         }
 
-        return std::make_unique<ASTImportNode>(module, subModules);
+        return create<ASTImportNode>(module, createList(subModules));
     }
 
-    return parseError<ASTImportNode>("Syntax Error: Expecting '::' or ';' instead of {}", m_CurrentToken);
+    return parseError<ASTImportNode>("Syntax Error: Expecting '::' or ';' instead of {}", currentToken());
 }
 
-std::unique_ptr<ASTExportNode> Parser::parseExport() {
+ASTExportNode *Parser::parseExport() {
     parseInfo("export");
 
-    m_CurrentToken = m_Lexer.getNextToken(); // Eat 'export'
+    nextToken(); // Eat 'export'
 
-    if (m_CurrentToken == token::structlabel) {
-        std::unique_ptr<ASTStructDefinitionNode> exportStruct = parseStructDefintion();
+    if (peek() == token::structlabel) {
+        ASTStructDefinitionNode *exportStruct = parseStructDefintion();
         logParser("Parsed struct export");
-        return std::make_unique<ASTExportNode>(std::move(exportStruct));
+        return create<ASTExportNode>(exportStruct);
     }
 
-    if (m_CurrentToken == token::func) {
-        std::unique_ptr<ASTFunctionDefinitionNode> exportFunc = parseFunctionDefinition();
+    if (peek() == token::func || peek() == token::coldlabel) {
+        ASTFunctionDefinitionNode *exportFunc = parseFunctionDefinition();
         logParser("Parsed func export");
-        return std::make_unique<ASTExportNode>(std::move(exportFunc));
+        return create<ASTExportNode>(exportFunc);
     }
 
     return parseError<ASTExportNode>("Syntax error: 'export' expects a function or struct definition");
 }
 
-std::unique_ptr<ASTDeclarationNode> Parser::parseDeclaration() {
+ASTDeclarationNode *Parser::parseDeclaration() {
     parseInfo("declaration");
-    std::string type = m_CurrentToken.identifier;
+    const uint32_t offset = currentOffset();
+    std::string type(currentSpelling());
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::identifier) {
+    if (peek() != token::identifier) {
         return parseError<ASTDeclarationNode>(
-                "Syntax error: expecting a label instead of {}", m_CurrentToken);
+                "Syntax error: expecting a label instead of {}", currentToken());
     }
 
-    std::string name = m_CurrentToken.identifier;
+    Symbol name = currentSymbol();
     ASTNode::TYPE declarationType = ASTNode::stringToType(type);
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken == token::eq) {
-        return parseInitialization(name, declarationType);
+    if (peek() == token::eq) {
+        return setLocation(parseInitialization(name, declarationType), offset);
     }
 
-    if (m_CurrentToken == token::iopen) {
-        return parseArrayDefinition(declarationType, name);
+    if (peek() == token::iopen) {
+        return setLocation(parseArrayDefinition(declarationType, name), offset);
     }
 
-    if (m_CurrentToken != token::semicolon && m_CurrentToken != token::inlabel) {
+    if (peek() != token::semicolon && peek() != token::inlabel) {
         return parseError<ASTDeclarationNode>(
-                "Syntax error: Expecting ';' or 'in' after declaration instead of {}", m_CurrentToken);
+                "Syntax error: Expecting ';' or 'in' after declaration instead of {}", currentToken());
     }
 
-    return std::make_unique<ASTDeclarationNode>(name, declarationType);
+    return setLocation(create<ASTDeclarationNode>(name, declarationType), offset);
 }
 
-std::unique_ptr<ASTInitializationNode> Parser::parseInitialization(std::string name, ASTNode::TYPE type) {
+ASTInitializationNode *Parser::parseInitialization(Symbol name, ASTNode::TYPE type) {
     parseInfo("initialization");
-    m_CurrentToken = m_Lexer.getNextToken();
-    std::unique_ptr<ASTExprNode> expr = parseExpr();
+    nextToken();
+    ASTExprNode *expr = parseExpr();
 
-    if (m_CurrentToken != token::semicolon) {
-        return parseError<ASTInitializationNode>("Syntax Error: Expected ';' instead of {}", m_CurrentToken);
+    if (peek() != token::semicolon) {
+        return parseError<ASTInitializationNode>("Syntax Error: Expected ';' instead of {}", currentToken());
     }
 
-    return std::make_unique<ASTInitializationNode>(name, type, std::move(expr));
+    return create<ASTInitializationNode>(name, type, expr);
 }
 
-std::unique_ptr<ASTReturnNode> Parser::parseReturn() {
+ASTReturnNode *Parser::parseReturn() {
     parseInfo("return");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
     auto expr = parseExpr();
 
-    if (m_CurrentToken != token::semicolon) {
-        return parseError<ASTReturnNode>("Syntax Error: Expecting ';' instead of {}", m_CurrentToken);
+    if (peek() != token::semicolon) {
+        return parseError<ASTReturnNode>("Syntax Error: Expecting ';' instead of {}", currentToken());
     }
 
-    return std::make_unique<ASTReturnNode>(std::move(expr));
+    return create<ASTReturnNode>(expr);
 }
 
-std::unique_ptr<ASTBlockNode> Parser::parseBlock() {
+ASTBlockNode *Parser::parseBlock() {
     parseInfo("block");
-    std::vector<std::unique_ptr<ASTNode>> nodes;
+    const uint32_t offset = currentOffset();
+    std::vector<ASTNode*> nodes;
 
-    m_CurrentToken = m_Lexer.getNextToken(); // Eat '{'
-    while (m_CurrentToken != token::bclose) {
-        std::unique_ptr<ASTNode> node = parseNextBlock();
-        nodes.push_back(std::move(node));
+    nextToken(); // Eat '{'
+    while (peek() != token::bclose) {
+        if (peek() == token::eof) {
+            return parseError<ASTBlockNode>("Syntax Error: Expecting '}' instead of {}", currentToken());
+        }
 
-        if(m_CurrentToken == token::semicolon) {
-            m_CurrentToken = m_Lexer.getNextToken();
+        if (ASTNode *node = parseNextBlock()) {
+            nodes.push_back(node);
+        }
+
+        if(peek() == token::semicolon) {
+            nextToken();
         }
     }
 
-    m_CurrentToken = m_Lexer.getNextToken(); // Eat '}'
+    nextToken(); // Eat '}'
 
-    return std::make_unique<ASTBlockNode>(std::move(nodes));
+    return setLocation(create<ASTBlockNode>(createList(nodes)), offset);
 }
 
-std::unique_ptr<ASTIfNode> Parser::parseIf() {
+ASTIfNode *Parser::parseIf() {
     parseInfo("if");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    std::unique_ptr<ASTExprNode> condition = parseExpr();
+    BranchHint hint = BranchHint::none;
+    if (peek() == token::likelylabel || peek() == token::unlikelylabel) {
+        hint = peek() == token::likelylabel ? BranchHint::likely : BranchHint::unlikely;
+        nextToken();
+    }
 
-    if (m_CurrentToken != token::bopen) {
-        return parseError<ASTIfNode>("Expecting '{' instead of {}", m_CurrentToken);
+    ASTExprNode *condition = parseExpr();
+
+    if (peek() != token::bopen) {
+        return parseError<ASTIfNode>("Expecting '{' instead of {}", currentToken());
     }
 
-    std::unique_ptr<ASTBlockNode> ifBlock = parseBlock();
+    ASTBlockNode *ifBlock = parseBlock();
 
-    if (m_CurrentToken == token::elselabel) {
-        m_CurrentToken = m_Lexer.getNextToken();
-        if (m_CurrentToken != token::bopen) {
-            return parseError<ASTIfNode>("Expecting '{' instead of {}", m_CurrentToken);
+    if (peek() == token::elselabel) {
+        nextToken();
+        if (peek() != token::bopen) {
+            return parseError<ASTIfNode>("Expecting '{' instead of {}", currentToken());
         }
 
-        std::unique_ptr<ASTBlockNode> elseBlock = parseBlock();
+        ASTBlockNode *elseBlock = parseBlock();
 
-        return std::make_unique<ASTIfNode>(std::move(condition), std::move(ifBlock), std::move(elseBlock));
+        return create<ASTIfNode>(condition, ifBlock, elseBlock, hint);
     }
 
-    return std::make_unique<ASTIfNode>(std::move(condition), std::move(ifBlock), nullptr);
+    return create<ASTIfNode>(condition, ifBlock, nullptr, hint);
 }
 
-std::unique_ptr<ASTForNode> Parser::parseFor() {
+ASTForNode *Parser::parseFor() {
     parseInfo("for");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::paropen) {
-        return parseError<ASTForNode>("Syntax Error: Expecting '(' instead of {}", m_CurrentToken);
+    if (peek() != token::paropen) {
+        return parseError<ASTForNode>("Syntax Error: Expecting '(' instead of {}", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::type) {
+    if (peek() != token::type) {
         return parseError<ASTForNode>("Syntax Error: Expecting a declaration.");
     }
 
-    std::unique_ptr<ASTDeclarationNode> iterator = parseDeclaration();
+    ASTDeclarationNode *iterator = parseDeclaration();
 
-    if (m_CurrentToken != token::inlabel) {
-        return parseError<ASTForNode>("SYntax Error: Expecting 'in' instead of {}", m_CurrentToken);
+    if (peek() != token::inlabel) {
+        return parseError<ASTForNode>("SYntax Error: Expecting 'in' instead of {}", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::int_value && m_CurrentToken != token::float_value) {
-        return parseError<ASTForNode>("Syntax Error: Expecting a literal number instead of {}", m_CurrentToken);
+    if (peek() != token::int_value && peek() != token::float_value) {
+        return parseError<ASTForNode>("Syntax Error: Expecting a literal number instead of {}", currentToken());
     }
 
-    std::unique_ptr<ASTExprNode> expr;
-
-    if (m_CurrentToken == token::int_value) {
-        expr = parseLiteral<int>();
-    }
+    ASTExprNode *expr = nullptr;
 
-    if (m_CurrentToken == token::float_value) {
+    if (peek() == token::int_value) {
+        expr = parseIntLiteral();
+    } else if (peek() == token::float_value) {
         expr = parseLiteral<double>();
     }
 
-    m_CurrentToken = m_Lexer.getNextToken(); // Eat the literal value
+    nextToken(); // Eat the literal value
 
-    std::unique_ptr<ASTExprNode> cond = parseRange(std::move(expr));
+    ASTExprNode *cond = parseRange(expr);
 
-    if (m_CurrentToken != token::parclose) {
-        return parseError<ASTForNode>("Syntax Error: Expecting ')' instead of {}", m_CurrentToken);
+    if (peek() != token::parclose) {
+        return parseError<ASTForNode>("Syntax Error: Expecting ')' instead of {}", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::bopen) {
-        return parseError<ASTForNode>("Syntax Error: Expecting '{' insted of {}", m_CurrentToken);
+    if (peek() != token::bopen) {
+        return parseError<ASTForNode>("Syntax Error: Expecting '{' insted of {}", currentToken());
     }
 
-    std::unique_ptr<ASTBlockNode> block = parseBlock();
+    ASTBlockNode *block = parseBlock();
 
-    return std::make_unique<ASTForNode>(std::move(iterator), std::move(cond), std::move(block));
+    return create<ASTForNode>(iterator, cond, block);
 }
 
-std::unique_ptr<ASTFunctionDefinitionNode> Parser::parseFunctionDefinition() {
+ASTFunctionDefinitionNode *Parser::parseFunctionDefinition() {
     parseInfo("function definition");
-    m_CurrentToken = m_Lexer.getNextToken();
 
-    if (m_CurrentToken != token::identifier) {
-        return parseError<ASTFunctionDefinitionNode>("Syntax Error: Expecting a label instead of {}", m_CurrentToken);
+    const bool isCold = peek() == token::coldlabel;
+    if (isCold) {
+        nextToken();
+        if (peek() != token::func) {
+            return parseError<ASTFunctionDefinitionNode>("Syntax Error: Expecting 'func' after 'cold' instead of {}",
+                    currentToken());
+        }
+    }
+
+    nextToken();
+
+    if (peek() != token::identifier) {
+        return parseError<ASTFunctionDefinitionNode>("Syntax Error: Expecting a label instead of {}", currentToken());
     }
 
-    std::string name = m_CurrentToken.identifier;
+    Symbol name = currentSymbol();
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::paropen) {
-        return parseError<ASTFunctionDefinitionNode>("Syntax Error: Expecting '(' instead of {}", m_CurrentToken);
+    if (peek() != token::paropen) {
+        return parseError<ASTFunctionDefinitionNode>("Syntax Error: Expecting '(' instead of {}", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    std::vector<std::unique_ptr<ASTDeclarationNode>> args;
+    std::vector<ASTDeclarationNode*> args;
 
-    while (m_CurrentToken == token::type || m_CurrentToken == token::identifier) {
-        if (m_CurrentToken == token::type) {
-            ASTNode::TYPE type = ASTNode::stringToType(m_CurrentToken.identifier);
-            m_CurrentToken = m_Lexer.getNextToken();
-            if (m_CurrentToken != token::identifier) {
+    while (peek() == token::type || peek() == token::identifier) {
+        const uint32_t argOffset = currentOffset();
+        if (peek() == token::type) {
+            ASTNode::TYPE type = ASTNode::stringToType(currentSpelling());
+            nextToken();
+            if (peek() != token::identifier) {
                 return parseError<ASTFunctionDefinitionNode>(
                         "Syntax Error: Expecting a label instead of {}",
-                        m_CurrentToken
+                        currentToken()
                         );
             }
-            std::string argName = m_CurrentToken.identifier;
+            Symbol argName = currentSymbol();
 
-            m_CurrentToken = m_Lexer.getNextToken();
+            nextToken();
 
-            args.push_back(std::make_unique<ASTDeclarationNode>(argName, type));
+            args.push_back(setLocation(create<ASTDeclarationNode>(argName, type), argOffset));
 
-            if (m_CurrentToken == token::comma) {
-                m_CurrentToken = m_Lexer.getNextToken();
+            if (peek() == token::comma) {
+                nextToken();
             }
-        } else if (m_CurrentToken == token::identifier) {
-            if (m_StructNames.find(m_CurrentToken.identifier) == m_StructNames.end()) {
+        } else if (peek() == token::identifier) {
+            if (m_StructNames.find(currentSymbol()) == m_StructNames.end()) {
                 return parseError<ASTFunctionDefinitionNode>(
                         "Type Error: unknown struct: {}",
-                        m_CurrentToken.identifier
+                        currentSpelling()
                         );
             }
     
             ASTNode::TYPE type = ASTNode::STRUCT;
-            std::string structName = m_CurrentToken.identifier;
+            Symbol structName = currentSymbol();
 
-            m_CurrentToken = m_Lexer.getNextToken();
-            if (m_CurrentToken != token::identifier) {
+            nextToken();
+            if (peek() != token::identifier) {
                 return parseError<ASTFunctionDefinitionNode>(
                         "Syntax Error: Expecting a label instead of {}",
-                        m_CurrentToken
+                        currentToken()
                         );
             }
-            std::string argName = m_CurrentToken.identifier;
+            Symbol argName = currentSymbol();
 
-            m_CurrentToken = m_Lexer.getNextToken();
+            nextToken();
 
-            args.push_back(std::make_unique<ASTDeclarationNode>(argName, type, structName));
+            args.push_back(setLocation(create<ASTDeclarationNode>(argName, type, structName), argOffset));
 
-            if (m_CurrentToken == token::comma) {
-                m_CurrentToken = m_Lexer.getNextToken();
+            if (peek() == token::comma) {
+                nextToken();
             }
         }
     }
 
-    if (m_CurrentToken != token::parclose) {
-        return parseError<ASTFunctionDefinitionNode>("Syntax Error: Expecting ')' instead of {}", m_CurrentToken);
+    if (peek() != token::parclose) {
+        return parseError<ASTFunctionDefinitionNode>("Syntax Error: Expecting ')' instead of {}", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::arrow_op) {
-        return parseError<ASTFunctionDefinitionNode>("SyntaxError: Expecting '->' instead of {}", m_CurrentToken);
+    if (peek() != token::arrow_op) {
+        return parseError<ASTFunctionDefinitionNode>("SyntaxError: Expecting '->' instead of {}", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::type &&
-            m_StructNames.find(m_CurrentToken.identifier) == m_StructNames.end()) {
-        return parseError<ASTFunctionDefinitionNode>("Sybtax Error: Expecting a type instead of {}", m_CurrentToken);
+    if (peek() != token::type &&
+            m_StructNames.find(currentSymbol()) == m_StructNames.end()) {
+        return parseError<ASTFunctionDefinitionNode>("Sybtax Error: Expecting a type instead of {}", currentToken());
     }
 
-    ASTNode::TYPE returnType = ASTNode::stringToType(m_CurrentToken.identifier);
-    std::string returnStruct = "";
+    ASTNode::TYPE returnType = ASTNode::stringToType(currentSpelling());
+    Symbol returnStruct;
 
     if (returnType == ASTNode::TYPE::NONE) {
-        if (m_StructNames.find(m_CurrentToken.identifier) != m_StructNames.end()) {
+        if (m_StructNames.find(currentSymbol()) != m_StructNames.end()) {
             returnType = ASTNode::TYPE::STRUCT;
-            returnStruct = m_CurrentToken.identifier;
+            returnStruct = currentSymbol();
         }
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::bopen) {
-        return parseError<ASTFunctionDefinitionNode>("Syntax Error: Expecting '{' instead of {}", m_CurrentToken);
+    if (peek() != token::bopen) {
+        return parseError<ASTFunctionDefinitionNode>("Syntax Error: Expecting '{' instead of {}", currentToken());
     }
 
-    std::unique_ptr<ASTBlockNode> body = parseBlock();
+    ASTBlockNode *body = parseBlock();
 
-    return std::make_unique<ASTFunctionDefinitionNode>(name, std::move(args), returnType, std::move(body), returnStruct);
+    return create<ASTFunctionDefinitionNode>(name, createList(args), returnType, body, returnStruct, isCold);
 }
 
-std::unique_ptr<ASTStructDefinitionNode> Parser::parseStructDefintion() {
+ASTStructDefinitionNode *Parser::parseStructDefintion() {
     parseInfo("struct definition");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::identifier) {
-        return parseError<ASTStructDefinitionNode>("Sybtax Error: Expecting a label instead of {}", m_CurrentToken);
+    if (peek() != token::identifier) {
+        return parseError<ASTStructDefinitionNode>("Sybtax Error: Expecting a label instead of {}", currentToken());
     }
 
-    std::string name = m_CurrentToken.identifier;
+    Symbol name = currentSymbol();
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::bopen) {
-        return parseError<ASTStructDefinitionNode>("Syntax Error: Expecting '{' instead of {}", m_CurrentToken);
+    if (peek() != token::bopen) {
+        return parseError<ASTStructDefinitionNode>("Syntax Error: Expecting '{' instead of {}", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    std::vector<std::unique_ptr<ASTDeclarationNode>> attributes;
-    std::vector<std::unique_ptr<ASTFunctionDefinitionNode>> methods;
+    std::vector<ASTDeclarationNode*> attributes;
+    std::vector<ASTFunctionDefinitionNode*> methods;
 
-    while (m_CurrentToken == token::func || m_CurrentToken == token::type) {
-        if (m_CurrentToken == token::type) {
-            std::unique_ptr<ASTDeclarationNode> attribute = parseDeclaration();
-            attributes.push_back(std::move(attribute));
-            m_CurrentToken = m_Lexer.getNextToken();
+    while (peek() == token::func || peek() == token::coldlabel || peek() == token::type) {
+        if (peek() == token::type) {
+            ASTDeclarationNode *attribute = parseDeclaration();
+            attributes.push_back(attribute);
+            nextToken();
         } else {
-            std::unique_ptr<ASTFunctionDefinitionNode> method = parseFunctionDefinition();
-            methods.push_back(std::move(method));
+            ASTFunctionDefinitionNode *method = parseFunctionDefinition();
+            methods.push_back(method);
         }
 
     }
 
+    if (peek() != token::bclose) {
+        return parseError<ASTStructDefinitionNode>("Syntax Error: Expecting '}' instead of {}", currentToken());
+    }
+    nextToken();
+
     m_StructNames.insert(name);
 
-    return std::make_unique<ASTStructDefinitionNode>(name, std::move(attributes), std::move(methods));
+    return create<ASTStructDefinitionNode>(name, createList(attributes), createList(methods));
 }
 
-std::unique_ptr<ASTStructInitializationNode> Parser::parseStructInitialization(std::unique_ptr<ASTIdentifierNode> t_Struct) { parseInfo("struct initialization");
-    std::string name = m_CurrentToken.identifier;
+ASTStructInitializationNode *Parser::parseStructInitialization(ASTIdentifierNode *t_Struct) { parseInfo("struct initialization");
+    Symbol name = currentSymbol();
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::paropen) {
-        return parseError<ASTStructInitializationNode>("Syntax Error: Expecting '(' instead of {}", m_CurrentToken);
+    if (peek() != token::paropen) {
+        return parseError<ASTStructInitializationNode>("Syntax Error: Expecting '(' instead of {}", currentToken());
     }
 
-    std::vector<std::unique_ptr<ASTExprNode>> attributes;
+    std::vector<ASTExprNode*> attributes;
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    while(m_CurrentToken != token::parclose) {
+    while(peek() != token::parclose) {
         auto attribute = parseExpr();
-        attributes.push_back(std::move(attribute));
+        attributes.push_back(attribute);
 
-        if (m_CurrentToken == token::comma) {
-            m_CurrentToken = m_Lexer.getNextToken();
+        if (peek() != token::comma && peek() != token::parclose) {
+            return parseError<ASTStructInitializationNode>("Syntax Error: Expecting ',' or ')' instead of {}", currentToken());
+        }
+
+        if (peek() == token::comma) {
+            nextToken();
         }
     }
 
-    m_CurrentToken = m_Lexer.getNextToken(); // Eat ')'
+    nextToken(); // Eat ')'
 
-    if (m_CurrentToken != token::semicolon) {
-        return parseError<ASTStructInitializationNode>("Syntax Error: Expected ';' instead of {}", m_CurrentToken);
+    if (peek() != token::semicolon) {
+        return parseError<ASTStructInitializationNode>("Syntax Error: Expected ';' instead of {}", currentToken());
     }
 
-    return std::make_unique<ASTStructInitializationNode>(std::move(t_Struct), name, std::move(attributes));
+    return create<ASTStructInitializationNode>(t_Struct, name, createList(attributes));
 }
 
-std::unique_ptr<ASTStructAssignmentNode> Parser::parseStructAssignement(std::string name) {
+ASTStructAssignmentNode *Parser::parseStructAssignement(Symbol name) {
     parseInfo("struct assignement");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    std::vector<std::unique_ptr<ASTExprNode>> attributes;
+    std::vector<ASTExprNode*> attributes;
 
-    while (m_CurrentToken != token::bclose) {
+    while (peek() != token::bclose) {
         auto expr = parseExpr();
-        attributes.push_back(std::move(expr));
+        attributes.push_back(expr);
+
+        if (peek() != token::comma && peek() != token::bclose) {
+            return parseError<ASTStructAssignmentNode>("Syntax Error: Expecting ',' or '}' instead of {}", currentToken());
+        }
 
-        if (m_CurrentToken == token::comma)
-            m_CurrentToken = m_Lexer.getNextToken();
+        if (peek() == token::comma)
+            nextToken();
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::semicolon) {
-        return parseError<ASTStructAssignmentNode>("Syntax Error: Expecting ';' instead of {}", m_CurrentToken);
+    if (peek() != token::semicolon) {
+        return parseError<ASTStructAssignmentNode>("Syntax Error: Expecting ';' instead of {}", currentToken());
     }
 
-    return std::make_unique<ASTStructAssignmentNode>(name, std::move(attributes));
+    return create<ASTStructAssignmentNode>(name, createList(attributes));
 }
 
-std::unique_ptr<ASTAttributeAssignmentNode> Parser::parseAttributeAssignment(
-        std::string structName, std::string attributeName) {
+ASTAttributeAssignmentNode *Parser::parseAttributeAssignment(
+        Symbol structName, Symbol attributeName) {
     parseInfo("attribute assignement");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
     auto value = parseExpr();
 
-    return std::make_unique<ASTAttributeAssignmentNode>(structName, attributeName, std::move(value));
+    return create<ASTAttributeAssignmentNode>(structName, attributeName, value);
 }
 
-std::unique_ptr<ASTArrayDefinitionNode> Parser::parseArrayDefinition(ASTNode::TYPE type, std::string name) {
+ASTArrayDefinitionNode *Parser::parseArrayDefinition(ASTNode::TYPE type, Symbol name) {
     parseInfo("array definition");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::int_value) {
-        return parseError<ASTArrayDefinitionNode>("Syntax Error: Expected an int instead of {}", m_CurrentToken);
+    if (peek() != token::int_value) {
+        return parseError<ASTArrayDefinitionNode>("Syntax Error: Expected an int instead of {}", currentToken());
     }
 
-    const auto size = (size_t)std::stoi(m_CurrentToken.identifier);
+    const auto size = (size_t)m_Tokens.getIntValue(m_Cursor);
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::iclose) {
-        return parseError<ASTArrayDefinitionNode>("Syntax Error: Expecting ']' instead of {}", m_CurrentToken);
+    if (peek() != token::iclose) {
+        return parseError<ASTArrayDefinitionNode>("Syntax Error: Expecting ']' instead of {}", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken == token::eq) {
+    if (peek() == token::eq) {
         return parseArrayInitialization(type, name, size);
     }
 
-    if (m_CurrentToken != token::semicolon) {
-        return parseError<ASTArrayDefinitionNode>("Syntax Error: Expecting ';' instead of {}", m_CurrentToken);
+    if (peek() != token::semicolon) {
+        return parseError<ASTArrayDefinitionNode>("Syntax Error: Expecting ';' instead of {}", currentToken());
     }
 
-    return std::make_unique<ASTArrayDefinitionNode>(name, size, type);
+    return create<ASTArrayDefinitionNode>(name, size, type);
 }
 
-std::unique_ptr<ASTArrayInitializationNode> Parser::parseArrayInitialization(ASTNode::TYPE type, std::string name, size_t size) {
+ASTArrayInitializationNode *Parser::parseArrayInitialization(ASTNode::TYPE type, Symbol name, size_t size) {
     parseInfo("array initialization");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::iopen) {
-        return parseError<ASTArrayInitializationNode>("Syntax Error: Expecting '[' instead of {}", m_CurrentToken);
+    if (peek() != token::iopen) {
+        return parseError<ASTArrayInitializationNode>("Syntax Error: Expecting '[' instead of {}", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken(); // Eat '['
-    std::vector<std::unique_ptr<ASTExprNode>> values;
+    nextToken(); // Eat '['
+    std::vector<ASTExprNode*> values;
 
-    while(m_CurrentToken != token::iclose){
+    while(peek() != token::iclose){
         auto expr = parseExpr();
-        values.push_back(std::move(expr));
+        values.push_back(expr);
 
-        if (m_CurrentToken != token::comma && m_CurrentToken != token::iclose) {
-            return parseError<ASTArrayInitializationNode>("Syntax Error: Expecting ']' or ',' instead of {}", m_CurrentToken);
+        if (peek() != token::comma && peek() != token::iclose) {
+            return parseError<ASTArrayInitializationNode>("Syntax Error: Expecting ']' or ',' instead of {}", currentToken());
         }
         
-        if (m_CurrentToken == token::comma) {
-            m_CurrentToken = m_Lexer.getNextToken();
+        if (peek() == token::comma) {
+            nextToken();
         }
     }
 
-    m_CurrentToken = m_Lexer.getNextToken(); //Eat ']'
+    nextToken(); //Eat ']'
 
-    if (m_CurrentToken != token::semicolon) {
-        return parseError<ASTArrayInitializationNode>("Syntax Error: Expecting ';' instead of {}", m_CurrentToken);
+    if (peek() != token::semicolon) {
+        return parseError<ASTArrayInitializationNode>("Syntax Error: Expecting ';' instead of {}", currentToken());
     }
 
-    return std::make_unique<ASTArrayInitializationNode>(name, type, size, std::move(values));
+    return create<ASTArrayInitializationNode>(name, type, size, createList(values));
 }
 
-std::unique_ptr<ASTArrayAssignmentNode> Parser::parseArrayAssignment(std::string name) {
+ASTArrayAssignmentNode *Parser::parseArrayAssignment(Symbol name) {
     parseInfo("array assignement");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    std::vector<std::unique_ptr<ASTExprNode>> values;
+    std::vector<ASTExprNode*> values;
 
-    while (m_CurrentToken != token::iclose) {
+    while (peek() != token::iclose) {
         auto expr = parseExpr();
-        values.push_back(std::move(expr));
+        values.push_back(expr);
 
-        if (m_CurrentToken != token::comma && m_CurrentToken != token::iclose) {
-            return parseError<ASTArrayAssignmentNode>("Syntax Error: Expecting ',' or ']' instead of {}", m_CurrentToken);
+        if (peek() != token::comma && peek() != token::iclose) {
+            return parseError<ASTArrayAssignmentNode>("Syntax Error: Expecting ',' or ']' instead of {}", currentToken());
         }
 
-        if (m_CurrentToken == token::comma) {
-            m_CurrentToken = m_Lexer.getNextToken();
+        if (peek() == token::comma) {
+            nextToken();
         }
     }
 
-    m_CurrentToken = m_Lexer.getNextToken(); // eat ']'
+    nextToken(); // eat ']'
 
-    return std::make_unique<ASTArrayAssignmentNode>(name, std::move(values));
+    return create<ASTArrayAssignmentNode>(name, createList(values));
 }
 
-std::unique_ptr<ASTArrayMemeberAssignmentNode> Parser::parseArrayMemberAssignment(std::string name, size_t index) {
+ASTArrayMemeberAssignmentNode *Parser::parseArrayMemberAssignment(Symbol name, size_t index) {
     parseInfo("array member assignment");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
     auto expr = parseExpr();
 
-    return std::make_unique<ASTArrayMemeberAssignmentNode>(name, index, std::move(expr));
+    return create<ASTArrayMemeberAssignmentNode>(name, index, expr);
 }
 
-std::unique_ptr<ASTExprNode> Parser::parseLabelExpr() {
+ASTExprNode *Parser::parseLabelExpr() {
     parseInfo("label expr");
-    std::string identifier = m_CurrentToken.identifier;
+    Symbol identifier = currentSymbol();
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken == token::point) {
+    if (peek() == token::point) {
         return parseAttributeAccess(identifier);
     }
 
-    if (m_CurrentToken == token::access_sym) {
-        auto namespaceIdentifier = parseNamespaceIdentifier(std::move(identifier));
+    if (peek() == token::access_sym) {
+        auto namespaceIdentifier = parseNamespaceIdentifier(identifier);
 
-        if (m_CurrentToken == token::paropen) {
-            return parseFunctionCall(std::move(namespaceIdentifier));
+        if (peek() == token::paropen) {
+            return parseFunctionCall(namespaceIdentifier);
         }
 
-        return std::move(namespaceIdentifier);
+        return namespaceIdentifier;
     }
 
-    if (m_CurrentToken == token::paropen) {
-        auto identifierNode = std::make_unique<ASTIdentifierNode>(identifier);
-        return parseFunctionCall(std::move(identifierNode));
+    if (peek() == token::paropen) {
+        auto identifierNode = create<ASTIdentifierNode>(identifier);
+        return parseFunctionCall(identifierNode);
     }
 
-    if (m_CurrentToken == token::iopen) {
+    if (peek() == token::iopen) {
         return parseArrayAccess(identifier);
     }
 
-    return std::make_unique<ASTIdentifierNode>(identifier);
+    return create<ASTIdentifierNode>(identifier);
 }
 
-std::unique_ptr<ASTNode> Parser::parseLabel(std::string identifier) {
+ASTNode *Parser::parseLabel(Symbol identifier) {
     parseInfo("label node");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken == token::point) {
+    if (peek() == token::point) {
         return parseAttributeAccessNode(identifier);
     }
 
-    if (m_CurrentToken == token::access_sym) {
-        auto namespaceIdentifier = parseNamespaceIdentifier(std::move(identifier));
+    if (peek() == token::access_sym) {
+        auto namespaceIdentifier = parseNamespaceIdentifier(identifier);
 
-        if (m_CurrentToken == token::paropen) {
-            return parseFunctionCall(std::move(namespaceIdentifier));
+        if (peek() == token::paropen) {
+            return parseFunctionCall(namespaceIdentifier);
         }
 
-        if (m_CurrentToken == token::identifier) {
-            return parseStructInitialization(std::move(namespaceIdentifier));
+        if (peek() == token::identifier) {
+            return parseStructInitialization(namespaceIdentifier);
         }
 
-        return std::move(namespaceIdentifier);
+        return namespaceIdentifier;
     }
 
-    if (m_CurrentToken == token::paropen) {
-        auto identifierNode = std::make_unique<ASTIdentifierNode>(identifier);
-        return parseFunctionCall(std::move(identifierNode));
+    if (peek() == token::paropen) {
+        auto identifierNode = create<ASTIdentifierNode>(identifier);
+        return parseFunctionCall(identifierNode);
     }
 
-    if (m_CurrentToken == token::iopen) {
+    if (peek() == token::iopen) {
         return parseArrayAccessNode(identifier);
     }
 
-    if (m_CurrentToken == token::identifier) {
-        auto structIdentifier = std::make_unique<ASTIdentifierNode>(identifier);
-        return parseStructInitialization(std::move(structIdentifier));
+    if (peek() == token::identifier) {
+        auto structIdentifier = create<ASTIdentifierNode>(identifier);
+        return parseStructInitialization(structIdentifier);
     }
 
-    if (m_CurrentToken == token::eq) {
-        m_CurrentToken = m_Lexer.getNextToken();
-        if (m_CurrentToken == token::iopen) {
+    if (peek() == token::eq) {
+        nextToken();
+        if (peek() == token::iopen) {
             return parseArrayAssignment(identifier);
         }
 
-        if (m_CurrentToken == token::bopen) {
+        if (peek() == token::bopen) {
             return parseStructAssignement(identifier);
         }
 
         return parseAssignment(identifier);
     }
 
-    return std::make_unique<ASTIdentifierNode>(identifier);
-}
-
-std::unique_ptr<ASTBinaryNode> Parser::parseBinary(std::unique_ptr<ASTExprNode> lhs) {
-    parseInfo("binary");
-    Operator t_Operator;
-
-    switch (m_CurrentToken.token) {
-        case token::plus:
-            t_Operator = Operator::plus;
-            break;
-        case token::minus:
-            t_Operator = Operator::minus;
-            break;
-        case token::times:
-            t_Operator = Operator::times;
-            break;
-        case token::divide:
-            t_Operator = Operator::divide;
-            break;
-        case token::mod:
-            t_Operator = Operator::mod;
-            break;
-        case token::lth:
-            t_Operator = Operator::lth;
-            break;
-        case token::mth:
-            t_Operator = Operator::mth;
-            break;
-        case token::orsym:
-            t_Operator = Operator::orsym;
-            break;
-        case token::andsym:
-            t_Operator = Operator::andsym;
-            break;
-        case token::eqcomp:
-            t_Operator = Operator::eqcomp;
-            break;
-        case token::leq:
-            t_Operator = Operator::leq;
-            break;
-        case token::meq:
-            t_Operator = Operator::meq;
-            break;
-    }
-
-    m_CurrentToken = m_Lexer.getNextToken();
-
-    auto rhs = parseExpr();
-
-    if(auto bin = dynamic_cast<ASTBinaryNode*>(rhs.get())) {
-        if (getOpPrecedence(t_Operator) < getOpPrecedence(bin->m_Operator)) {
-            auto newLHS = std::make_unique<ASTBinaryNode>(std::move(lhs), t_Operator, std::move(bin->m_LeftOperrand));
-            return std::make_unique<ASTBinaryNode>(std::move(newLHS), bin->getOperator(), std::move(bin->m_RightOperrand));
-        }
-    }
-
-    return std::make_unique<ASTBinaryNode>(std::move(lhs), t_Operator, std::move(rhs));
+    return create<ASTIdentifierNode>(identifier);
 }
 
-std::unique_ptr<ASTNamespaceIdentifierNode> Parser::parseNamespaceIdentifier(std::string t_Namespace) {
+ASTNamespaceIdentifierNode *Parser::parseNamespaceIdentifier(Symbol t_Namespace) {
     parseInfo("namespace identifier");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::identifier) {
-        return parseError<ASTNamespaceIdentifierNode>("Syntax Error: Expecting a label instead of {}", m_CurrentToken);
+    if (peek() != token::identifier) {
+        return parseError<ASTNamespaceIdentifierNode>("Syntax Error: Expecting a label instead of {}", currentToken());
     }
 
-    std::string identifier = m_CurrentToken.identifier;
-    m_CurrentToken = m_Lexer.getNextToken();
+    Symbol identifier = currentSymbol();
+    nextToken();
 
     
-    return std::make_unique<ASTNamespaceIdentifierNode>(t_Namespace, identifier);
+    return create<ASTNamespaceIdentifierNode>(t_Namespace, identifier);
 }
 
-std::unique_ptr<ASTFunctionCallNode> Parser::parseFunctionCall(std::unique_ptr<ASTIdentifierNode> callee) {
+ASTFunctionCallNode *Parser::parseFunctionCall(ASTIdentifierNode *callee) {
     parseInfo("function call");
-    std::vector<std::unique_ptr<ASTExprNode>> args;
+    std::vector<ASTExprNode*> args;
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    while (m_CurrentToken != token::parclose) {
+    while (peek() != token::parclose) {
         auto arg = parseExpr();
-        args.push_back(std::move(arg));
+        if (arg == nullptr) {
+            return parseError<ASTFunctionCallNode>("Syntax Error: Expecting an expression instead of {}", currentToken());
+        }
+        args.push_back(arg);
 
-        if (m_CurrentToken != token::comma && m_CurrentToken != token::parclose) {
-            return parseError<ASTFunctionCallNode>("Syntax Error: Expecting ',' or ')' instead of {}", m_CurrentToken);
+        if (peek() != token::comma && peek() != token::parclose) {
+            return parseError<ASTFunctionCallNode>("Syntax Error: Expecting ',' or ')' instead of {}", currentToken());
         }
 
-        if (m_CurrentToken == token::comma)
-            m_CurrentToken = m_Lexer.getNextToken();
+        if (peek() == token::comma)
+            nextToken();
     }
 
-    m_CurrentToken = m_Lexer.getNextToken(); // Eat ')'
+    nextToken(); // Eat ')'
 
-    return std::make_unique<ASTFunctionCallNode>(std::move(callee), std::move(args));
+    return create<ASTFunctionCallNode>(callee, createList(args));
 }
 
-std::unique_ptr<ASTMethodCallNode> Parser::parseMethodCall(std::string structIdentifier, std::string methodIdentifier) {
+ASTMethodCallNode *Parser::parseMethodCall(Symbol structIdentifier, Symbol methodIdentifier) {
     parseInfo("method call");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    std::vector<std::unique_ptr<ASTExprNode>> args;
+    std::vector<ASTExprNode*> args;
 
-    while (m_CurrentToken != token::parclose) {
+    while (peek() != token::parclose) {
         auto arg = parseExpr();
-        args.push_back(std::move(arg));
+        if (arg == nullptr) {
+            return parseError<ASTMethodCallNode>("Syntax Error: Expecting an expression instead of {}", currentToken());
+        }
+        args.push_back(arg);
 
-        if (m_CurrentToken != token::comma && m_CurrentToken != token::parclose) {
-            return parseError<ASTMethodCallNode>("Syntax Error: Expecting ',' or ')' instead of {}", m_CurrentToken);
+        if (peek() != token::comma && peek() != token::parclose) {
+            return parseError<ASTMethodCallNode>("Syntax Error: Expecting ',' or ')' instead of {}", currentToken());
         }
 
-        if (m_CurrentToken == token::comma)
-            m_CurrentToken = m_Lexer.getNextToken();
+        if (peek() == token::comma)
+            nextToken();
     }
 
-    m_CurrentToken = m_Lexer.getNextToken(); // Eat ')'
+    nextToken(); // Eat ')'
 
-    return std::make_unique<ASTMethodCallNode>(structIdentifier, methodIdentifier, std::move(args));
+    return create<ASTMethodCallNode>(structIdentifier, methodIdentifier, createList(args));
 }
 
-std::unique_ptr<ASTAttributeAccessNode> Parser::parseAttributeAccess(std::string structIdentifier) {
+ASTAttributeAccessNode *Parser::parseAttributeAccess(Symbol structIdentifier) {
     parseInfo("attribute access");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::identifier) {
-        return parseError<ASTAttributeAccessNode>("Syntax Error: Expecting a label instead of {}", m_CurrentToken);
+    if (peek() != token::identifier) {
+        return parseError<ASTAttributeAccessNode>("Syntax Error: Expecting a label instead of {}", currentToken());
     }
 
-    std::string attribute = m_CurrentToken.identifier;
+    Symbol attribute = currentSymbol();
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken == token::paropen) {
+    if (peek() == token::paropen) {
         return parseMethodCall(structIdentifier, attribute);
     }
 
-    return std::make_unique<ASTAttributeAccessNode>(structIdentifier, attribute);
+    return create<ASTAttributeAccessNode>(structIdentifier, attribute);
 }
 
-std::unique_ptr<ASTRangeNode> Parser::parseRange(std::unique_ptr<ASTExprNode> expr) {
+ASTRangeNode *Parser::parseRange(ASTExprNode *expr) {
     parseInfo("range");
     RangeOperator t_Operator;
 
-    switch (m_CurrentToken.token) {
+    switch (peek()) {
         case token::fromto:
             t_Operator = RangeOperator::ft;
             break;
@@ -1029,111 +1542,107 @@ std::unique_ptr<ASTRangeNode> Parser::parseRange(std::unique_ptr<ASTExprNode> ex
             t_Operator = RangeOperator::fmt;
             break;
         default:
-            return parseError<ASTRangeNode>("Syntax Error: Expected a range operator instead of: {} ", m_CurrentToken);
+            return parseError<ASTRangeNode>("Syntax Error: Expected a range operator instead of: {} ", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
     auto stop = parseExpr();
 
-    return std::make_unique<ASTRangeNode>(std::move(expr), t_Operator, std::move(stop));
+    return create<ASTRangeNode>(expr, t_Operator, stop);
 }
 
-std::unique_ptr<ASTExprNode> Parser::parseArrayAccess(std::string name) {
+// Literals that do not fit in an int are typed long.
+ASTExprNode *Parser::parseIntLiteral() {
+    const int64_t value = m_Tokens.getIntValue(m_Cursor);
+    if (value < std::numeric_limits<int32_t>::min() || value > std::numeric_limits<int32_t>::max()) {
+        return parseLiteral<int64_t>();
+    }
+    return parseLiteral<int>();
+}
+
+ASTExprNode *Parser::parseArrayAccess(Symbol name) {
     parseInfo("array access");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::int_value) {
-        return parseError<ASTArrayAccessNode>("Syntax Error: Expecting an int instead of {}", m_CurrentToken);
+    if (peek() != token::int_value) {
+        return parseError<ASTArrayAccessNode>("Syntax Error: Expecting an int instead of {}", currentToken());
     }
 
-    auto index = (size_t)std::stoi(m_CurrentToken.identifier);
+    auto index = (size_t)m_Tokens.getIntValue(m_Cursor);
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::iclose) {
-        return parseError<ASTArrayAccessNode>("Syntax Error: Expecting ']' instead of {}", m_CurrentToken);
+    if (peek() != token::iclose) {
+        return parseError<ASTArrayAccessNode>("Syntax Error: Expecting ']' instead of {}", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken == token::eq) {
+    if (peek() == token::eq) {
         return parseError<ASTExprNode>("This should never happend (array access to assignement)");
     }
 
-    return std::make_unique<ASTArrayAccessNode>(name, index);
+    return create<ASTArrayAccessNode>(name, index);
 }
 
-std::unique_ptr<ASTNode> Parser::parseArrayAccessNode(std::string name) {
+ASTNode *Parser::parseArrayAccessNode(Symbol name) {
     parseInfo("array access node");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::int_value) {
-        return parseError<ASTArrayAccessNode>("Syntax Error: Expecting an int instead of {}", m_CurrentToken);
+    if (peek() != token::int_value) {
+        return parseError<ASTArrayAccessNode>("Syntax Error: Expecting an int instead of {}", currentToken());
     }
 
-    auto index = (size_t)std::stoi(m_CurrentToken.identifier);
+    auto index = (size_t)m_Tokens.getIntValue(m_Cursor);
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::iclose) {
-        return parseError<ASTArrayAccessNode>("Syntax Error: Expecting ']' instead of {}", m_CurrentToken);
+    if (peek() != token::iclose) {
+        return parseError<ASTArrayAccessNode>("Syntax Error: Expecting ']' instead of {}", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken == token::eq) {
+    if (peek() == token::eq) {
         return parseArrayMemberAssignment(name, index);
     }
 
-    return std::make_unique<ASTArrayAccessNode>(name, index);
+    return create<ASTArrayAccessNode>(name, index);
 }
 
-std::unique_ptr<ASTNode> Parser::parseAttributeAccessNode(std::string structIdentifier) {
+ASTNode *Parser::parseAttributeAccessNode(Symbol structIdentifier) {
     parseInfo("attribute access node");
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken != token::identifier) {
-        return parseError<ASTAttributeAccessNode>("Syntax Error: Expecting a label instead of {}", m_CurrentToken);
+    if (peek() != token::identifier) {
+        return parseError<ASTAttributeAccessNode>("Syntax Error: Expecting a label instead of {}", currentToken());
     }
 
-    std::string attribute = m_CurrentToken.identifier;
+    Symbol attribute = currentSymbol();
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    if (m_CurrentToken == token::paropen) {
+    if (peek() == token::paropen) {
         return parseMethodCall(structIdentifier, attribute);
     }
 
-    if (m_CurrentToken == token::eq) {
+    if (peek() == token::eq) {
         return parseAttributeAssignment(structIdentifier, attribute);
     }
 
-    return std::make_unique<ASTAttributeAccessNode>(structIdentifier, attribute);
-}
-
-std::unique_ptr<ASTExprNode> Parser::parseParenExpr() {
-    parseInfo("parn expr");
-    m_CurrentToken = m_Lexer.getNextToken();
-
-    auto expr = parseExpr();
-
-    if (m_CurrentToken != token::parclose) {
-        return parseError<ASTExprNode>("Syntax Error: Expecting ')' instead of {}", m_CurrentToken);
-    }
-
-    return std::move(expr);
+    return create<ASTAttributeAccessNode>(structIdentifier, attribute);
 }
 
-std::unique_ptr<ASTAssignmentNode> Parser::parseAssignment(std::string identifier) {
+ASTAssignmentNode *Parser::parseAssignment(Symbol identifier) {
     parseInfo("assignment");
     auto expr = parseExpr();
 
-    if (m_CurrentToken != token::semicolon) {
-        return parseError<ASTAssignmentNode>("Syntax Error: Expected ';' instead of {}", m_CurrentToken);
+    if (peek() != token::semicolon) {
+        return parseError<ASTAssignmentNode>("Syntax Error: Expected ';' instead of {}", currentToken());
     }
 
-    m_CurrentToken = m_Lexer.getNextToken();
+    nextToken();
 
-    return std::make_unique<ASTAssignmentNode>(identifier, std::move(expr));
+    return create<ASTAssignmentNode>(identifier, expr);
 }
@@ -0,0 +1,60 @@
+#include "Support/StringInterner.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+std::ostream& operator<<(std::ostream& os, Symbol symbol) {
+    os << symbol.str();
+    return os;
+}
+
+StringInterner::StringInterner() {
+    // Symbol 0 is the empty string, which is what a default Symbol refers to.
+    intern("");
+}
+
+StringInterner &StringInterner::get() {
+    static StringInterner interner;
+    return interner;
+}
+
+uint32_t StringInterner::store(std::string_view str) {
+    std::lock_guard<std::mutex> lock(m_StorageMutex);
+
+    const uint32_t id = m_Size.load(std::memory_order_relaxed);
+    // Readers index m_Blocks without a lock, so it cannot grow. Locks are
+    // held here, the interner must not be destroyed by exit().
+    if ((id >> BlockBits) >= MaxBlocks) {
+        fprintf(stderr, "Too many symbols, at most %zu distinct names are supported\nExiting!!\n",
+                MaxBlocks * BlockSize);
+        std::_Exit(EXIT_FAILURE);
+    }
+
+    auto &block = m_Blocks[id >> BlockBits];
+    if (block == nullptr) {
+        block = std::make_unique<std::string[]>(BlockSize);
+    }
+    block[id & (BlockSize - 1)] = str;
+
+    m_Size.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+Symbol StringInterner::intern(std::string_view str) {
+    // Same mixed hash as the one the tables compute, the low bits are used
+    // inside of a shard so the shard is picked with the high ones.
+    size_t hash = phmap::phmap_mix<sizeof(size_t)>()(phmap::Hash<std::string_view>()(str));
+    Shard &shard = m_Shards[(hash >> 56) % ShardCount];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.symbols.lazy_emplace_with_hash(str, hash, [&](const auto &ctor) {
+        uint32_t id = store(str);
+        ctor(std::string_view(getString(Symbol(id))), id);
+    });
+
+    return Symbol(it->second);
+}
@@ -14,6 +14,7 @@
  *******************************************************************************/
 
 #include <iostream>
+#include <string>
 #include <CppLogger2/CppLogger2.h>
 
 #include "YAPL.h"
@@ -31,14 +32,30 @@ int main(int argc, char *argv[]) {
 
     mainConsole.printTrace("YAPL v.{}", VERSION);
 
-    if (argc > 1) {
-        std::string filepath = argv[1];
-        IRGenerator generator(filepath);
-        generator.generate();
-    } else {
-       IRGenerator generator("");
-       generator.generate();
+    // --pipeline lexes on a separate thread while parsing, which also lets
+    // stdin be compiled as it is being written.
+    // --stream generates the IR of every top-level declaration as soon as it
+    // is parsed, instead of parsing the whole file first.
+    // --cache <dir> reuses the AST of a file that did not change since it was
+    // last compiled.
+    bool pipelined = false;
+    bool streaming = false;
+    std::string filepath;
+    std::string cacheDirectory;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--pipeline") {
+            pipelined = true;
+        } else if (std::string(argv[i]) == "--stream") {
+            streaming = true;
+        } else if (std::string(argv[i]) == "--cache" && i + 1 < argc) {
+            cacheDirectory = argv[++i];
+        } else {
+            filepath = argv[i];
+        }
     }
 
+    IRGenerator generator(filepath, pipelined, cacheDirectory);
+    generator.generate(streaming);
+
     return 0;
 }
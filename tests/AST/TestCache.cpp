@@ -0,0 +1,106 @@
+#include "catch2.hpp"
+#include "AST/ASTCache.hpp"
+#include "AST/ASTNode.hpp"
+#include "Lexer/SourceBuffer.hpp"
+#include "Parser/Parser.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Every kind of node the parser creates.
+static const char *s_Source = R"(
+import math::{sqrt, pow};
+export struct point {
+    int x;
+    double y = 2.5;
+    func norm() -> double {
+        return x * x + y * y;
+    }
+}
+long big = 9000000000;
+int values[3] = [1, 2, 3];
+bool flags[2];
+cold func fail(int code) -> int {
+    return code;
+}
+func f(int a, point p) -> int {
+    point q(a, 1.5);
+    q = {a, 0.5};
+    q.x = p.x;
+    values = [a, a, a];
+    values[1] = a % 2;
+    int b = a > 0 && fail(a) < 3 || a == -1 ? a : p.norm();
+    for (int i in 0 ..< 10) {
+        b = b + values[2];
+    }
+    if likely (b != 0) {
+        return b;
+    } else {
+        return math::sqrt(b);
+    }
+}
+)";
+
+static std::string image(const std::string &source, uint64_t key) {
+    Parser parser(SourceBuffer::fromString(source));
+    parser.parse();
+    REQUIRE(parser.getErrorCount() == 0);
+    return ASTCache::serialize(parser.getParsedProgram(), key);
+}
+
+static void setWord(std::string &image, size_t index, uint32_t word) {
+    std::memcpy(image.data() + index * sizeof(uint32_t), &word, sizeof(word));
+}
+
+TEST_CASE("Round-trips an AST through an image", "[ast][cache]") {
+    const uint64_t key = ASTCache::hashSource(s_Source);
+    const std::string written = image(s_Source, key);
+
+    auto program = ASTCache::deserialize(written, key);
+    REQUIRE(program != nullptr);
+    REQUIRE(ASTCache::serialize(*program, key) == written);
+
+    SECTION("with another key") {
+        REQUIRE(ASTCache::deserialize(written, key + 1) == nullptr);
+    }
+}
+
+TEST_CASE("A truncated image is a miss", "[ast][cache]") {
+    const std::string written = image(s_Source, 42);
+    for (size_t size = 0; size < written.size(); size++) {
+        REQUIRE(ASTCache::deserialize(std::string_view(written).substr(0, size), 42) == nullptr);
+    }
+}
+
+TEST_CASE("A corrupted image is a miss", "[ast][cache]") {
+    const std::string written = image(s_Source, 42);
+
+    SECTION("symbol longer than the image") {
+        std::string corrupted = written;
+        // After the 7 words of the header.
+        setWord(corrupted, 7, 0xFFFFFFFE);
+        REQUIRE(ASTCache::deserialize(corrupted, 42) == nullptr);
+    }
+
+    SECTION("more symbols than the image can hold") {
+        std::string corrupted = written;
+        setWord(corrupted, 4, 0xFFFFFFFF);
+        REQUIRE(ASTCache::deserialize(corrupted, 42) == nullptr);
+    }
+
+    SECTION("any word") {
+        // Not every change is detected, e.g. an offset, but none is read
+        // out of the image.
+        for (size_t i = 0; i < written.size() / sizeof(uint32_t); i++) {
+            for (uint32_t word : {0u, 1u, 0x7FFFFFFFu, 0xFFFFFFFFu}) {
+                std::string corrupted = written;
+                setWord(corrupted, i, word);
+                auto program = ASTCache::deserialize(corrupted, 42);
+                if (program != nullptr) {
+                    REQUIRE(ASTCache::deserialize(ASTCache::serialize(*program, 42), 42) != nullptr);
+                }
+            }
+        }
+    }
+}
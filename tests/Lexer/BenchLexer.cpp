@@ -0,0 +1,157 @@
+#include "catch2.hpp"
+#include "Lexer/Keywords.hpp"
+#include "Lexer/Lexer.hpp"
+#include "Lexer/Scanner.hpp"
+#include "Lexer/TokenStream.hpp"
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Run with `all_tests [benchmark]`, they are hidden from the default run.
+
+static std::string identifierHeavySource(size_t statements) {
+    static const char *names[] = {
+        "counter", "index", "result", "fooBar", "m_Value", "inner", "format",
+        "returnValue", "structure", "iffy", "elsewhere", "imported", "truth",
+    };
+    constexpr size_t nameCount = sizeof(names) / sizeof(names[0]);
+
+    std::string source;
+    for (size_t i = 0; i < statements; i++) {
+        source += "int ";
+        source += names[i % nameCount];
+        source += " = ";
+        source += names[(i + 3) % nameCount];
+        source += " + ";
+        source += names[(i + 7) % nameCount];
+        source += ";\n";
+        if (i % 8 == 0) {
+            source += "if ";
+            source += names[(i + 1) % nameCount];
+            source += " { return ";
+            source += names[(i + 5) % nameCount];
+            source += "; }\n";
+        }
+    }
+
+    return source;
+}
+
+static std::string commentHeavySource(size_t lines) {
+    std::string source;
+    for (size_t i = 0; i < lines; i++) {
+        source += "    int some_longer_identifier_name = 1234567;  // trailing comment on the line\n";
+        if (i % 4 == 0) {
+            source += "\n    /* block comment\n     * spanning a few lines\n     */\n";
+        }
+    }
+
+    return source;
+}
+
+// Chain of comparisons the lexer used before lookupKeyword, kept as the
+// reference point of the benchmark.
+static int lookupKeywordLinear(std::string_view str) {
+    if (str == "int") return token::type;
+    if (str == "float" || str == "double") return token::type;
+    if (str == "void") return token::type;
+    if (str == "bool") return token::type;
+    if (str == "long") return token::type;
+    if (str == "string") return token::type;
+    if (str == "struct") return token::structlabel;
+    if (str == "func") return token::func;
+    if (str == "for") return token::forlabel;
+    if (str == "while") return token::whilelabel;
+    if (str == "if") return token::iflabel;
+    if (str == "else") return token::elselabel;
+    if (str == "in") return token::inlabel;
+    if (str == "true") return token::truelabel;
+    if (str == "false") return token::falselabel;
+    if (str == "import") return token::importlabel;
+    if (str == "export") return token::exportlalbel;
+    if (str == "return") return token::returnlabel;
+    if (str == "likely") return token::likelylabel;
+    if (str == "unlikely") return token::unlikelylabel;
+    if (str == "cold") return token::coldlabel;
+    return token::identifier;
+}
+
+TEST_CASE("Keyword table matches the keywords", "[lexer][keywords]") {
+    for (std::string_view keyword : {"int", "float", "double", "void", "bool", "long", "string",
+            "struct", "func", "for", "while", "if", "else", "in", "true", "false",
+            "import", "export", "return", "likely", "unlikely", "cold", "counter", "iffy", "structure", "f", ""}) {
+        REQUIRE(lookupKeyword(keyword).token == lookupKeywordLinear(keyword));
+    }
+}
+
+TEST_CASE("Lexer throughput on identifiers", "[.][benchmark]") {
+    const std::string source = identifierHeavySource(20000);
+
+    std::vector<std::string_view> words;
+    {
+        auto lexer = Lexer::fromSource(source);
+        for (auto tok = lexer.getNextToken(); tok != token::eof; tok = lexer.getNextToken()) {
+            if (tok == token::identifier) {
+                words.push_back(tok.identifier);
+            }
+        }
+    }
+
+    BENCHMARK("keyword lookup, comparison chain") {
+        int sum = 0;
+        for (auto word : words) {
+            sum += lookupKeywordLinear(word);
+        }
+        return sum;
+    };
+
+    BENCHMARK("keyword lookup, length and first char switch") {
+        int sum = 0;
+        for (auto word : words) {
+            sum += lookupKeyword(word).token;
+        }
+        return sum;
+    };
+
+    BENCHMARK("tokenize whole source") {
+        auto lexer = Lexer::fromSource(source);
+        size_t count = 0;
+        while (lexer.getNextToken() != token::eof) {
+            count++;
+        }
+        return count;
+    };
+}
+
+TEST_CASE("Lexer throughput on whitespace and comments", "[.][benchmark]") {
+    const std::string source = commentHeavySource(100000);
+    WARN("scanning with " << scan::getImplementationName() << " kernels over "
+            << source.size() / (1024 * 1024) << " MiB");
+
+    BENCHMARK("tokenize comment heavy source") {
+        auto lexer = Lexer::fromSource(source);
+        size_t count = 0;
+        while (lexer.getNextToken() != token::eof) {
+            count++;
+        }
+        return count;
+    };
+}
+
+TEST_CASE("Lexer throughput with chunks lexed in parallel", "[.][benchmark]") {
+    const std::string source = identifierHeavySource(400000);
+    auto buffer = SourceBuffer::fromMemory(source);
+    const unsigned threads = std::thread::hardware_concurrency();
+    WARN(source.size() / (1024 * 1024) << " MiB on " << threads << " threads");
+
+    BENCHMARK("token stream, one thread") {
+        Lexer lexer(*buffer, 0, source.size());
+        return TokenStream(lexer).size();
+    };
+
+    BENCHMARK("token stream, all threads") {
+        return TokenStream(*buffer, threads).size();
+    };
+}
@@ -1,44 +1,34 @@
-#include <fstream>
-#include <stdio.h>
-
 #include "catch2.hpp"
 #include "Lexer/Lexer.hpp"
+#include "Lexer/TokenStream.hpp"
 
-void generateFile(std::string name, std::string content) {
-    std::ofstream file;
-    file.open(name);
-    file << content;
-    file.close();
-}
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
 
 TEST_CASE("Can lex identifier", "[lexer][identifier]") {
     SECTION("with lower case") {
-        generateFile("LowerCaseIdentifier.yapl", "lowercaseidentifier");
-        auto lexer = Lexer("LowerCaseIdentifier.yapl");
+        auto lexer = Lexer::fromSource("lowercaseidentifier");
         REQUIRE(lexer.getNextToken() == Token{token::identifier, "lowercaseidentifier"});
-        remove("LowerCaseIdentifier.yapl");
     }
 
     SECTION("with mixed case") {
-        generateFile("MixedCaseIdentifier.yapl", "MixedCaseIdentifier");
-        auto lexer = Lexer("MixedCaseIdentifier.yapl");
+        auto lexer = Lexer::fromSource("MixedCaseIdentifier");
         REQUIRE(lexer.getNextToken() == Token{token::identifier, "MixedCaseIdentifier"});
-        remove("MixedCaseIdentifier.yapl");
     }
 
     SECTION("with underscore") {
-        generateFile("UnderscoredIdentifier.yapl", "m_UnderscoredIdentifier");
-        auto lexer = Lexer("UnderscoredIdentifier.yapl");
+        auto lexer = Lexer::fromSource("m_UnderscoredIdentifier");
         REQUIRE(lexer.getNextToken() == (Token{token::identifier, "m_UnderscoredIdentifier"}));
-        remove("UnderscoredIdentifier.yapl");
     }
 
     SECTION("with numbers") {
-        generateFile("NumberedIdentifier.yapl", "m_Numbered0");
-        auto lexer = Lexer("NumberedIdentifier.yapl");
+        auto lexer = Lexer::fromSource("m_Numbered0");
         REQUIRE(lexer.getNextToken() == (Token{token::identifier, "m_Numbered0"}));
-        remove("NumberedIdentifier.yapl");
-
     }
 }
 
@@ -77,7 +67,27 @@ TEST_CASE("Can lex punctuation", "[lexer][punctuation]") {
 }
 
 TEST_CASE("Can lex operators", "[lexer][operators]") {
+    SECTION("logical operators") {
+        auto lexer = Lexer::fromSource("a & b && c | d || e");
+        REQUIRE(lexer.getNextToken() == Token{token::identifier, "a"});
+        REQUIRE(lexer.getNextToken() == Token{token::andsym, ""});
+        REQUIRE(lexer.getNextToken() == Token{token::identifier, "b"});
+        REQUIRE(lexer.getNextToken() == Token{token::andandsym, ""});
+        REQUIRE(lexer.getNextToken() == Token{token::identifier, "c"});
+        REQUIRE(lexer.getNextToken() == Token{token::orsym, ""});
+        REQUIRE(lexer.getNextToken() == Token{token::identifier, "d"});
+        REQUIRE(lexer.getNextToken() == Token{token::ororsym, ""});
+        REQUIRE(lexer.getNextToken() == Token{token::identifier, "e"});
+    }
 
+    SECTION("conditional operator") {
+        auto lexer = Lexer::fromSource("c ? a : b");
+        REQUIRE(lexer.getNextToken() == Token{token::identifier, "c"});
+        REQUIRE(lexer.getNextToken() == Token{token::question, ""});
+        REQUIRE(lexer.getNextToken() == Token{token::identifier, "a"});
+        REQUIRE(lexer.getNextToken() == Token{token::colon, ""});
+        REQUIRE(lexer.getNextToken() == Token{token::identifier, "b"});
+    }
 }
 
 TEST_CASE("Can lex literals", "[lexer][literals]") {
@@ -88,3 +98,188 @@ TEST_CASE("Can lex keywords", "[lexer][keywords]") {
 
 }
 
+
+TEST_CASE("Can lex an in-memory source", "[lexer][source]") {
+    SECTION("until end of file") {
+        auto lexer = Lexer::fromSource("int a = 4; // trailing comment");
+        REQUIRE(lexer.getNextToken() == Token{token::type, "int"});
+        REQUIRE(lexer.getNextToken() == Token{token::identifier, "a"});
+        REQUIRE(lexer.getNextToken() == Token{token::eq, ""});
+        REQUIRE(lexer.getNextToken() == Token{token::int_value, "4"});
+        REQUIRE(lexer.getNextToken() == Token{token::semicolon, ""});
+        REQUIRE(lexer.getNextToken() == Token{token::eof, ""});
+    }
+
+    SECTION("from a substring") {
+        std::string_view source = "func main";
+        auto lexer = Lexer::fromSource(source.substr(0, 4));
+        REQUIRE(lexer.getNextToken() == Token{token::func, ""});
+        REQUIRE(lexer.getNextToken() == Token{token::eof, ""});
+    }
+}
+
+TEST_CASE("Rejects sources too large for 32-bit offsets", "[lexer][source]") {
+    // Sparse, nothing is written but its last byte.
+    char path[] = "/tmp/yapl_large_XXXXXX";
+    const int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    const bool isSized = ftruncate(fd, (off_t)SourceBuffer::s_MaxSize + 1) == 0;
+    close(fd);
+
+    if (isSized) {
+        errno = 0;
+        REQUIRE(SourceBuffer::fromFile(path) == nullptr);
+        REQUIRE(errno == EFBIG);
+    }
+    unlink(path);
+}
+
+TEST_CASE("Identifiers are interned", "[lexer][symbols]") {
+    auto lexer = Lexer::fromSource("foo bar foo");
+    auto foo = lexer.getNextToken();
+    auto bar = lexer.getNextToken();
+    auto fooAgain = lexer.getNextToken();
+
+    REQUIRE(foo.symbol == fooAgain.symbol);
+    REQUIRE(foo.symbol != bar.symbol);
+    REQUIRE(foo.symbol.str() == "foo");
+    REQUIRE(StringInterner::get().intern("bar") == bar.symbol);
+}
+
+TEST_CASE("Locates tokens across whitespace and comments", "[lexer][location]") {
+    auto lexer = Lexer::fromSource("  first // line comment\n/* block\n comment */ second ;\n\n    third_identifier_longer_than_a_vector_register;");
+    auto &sourceManager = lexer.getSourceManager();
+
+    auto first = lexer.getNextToken();
+    REQUIRE(first == Token{token::identifier, "first"});
+    REQUIRE(first.offset == 2);
+    REQUIRE(sourceManager.getLocation(first.offset).line == 1);
+    REQUIRE(sourceManager.getLocation(first.offset).column == 3);
+
+    auto second = lexer.getNextToken();
+    REQUIRE(second == Token{token::identifier, "second"});
+    REQUIRE(sourceManager.getLocation(second.offset).line == 3);
+    REQUIRE(sourceManager.getLocation(second.offset).column == 13);
+    REQUIRE(lexer.getNextToken() == Token{token::semicolon, ""});
+
+    auto third = lexer.getNextToken();
+    REQUIRE(third == Token{token::identifier, "third_identifier_longer_than_a_vector_register"});
+    REQUIRE(sourceManager.getLocation(third.offset).line == 5);
+    REQUIRE(sourceManager.getLocation(third.offset).column == 5);
+    REQUIRE(lexer.getNextToken() == Token{token::semicolon, ""});
+}
+
+TEST_CASE("Parses numeric literals", "[lexer][literals]") {
+    auto lexer = Lexer::fromSource("42 -7 0x1F 0b101 -0x10 9000000000 0xFFFFFFFFFFFFFFFF .5 -2.25 0x");
+
+    auto tok = lexer.getNextToken();
+    REQUIRE(tok == token::int_value);
+    REQUIRE(tok.intValue == 42);
+    REQUIRE(lexer.getNextToken().intValue == -7);
+    REQUIRE(lexer.getNextToken().intValue == 0x1F);
+    REQUIRE(lexer.getNextToken().intValue == 5);
+    REQUIRE(lexer.getNextToken().intValue == -16);
+    REQUIRE(lexer.getNextToken().intValue == 9000000000);
+    REQUIRE(lexer.getNextToken().intValue == -1);
+
+    tok = lexer.getNextToken();
+    REQUIRE(tok == token::float_value);
+    REQUIRE(tok.floatValue == 0.5);
+    REQUIRE(lexer.getNextToken().floatValue == -2.25);
+
+    SECTION("a prefix without digits is a zero") {
+        REQUIRE(lexer.getNextToken().intValue == 0);
+        REQUIRE(lexer.getNextToken() == Token{token::identifier, "x"});
+    }
+}
+
+TEST_CASE("Can pre-tokenize a source", "[lexer][stream]") {
+    auto lexer = Lexer::fromSource("float x = 4.5; foo");
+    TokenStream tokens(lexer);
+
+    REQUIRE(tokens.size() == 7);
+    REQUIRE(tokens.getToken(0) == Token{token::type, "double"});
+    REQUIRE(tokens.getToken(1) == Token{token::identifier, "x"});
+    REQUIRE(tokens.getSymbol(1) == StringInterner::get().intern("x"));
+    REQUIRE(tokens.getKind(2) == token::eq);
+    REQUIRE(tokens.getToken(3) == Token{token::float_value, "4.5"});
+    REQUIRE(tokens.getFloatValue(3) == 4.5);
+    REQUIRE(tokens.getOffset(3) == 10);
+    REQUIRE(tokens.getOffset(5) == 15);
+
+    SECTION("reading past the end returns eof") {
+        REQUIRE(tokens.getKind(6) == token::eof);
+        REQUIRE(tokens.getKind(42) == token::eof);
+    }
+}
+
+TEST_CASE("Lexes chunks in parallel", "[lexer][stream]") {
+    std::string source;
+    for (int i = 0; i < 200; i++) {
+        source += "int value" + std::to_string(i) + " = " + std::to_string(i * 7) + "; // comment /* not a block\n";
+        source += "/* block comment\n   spanning // lines\n*/ double d = 0x" + std::to_string(i) + " / 2.5;\n";
+    }
+    auto buffer = SourceBuffer::fromString(source);
+
+    auto boundaries = Lexer::findChunkBoundaries(*buffer, 8);
+    REQUIRE(boundaries.size() == 9);
+    REQUIRE(boundaries.back() == source.size());
+    for (size_t i = 1; i + 1 < boundaries.size(); i++) {
+        REQUIRE(source[boundaries[i] - 1] == '\n');
+        REQUIRE(source.compare(boundaries[i], 3, "   ") != 0);
+        REQUIRE(source.compare(boundaries[i], 2, "*/") != 0);
+    }
+
+    Lexer lexer(*buffer, 0, source.size());
+    TokenStream sequential(lexer);
+    TokenStream parallel(*buffer, 8);
+
+    REQUIRE(parallel.size() == sequential.size());
+    for (size_t i = 0; i < sequential.size(); i++) {
+        REQUIRE(parallel.getKind(i) == sequential.getKind(i));
+        REQUIRE(parallel.getOffset(i) == sequential.getOffset(i));
+        REQUIRE(parallel.getSymbol(i) == sequential.getSymbol(i));
+        REQUIRE(parallel.getSpelling(i) == sequential.getSpelling(i));
+        REQUIRE(parallel.getIntValue(i) == sequential.getIntValue(i));
+        REQUIRE(parallel.getFloatValue(i) == sequential.getFloatValue(i));
+    }
+}
+
+TEST_CASE("Lexes a stream while it is written", "[lexer][stream]") {
+    std::string source;
+    for (int i = 0; i < 300; i++) {
+        source += "func f" + std::to_string(i) + "() -> int { /* a\n block */ return 0x" + std::to_string(i) + "; } // end\n";
+    }
+
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    // Small writes so that blocks end in the middle of tokens and comments.
+    std::thread writer([&]() {
+        for (size_t i = 0; i < source.size(); i += 37) {
+            if (write(fds[1], source.data() + i, std::min<size_t>(37, source.size() - i)) < 0) {
+                break;
+            }
+        }
+        close(fds[1]);
+    });
+
+    FILE *stream = fdopen(fds[0], "r");
+    Lexer lexer(SourceBuffer::forStream(stream));
+    TokenStream pipelined = TokenStream::pipeline(lexer);
+
+    auto reference = Lexer::fromSource(source);
+    TokenStream sequential(reference);
+
+    for (size_t i = 0; i < sequential.size(); i++) {
+        pipelined.require(i);
+        REQUIRE(pipelined.getKind(i) == sequential.getKind(i));
+        REQUIRE(pipelined.getOffset(i) == sequential.getOffset(i));
+        REQUIRE(pipelined.getSymbol(i) == sequential.getSymbol(i));
+        REQUIRE(pipelined.getIntValue(i) == sequential.getIntValue(i));
+    }
+    pipelined.require(sequential.size());
+    REQUIRE(pipelined.size() == sequential.size());
+
+    writer.join();
+    fclose(stream);
+}
@@ -0,0 +1,185 @@
+#include "catch2.hpp"
+#include "AST/ASTCache.hpp"
+#include "AST/ASTNode.hpp"
+#include "Lexer/SourceBuffer.hpp"
+#include "Parser/Parser.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+// Two ASTs are compared through their cache images, which hold every node
+// with its fields and offset.
+static std::string image(const ASTProgramNode &program) {
+    return ASTCache::serialize(program, 0);
+}
+
+// Parses one top-level node at a time, never in parallel. The program does
+// not own the nodes, they stay in the arena of the parser.
+static std::string parseSequentially(Parser &parser) {
+    ASTProgramNode program;
+    while (!parser.atEnd()) {
+        if (ASTNode *node = parser.parseNext()) {
+            program.addNode(node);
+        }
+    }
+    return image(program);
+}
+
+// Structs between the functions that use them, so that a range only parses
+// if it knows the structs declared in the ranges before it.
+static std::string largeSource(size_t count, size_t errorAt = SIZE_MAX) {
+    std::string source;
+    for (size_t i = 0; i < count; i++) {
+        const std::string id = std::to_string(i);
+        source += "struct s" + id + " {\n    int a;\n    int b;\n"
+            "    func sum() -> int {\n        return a + b;\n    }\n}\n";
+        source += "func f" + id + "(int x) -> int {\n";
+        source += i == errorAt ? "    int y = ;\n" : "    s" + id + " v(x, " + id + ");\n";
+        source += "    int y = v.sum() * 2 + x;\n"
+            "    if (y > 3) {\n        return y;\n    }\n    return x;\n}\n";
+    }
+    return source;
+}
+
+TEST_CASE("Parses large sources in parallel", "[parser][parallel]") {
+    const std::string source = largeSource(2000);
+
+    Parser reference(SourceBuffer::fromString(source));
+    const std::string expected = parseSequentially(reference);
+    REQUIRE(reference.getErrorCount() == 0);
+
+    SECTION("on explicit threads") {
+        Parser parser(SourceBuffer::fromString(source));
+        REQUIRE(parser.parseParallel(4));
+        REQUIRE(parser.atEnd());
+        REQUIRE(image(parser.getParsedProgram()) == expected);
+    }
+
+    SECTION("above the threshold") {
+        Parser parser(SourceBuffer::fromString(source));
+        parser.parse();
+        REQUIRE(parser.getErrorCount() == 0);
+        REQUIRE(image(parser.getParsedProgram()) == expected);
+    }
+}
+
+TEST_CASE("Falls back to a sequential parse on a syntax error", "[parser][parallel]") {
+    const std::string source = largeSource(2000, 1900);
+
+    Parser reference(SourceBuffer::fromString(source));
+    const std::string expected = parseSequentially(reference);
+    REQUIRE(reference.getErrorCount() == 1);
+
+    Parser parser(SourceBuffer::fromString(source));
+    REQUIRE_FALSE(parser.parseParallel(4));
+    REQUIRE(parser.getErrorCount() == 0);
+    REQUIRE(parser.getParsedProgram().size() == 0);
+
+    parser.parse();
+    REQUIRE(parser.getErrorCount() == 1);
+    REQUIRE(image(parser.getParsedProgram()) == expected);
+}
+
+// Applies an edit to a parse of `source`, which must give the same AST and
+// diagnostics as a parse of the edited source. Returns whether the edit
+// was reparsed incrementally.
+static bool checkEdit(const std::string &source, std::string_view at, size_t removed, const std::string &inserted) {
+    const size_t offset = source.find(at);
+    REQUIRE(offset != std::string::npos);
+
+    Parser parser(SourceBuffer::fromString(source));
+    parser.parse();
+    const bool incremental = parser.applyEdit(offset, removed, inserted);
+
+    std::string edited = source;
+    edited.replace(offset, removed, inserted);
+    Parser reference(SourceBuffer::fromString(edited));
+    reference.parse();
+
+    REQUIRE(image(parser.getParsedProgram()) == image(reference.getParsedProgram()));
+    REQUIRE(parser.getErrorCount() == reference.getErrorCount());
+    REQUIRE(parser.hasDiagnostics() == reference.hasDiagnostics());
+    return incremental;
+}
+
+TEST_CASE("Reparses edited sources", "[parser][edit]") {
+    const std::string source =
+        "struct point {\n    int x;\n    int y;\n}\n"
+        "func f(int a) -> int {\n    return a + 1;\n}\n"
+        "func g() -> int {\n    point p(1, 2);\n    return p.x;\n}\n"
+        "func main() -> int {\n    return f(2) + g();\n}\n";
+
+    SECTION("inside a node") {
+        REQUIRE(checkEdit(source, "1;", 1, "41"));
+        REQUIRE(checkEdit(source, "return p.x", 0, "int q = 3;\n    "));
+    }
+
+    SECTION("across node boundaries") {
+        REQUIRE(checkEdit(source, "    return a + 1;\n}\nfunc g", 38, ""));
+        REQUIRE(checkEdit(source, "}\nfunc main", 0, "}\nfunc h() -> int {\n    return 0;\n"));
+    }
+
+    SECTION("opening a comment") {
+        REQUIRE_FALSE(checkEdit(source, "func g", 0, "/* "));
+        checkEdit(source, "func g", 0, "// ");
+    }
+
+    SECTION("changing struct names") {
+        REQUIRE_FALSE(checkEdit(source, "point {", 5, "pair"));
+        checkEdit(source, "point p", 5, "pair");
+    }
+}
+
+TEST_CASE("Recounts the diagnostics of an edited source", "[parser][edit]") {
+    SECTION("when an error is fixed") {
+        const std::string source = "func f() -> int { int x = ; return 1; }";
+        Parser parser(SourceBuffer::fromString(source));
+        parser.parse();
+        REQUIRE(parser.getErrorCount() == 1);
+
+        REQUIRE(parser.applyEdit(source.find(';'), 0, "3"));
+        REQUIRE(parser.getErrorCount() == 0);
+        REQUIRE_FALSE(parser.hasDiagnostics());
+    }
+
+    SECTION("when an error is made") {
+        checkEdit("func f() -> int {\n    return 1;\n}\n", "1;", 1, "");
+    }
+
+    SECTION("when the errors are after the edit") {
+        const std::string source =
+            "func f() -> int {\n    return 1;\n}\n"
+            "func g() -> int {\n    int x = ;\n    return 2;\n}\n"
+            "func h() -> int {\n    return 3 * ;\n}\n";
+        REQUIRE(checkEdit(source, "1;", 1, "10 + 1"));
+        checkEdit(source, "func h", 0, "func i() -> int { int z = ; }\n");
+    }
+}
+
+TEST_CASE("Frees the nodes replaced by edits", "[parser][edit]") {
+    const std::string source =
+        "func f(int a) -> int {\n    int b = a * 2 + 1;\n    return b;\n}\n"
+        "func main() -> int {\n    return f(2);\n}\n";
+    const size_t offset = source.find("1;");
+
+    Parser parser(SourceBuffer::fromString(source));
+    parser.parse();
+    const size_t parsedBytes = parser.getParsedProgram().getBytesAllocated();
+
+    // Each edit replaces f, which would take megabytes if they were kept.
+    size_t maxBytes = 0;
+    for (size_t i = 0; i < 50000; i++) {
+        if (i % 2 == 0) {
+            parser.applyEdit(offset, 1, "41");
+        } else {
+            parser.applyEdit(offset, 2, "1");
+        }
+        maxBytes = std::max(maxBytes, parser.getParsedProgram().getBytesAllocated());
+    }
+    REQUIRE(maxBytes < parsedBytes + 2 * 1024 * 1024);
+
+    Parser reference(SourceBuffer::fromString(source));
+    reference.parse();
+    REQUIRE(image(parser.getParsedProgram()) == image(reference.getParsedProgram()));
+}